@@ -12,7 +12,12 @@ const LiftedActionID LiftedActionID::invalid_action_id = LiftedActionID(nullptr,
 
 
 LiftedActionID::LiftedActionID(const PartiallyGroundedAction* action, std::vector<object_id>&& binding)
-	: _action(action), _binding(std::move(binding)), _hash(0), _hashed(false)
+	: _action(action), _binding(binding.begin(), binding.end()), _hash(0), _hashed(false)
+{
+}
+
+LiftedActionID::LiftedActionID(const PartiallyGroundedAction* action, const object_id* first, const object_id* last)
+	: _action(action), _binding(first, last), _hash(0), _hashed(false)
 {
 }
 
@@ -73,7 +78,7 @@ std::ostream& PlainActionID::print(std::ostream& os) const {
 
 GroundAction* LiftedActionID::generate() const {
 	const ProblemInfo& info = ProblemInfo::getInstance();
-	return ActionGrounder::bind(*_action, Binding(_binding), info);
+	return ActionGrounder::bind(*_action, Binding(ValueTuple(_binding.begin(), _binding.end())), info);
 }
 
 const ActionData& LiftedActionID::getActionData() const {
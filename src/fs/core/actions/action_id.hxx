@@ -4,6 +4,8 @@
 #include <fs/core/fs_types.hxx>
 #include <fs/core/utils/binding.hxx>
 
+#include <boost/container/small_vector.hpp>
+
 namespace fs0::gecode { class CSPActionIterator; }
 
 namespace fs0 {
@@ -36,12 +38,18 @@ public:
 //! An action is fully identified by the ID of the action schema and the values of its parameters,
 //! i.e. its binding
 class LiftedActionID : public ActionID  {
+public:
+	//! Bindings of up to this many parameters, which cover most action schemas, are stored inline,
+	//! so that creating and copying lifted action IDs needs no memory allocation
+	static const unsigned INLINE_BINDING_SIZE = 4;
+	using BindingT = boost::container::small_vector<object_id, INLINE_BINDING_SIZE>;
+
 protected:
 	//! The id of the grounded action or action schema
 	const PartiallyGroundedAction* _action;
 	
 	//! The indexes of the action binding.
-	std::vector<object_id> _binding;
+	BindingT _binding;
 	
 	//! The hash code of the object
 	mutable std::size_t _hash;
@@ -58,6 +66,7 @@ public:
 	
 	//! Constructors
 	LiftedActionID(const PartiallyGroundedAction* action, std::vector<object_id>&& binding);
+	LiftedActionID(const PartiallyGroundedAction* action, const object_id* first, const object_id* last);
 	
 	//! Default copy constructors and assignment operators
 	LiftedActionID(const LiftedActionID& other) = default;
@@ -66,6 +75,14 @@ public:
 	LiftedActionID& operator=(LiftedActionID&& other) = default;
 	
 	bool operator==(const ActionID& rhs) const override;
+
+	//! Make this ID identify the grounding of the given schema with the given binding, reusing the current storage.
+	//! This allows action iterators to hand out all the actions they generate through one single object.
+	void assign(const PartiallyGroundedAction* action, const object_id* first, const object_id* last) {
+		_action = action;
+		_binding.assign(first, last);
+		_hashed = false;
+	}
 	
 	//! Hash-related operations
 	std::size_t generate_hash() const;
@@ -79,7 +96,7 @@ public:
     //! Prints a representation of the object to the given stream.
 	std::ostream& print(std::ostream& os) const override;
 
-    const std::vector<object_id>& get_binding() const { return _binding; }
+    const BindingT& get_binding() const { return _binding; }
 };
 
 //! A plain action ID is just the unsigned integer that identifies the action within the whole vector of grounded actions
@@ -4,21 +4,47 @@
 #include <fs/core/actions/action_id.hxx>
 #include <fs/core/constraints/gecode/v2/gecode_space.hxx>
 #include <fs/core/state.hxx>
+#include <fs/core/utils/thread_pool.hxx>
 
 
 namespace fs0::gecode {
 
+//! Compute into 'bindings' all solutions of the given schema CSP on the given state
+static void solve_schema_csp(const v2::ActionSchemaCSP& schema_csp, const State& state,
+                             const std::vector<Gecode::TupleSet>& symbol_extensions, std::vector<std::vector<object_id>>& bindings) {
+    v2::FSGecodeSpace* csp = schema_csp.instantiate(state, symbol_extensions);
+    if (!csp) return;
+
+    Gecode::Search::Options options;
+    options.clone = false;
+    CSPActionIterator::Iterator::engine_t engine(csp, options); // The engine takes ownership of the CSP
+    while (auto* solution = engine.next()) {
+        bindings.push_back(schema_csp.build_binding_from_solution(solution));
+        delete solution;
+    }
+}
+
 CSPActionIterator::CSPActionIterator(
         const State& state,
         const std::vector<v2::ActionSchemaCSP>& schema_csps,
         std::vector<Gecode::TupleSet>&& symbol_extensions,
-        const std::vector<const PartiallyGroundedAction*>& schemas) :
+        const std::vector<const PartiallyGroundedAction*>& schemas,
+        ThreadPool* pool) :
 
     schema_csps(schema_csps),
     schemas(schemas),
     _state(state),
-    symbol_extensions(std::move(symbol_extensions))
+    symbol_extensions(std::move(symbol_extensions)),
+    precomputed()
 {
+    if (!pool || schema_csps.size() < 2) return;
+
+    // Each worker writes only the slot of the schema it processes, and only uses the CSP of that schema, hence no
+    // synchronization is needed. Derived atoms of _state are computed under the lock of the axiom evaluator.
+    precomputed.resize(schema_csps.size());
+    pool->parallel_for(schema_csps.size(), [this](unsigned i) {
+        solve_schema_csp(this->schema_csps[i], _state, this->symbol_extensions, precomputed[i]);
+    });
 }
 
 CSPActionIterator::Iterator::Iterator(
@@ -26,6 +52,7 @@ CSPActionIterator::Iterator::Iterator(
         const std::vector<v2::ActionSchemaCSP>& schema_csps,
         const std::vector<const PartiallyGroundedAction*>& schemas,
         const std::vector<Gecode::TupleSet>& symbol_extensions,
+        const std::vector<BindingListT>* precomputed,
         unsigned currentIdx) :
 
     schema_csps(schema_csps),
@@ -35,25 +62,45 @@ CSPActionIterator::Iterator::Iterator(
     _current_handler_idx(currentIdx),
     _engine(nullptr),
     _csp(nullptr),
-    _action(nullptr),
-    symbol_extensions(symbol_extensions)
+    _action(LiftedActionID::invalid_action_id),
+    _binding(),
+    symbol_extensions(symbol_extensions),
+    precomputed(precomputed),
+    _current_binding_idx(0)
 {
     assert(schemas.size() == num_schema_csps);
     advance();
 }
 
 CSPActionIterator::Iterator::~Iterator() {
-    delete _action;
-    delete _engine;
-    delete _csp;
+    // Once the engine has been created, it owns the CSP
+    if (_engine) delete _engine;
+    else delete _csp;
 }
 
 void CSPActionIterator::Iterator::advance() {
+    if (precomputed) {
+        next_precomputed();
+        return;
+    }
+
     while (next_solution()) {
         return;
     }
 }
 
+bool CSPActionIterator::Iterator::next_precomputed() {
+    for (; _current_handler_idx < num_schema_csps; ++_current_handler_idx, _current_binding_idx = 0) {
+        const auto& bindings = (*precomputed)[_current_handler_idx];
+        if (_current_binding_idx < bindings.size()) {
+            const auto& binding = bindings[_current_binding_idx++];
+            _action.assign(schemas[_current_handler_idx], binding.data(), binding.data() + binding.size());
+            return true;
+        }
+    }
+    return false;
+}
+
 
 bool CSPActionIterator::Iterator::next_solution() {
     for (; _current_handler_idx < num_schema_csps; ++_current_handler_idx) {
@@ -66,28 +113,31 @@ bool CSPActionIterator::Iterator::next_solution() {
 
             // std::cout << std::endl << "After instantiation: "; handler.print(std::cout, *_csp); std::cout << std::endl;
 
-            if (!_csp || !_csp->propagate()) { // The CSP is not even locally consistent, thus let's move to the next handler
-                delete _csp; _csp = nullptr;
+            if (!_csp) { // The CSP is not even locally consistent, thus let's move to the next handler
                 continue;
             }
         }
 
         // We have a consistent CSP in '_csp'
         if (!_engine) {
-            _engine = new engine_t(_csp);
+            // The CSP is already a fresh clone of the prototype space of the schema, hence the engine can take
+            // ownership of it instead of cloning it once more
+            Gecode::Search::Options options;
+            options.clone = false;
+            _engine = new engine_t(_csp, options);
         }
 
         // We have an instantiated engine in '_engine'
         auto* solution = _engine->next();
         if (!solution) {
-            delete _csp; _csp = nullptr;
-            delete _engine; _engine = nullptr;
+            delete _engine; _engine = nullptr; // This also deletes the CSP
+            _csp = nullptr;
             continue; // The CSP is consistent but has no solution
         }
 
-        delete _action;
 //        _action = handler.get_lifted_action_id(solution);
-        _action = new LiftedActionID(schemas[_current_handler_idx], schema_csp.build_binding_from_solution(solution));
+        schema_csp.build_binding_from_solution(solution, _binding);
+        _action.assign(schemas[_current_handler_idx], _binding.data(), _binding.data() + _binding.size());
         delete solution;
         break;
     }
@@ -3,6 +3,8 @@
 
 #include <fs/core/constraints/gecode/v2/action_schema_csp.hxx>
 
+#include <fs/core/actions/action_id.hxx>
+
 #include <gecode/driver.hh>
 
 #include <memory>
@@ -10,7 +12,7 @@
 
 namespace fs0 {
     class State;
-    class LiftedActionID;
+    class ThreadPool;
 }
 
 namespace fs0::gecode::v2 {
@@ -36,12 +38,20 @@ protected:
 
     std::vector<Gecode::TupleSet> symbol_extensions;
 
+    using BindingListT = std::vector<std::vector<object_id>>;
+
+    //! The bindings of the applicable groundings of each schema, if they were computed upfront in parallel
+    std::vector<BindingListT> precomputed;
+
 public:
+    //! If a thread pool is given, the CSPs of the different schemas are solved upfront and concurrently,
+    //! each on its own Gecode space. The resulting bindings are anyway iterated in the order of the schemas.
     CSPActionIterator(
             const State& state,
             const std::vector<v2::ActionSchemaCSP>& schema_csps,
             std::vector<Gecode::TupleSet>&& symbol_extensions,
-            const std::vector<const PartiallyGroundedAction*>& schemas);
+            const std::vector<const PartiallyGroundedAction*>& schemas,
+            ThreadPool* pool = nullptr);
 
     class Iterator {
         friend class CSPActionIterator;
@@ -57,6 +67,7 @@ public:
                 const std::vector<v2::ActionSchemaCSP>& schema_csps,
                 const std::vector<const PartiallyGroundedAction*>& schemas,
                 const std::vector<Gecode::TupleSet>& symbol_extensions,
+                const std::vector<BindingListT>* precomputed,
                 unsigned currentIdx);
 
         const std::vector<v2::ActionSchemaCSP>& schema_csps;
@@ -71,14 +82,23 @@ public:
 
         v2::FSGecodeSpace* _csp;
 
-        LiftedActionID* _action;
+        //! The current action, which is overwritten in place on each advance to avoid allocations
+        LiftedActionID _action;
+
+        //! A buffer for the binding of the current solution
+        std::vector<object_id> _binding;
 
         const std::vector<Gecode::TupleSet>& symbol_extensions;
 
+        //! Null unless the bindings were computed upfront, in which case we just iterate through them
+        const std::vector<BindingListT>* precomputed;
+        unsigned _current_binding_idx;
+
         void advance();
 
         //! Returns true iff a new solution has actually been found
         bool next_solution();
+        bool next_precomputed();
 
     public:
         const Iterator& operator++() {
@@ -87,15 +107,15 @@ public:
         }
         const Iterator operator++(int) {Iterator tmp(*this); operator++(); return tmp;}
 
-        const LiftedActionID& operator*() const { return *_action; }
+        const LiftedActionID& operator*() const { return _action; }
 
         //! This is not really true... but will work for the purpose of comparing with the end iterator.
         bool operator==(const Iterator &other) const { return _current_handler_idx == other._current_handler_idx; }
         bool operator!=(const Iterator &other) const { return !(this->operator==(other)); }
     };
 
-    Iterator begin() const { return Iterator(_state, schema_csps, schemas, symbol_extensions, 0); }
-    Iterator end() const { return Iterator(_state, schema_csps, schemas, symbol_extensions, schema_csps.size()); }
+    Iterator begin() const { return Iterator(_state, schema_csps, schemas, symbol_extensions, precomputed.empty() ? nullptr : &precomputed, 0); }
+    Iterator end() const { return Iterator(_state, schema_csps, schemas, symbol_extensions, nullptr, schema_csps.size()); }
 };
 
 } // namespaces
@@ -1,4 +1,5 @@
 
+#include <limits>
 #include <unordered_set>
 
 #include <lapkt/tools/logging.hxx>
@@ -182,64 +183,70 @@ _loadGroundActionsIfAvailable(const ProblemInfo& info, const std::vector<const A
 	return grounded;
 }
 
-std::vector<const GroundAction*>
-_ground_all_elements(const std::vector<const ActionData*>& action_data, const ProblemInfo& info, bool bind_effects) {
-	std::vector<const GroundAction*> grounded;
-
-	unsigned total_num_bindings = 0;
+//! Ground the given schema with all parameter groundings that induce no false preconditions, appending the resulting
+//! ground actions to 'grounded', and return the next action ID. If the schema results in more than 'limit' ground
+//! actions, the grounding is aborted, the actions of the schema already appended are removed, and 'id' is returned.
+unsigned
+_ground_schema(unsigned id, const ActionData* data, const ProblemInfo& info, std::vector<const GroundAction*>& grounded, bool bind_effects,
+               unsigned long limit, unsigned long& total_num_bindings, bool& aborted) {
+	aborted = false;
+	unsigned grounded_0 = grounded.size();
+	const Signature& signature = data->getSignature();
+
+	// In case the action schema is directly not-lifted, we simply bind it with an empty binding and continue.
+	if (signature.empty()) {
+		LPT_DEBUG("cout", "Grounding schema '" << data->getName() << "' with no binding");
+		LPT_INFO("grounding", "Grounding the following schema with no binding:" << *data << "\n");
+		++total_num_bindings;
+		return _ground(id, data, Binding::EMPTY_BINDING, info, grounded, bind_effects);
+	}
 
-	unsigned id = 0;
-	for (const ActionData* data:action_data) {
-		unsigned grounded_0 = grounded.size();
-		const Signature& signature = data->getSignature();
-
-		// In case the action schema is directly not-lifted, we simply bind it with an empty binding and continue.
-		if (signature.empty()) {
-			LPT_DEBUG("cout", "Grounding schema '" << data->getName() << "' with no binding");
-			LPT_INFO("grounding", "Grounding the following schema with no binding:" << *data << "\n");
-			id = _ground(id, data, Binding::EMPTY_BINDING, info, grounded, bind_effects);
-			++total_num_bindings;
-			continue;
-		}
+	utils::binding_iterator binding_generator(signature, info);
+	if (binding_generator.ended()) {
+		LPT_DEBUG("cout", "Grounding of schema '" << data->getName() << "' yields no ground element, likely due to a parameter with empty type");
+		LPT_INFO("grounding", "Grounding of schema '" << data->getName() << "' yields no ground element, likely due to a parameter with empty type");
+		return id;
+	}
 
-		utils::binding_iterator binding_generator(signature, info);
-		if (binding_generator.ended()) {
-			LPT_DEBUG("cout", "Grounding of schema '" << data->getName() << "' yields no ground element, likely due to a parameter with empty type");
-			LPT_INFO("grounding", "Grounding of schema '" << data->getName() << "' yields no ground element, likely due to a parameter with empty type");
-			continue;
-		}
+	unsigned long num_bindings = binding_generator.num_bindings();
 
-		unsigned long num_bindings = binding_generator.num_bindings();
+	LPT_DEBUG("cout", "Grounding schema '" << print::action_data_name(*data) << "' with " << num_bindings << " possible bindings" << std::flush);
+	LPT_INFO("grounding", "Grounding the following schema with " << num_bindings << " possible bindings:" << print::action_data_name(*data));
 
-		LPT_DEBUG("cout", "Grounding schema '" << print::action_data_name(*data) << "' with " << num_bindings << " possible bindings" << std::flush);
-		LPT_INFO("grounding", "Grounding the following schema with " << num_bindings << " possible bindings:" << print::action_data_name(*data));
+	if (num_bindings == 0 || num_bindings > ActionGrounder::MAX_GROUND_ACTIONS) { // num_bindings == 0 would indicate there's been an overflow
+		//throw TooManyGroundActionsError(num_bindings);
+		LPT_INFO("grounding", "WARNING - The number of ground elements is too high: " << num_bindings);
+		LPT_DEBUG("cout", "WARNING - The number of ground elements is too high: " << num_bindings);
+	}
 
-		if (num_bindings == 0 || num_bindings > ActionGrounder::MAX_GROUND_ACTIONS) { // num_bindings == 0 would indicate there's been an overflow
-			//throw TooManyGroundActionsError(num_bindings);
-			LPT_INFO("grounding", "WARNING - The number of ground elements is too high: " << num_bindings);
-			LPT_DEBUG("cout", "WARNING - The number of ground elements is too high: " << num_bindings);
+	unsigned id_0 = id;
+	for (; !binding_generator.ended(); ++binding_generator) {
+		id = _ground(id, data, *binding_generator, info, grounded, bind_effects);
+		++total_num_bindings;
+
+		if (grounded.size() - grounded_0 > limit) {
+			for (unsigned i = grounded_0; i < grounded.size(); ++i) delete grounded[i];
+			grounded.resize(grounded_0);
+			aborted = true;
+			LPT_INFO("grounding", "Schema \"" << print::action_data_name(*data) << "\" results in more than " << limit << " grounded elements, grounding aborted");
+			return id_0;
 		}
+	}
+	LPT_INFO("grounding", "Schema \"" << print::action_data_name(*data) << "\" results in " << grounded.size() - grounded_0 << " grounded elements");
+	LPT_DEBUG("cout", "Schema \"" << print::action_data_name(*data) << "\" results in " << grounded.size() - grounded_0 << " grounded elements");
+	return id;
+}
 
-// 		float onepercent = ((float)num_bindings / 100);
-// 		int progress = 0;
-// 		unsigned i = 0;
-		for (; !binding_generator.ended(); ++binding_generator) {
-			id = _ground(id, data, *binding_generator, info, grounded, bind_effects);
-// 			++i;
-
-			// Print 5%, 10%, 15%, ... progress indicators
-			/*
-			 * NOTE This is too expensive for problems with many ground actions!
-			while (i / onepercent > progress) {
-				++progress;
-				if (progress % 5 == 0) std::cout << progress << "%, " << std::flush;
-			}
-			*/
-			++total_num_bindings;
-		}
-// 		std::cout << std::endl;
-		LPT_INFO("grounding", "Schema \"" << print::action_data_name(*data) << "\" results in " << grounded.size() - grounded_0 << " grounded elements");
-		LPT_DEBUG("cout", "Schema \"" << print::action_data_name(*data) << "\" results in " << grounded.size() - grounded_0 << " grounded elements");
+std::vector<const GroundAction*>
+_ground_all_elements(const std::vector<const ActionData*>& action_data, const ProblemInfo& info, bool bind_effects) {
+	std::vector<const GroundAction*> grounded;
+
+	unsigned long total_num_bindings = 0;
+	bool aborted = false;
+
+	unsigned id = 0;
+	for (const ActionData* data:action_data) {
+		id = _ground_schema(id, data, info, grounded, bind_effects, std::numeric_limits<unsigned long>::max(), total_num_bindings, aborted);
 	}
 
 	LPT_INFO("grounding", "Grounding stats:\n\t* " << grounded.size() << " grounded elements\n\t* " << total_num_bindings - grounded.size() << " pruned elements");
@@ -258,6 +265,22 @@ ActionGrounder::fully_ground(const std::vector<const ActionData*>& action_data,
 	return _ground_all_elements(action_data, info, true);
 }
 
+std::vector<const GroundAction*>
+ActionGrounder::ground_schemas(const std::vector<const ActionData*>& action_data, const ProblemInfo& info, unsigned long max_per_schema, std::vector<bool>& grounded_schemas) {
+	std::vector<const GroundAction*> grounded;
+	unsigned long total_num_bindings = 0;
+	grounded_schemas.assign(action_data.size(), false);
+
+	unsigned id = 0;
+	for (unsigned i = 0; i < action_data.size(); ++i) {
+		bool aborted = false;
+		id = _ground_schema(id, action_data[i], info, grounded, true, max_per_schema, total_num_bindings, aborted);
+		grounded_schemas[i] = !aborted;
+	}
+	LPT_INFO("grounding", "Grounding stats:\n\t* " << grounded.size() << " grounded elements");
+	return grounded;
+}
+
 
 std::vector<const PartiallyGroundedAction*>
 ActionGrounder::compile_action_parameters_away(const PartiallyGroundedAction* schema, unsigned effect_idx, const ProblemInfo& info) {
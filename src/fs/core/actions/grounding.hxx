@@ -39,6 +39,12 @@ public:
 	static std::vector<const PartiallyGroundedAction*> fully_lifted(const std::vector<const ActionData*>& action_data, const ProblemInfo& info);
 	
 	static std::vector<const GroundAction*> fully_ground(const std::vector<const ActionData*>& action_data, const ProblemInfo& info);
+
+	//! Ground only the given action schemas, i.e. without resorting to any groundings file, which must cover all schemas.
+	//! Schemas that result in more than 'max_per_schema' ground actions once statically inapplicable groundings are
+	//! pruned are left ungrounded; 'grounded_schemas[i]' tells whether the i-th given schema was grounded.
+	static std::vector<const GroundAction*> ground_schemas(const std::vector<const ActionData*>& action_data, const ProblemInfo& info,
+	                                                       unsigned long max_per_schema, std::vector<bool>& grounded_schemas);
 	
 	static const std::vector<const fs::ActionEffect*> compile_nested_fluents_away(const fs::ActionEffect* effect, const ProblemInfo& info);
 	
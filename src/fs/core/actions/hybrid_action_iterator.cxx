@@ -0,0 +1,44 @@
+
+#include "hybrid_action_iterator.hxx"
+
+#include <fs/core/actions/actions.hxx>
+#include <fs/core/state.hxx>
+
+
+namespace fs0 {
+
+HybridActionIterator::HybridActionIterator(
+        GroundApplicableSet&& ground,
+        JoinActionIterator&& lifted,
+        const std::vector<const GroundAction*>& ground_actions,
+        const std::vector<const PartiallyGroundedAction*>& schemas) :
+
+    _ground(std::move(ground)),
+    _lifted(std::move(lifted)),
+    _ground_actions(ground_actions),
+    _schemas(schemas)
+{}
+
+HybridActionIterator::Iterator::Iterator(const HybridActionIterator& actions, bool end) :
+    _actions(actions),
+    _ground_it(end ? actions._ground.end() : actions._ground.begin()),
+    _ground_end(actions._ground.end()),
+    _lifted_it(),
+    _ground_action(LiftedActionID::invalid_action_id)
+{
+    if (!end) update();
+}
+
+void HybridActionIterator::Iterator::update() {
+    if (!on_ground()) {
+        // Lifted actions are directly returned by the lifted iterator, which we create the first time it is needed
+        if (!_lifted_it) _lifted_it.emplace(_actions._lifted.begin());
+        return;
+    }
+
+    const GroundAction& action = *_actions._ground_actions[*_ground_it];
+    const auto& values = action.getBinding().get_full_binding();
+    _ground_action.assign(_actions._schemas[action.getActionData().getId()], values.data(), values.data() + values.size());
+}
+
+} // namespaces
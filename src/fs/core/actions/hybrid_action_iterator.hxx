@@ -0,0 +1,89 @@
+
+#pragma once
+
+#include <fs/core/actions/action_id.hxx>
+#include <fs/core/actions/join_action_iterator.hxx>
+#include <fs/core/applicability/action_managers.hxx>
+
+#include <optional>
+#include <utility>
+#include <vector>
+
+
+namespace fs0 {
+
+class GroundAction;
+class PartiallyGroundedAction;
+class State;
+
+//! An iterator over the applicable actions in a state when some action schemas are grounded and the rest are
+//! handled lifted. The applicable ground actions, as given by an action manager, are returned first, and then
+//! the applicable groundings of the lifted schemas, as given by a JoinSuccessorGenerator. All of them are
+//! returned as lifted action IDs, so that both kinds of actions are handled uniformly by the search.
+class HybridActionIterator {
+protected:
+    //! The iterator type of the ground applicable set, which is not publicly named
+    using GroundIteratorT = decltype(std::declval<const GroundApplicableSet&>().begin());
+
+    GroundApplicableSet _ground;
+
+    JoinActionIterator _lifted;
+
+    const std::vector<const GroundAction*>& _ground_actions;
+
+    //! The lifted action schemas, indexed by their ID
+    const std::vector<const PartiallyGroundedAction*>& _schemas;
+
+public:
+    HybridActionIterator(GroundApplicableSet&& ground, JoinActionIterator&& lifted,
+                         const std::vector<const GroundAction*>& ground_actions,
+                         const std::vector<const PartiallyGroundedAction*>& schemas);
+
+    class Iterator {
+        friend class HybridActionIterator;
+
+    public:
+        ~Iterator() = default;
+
+    protected:
+        Iterator(const HybridActionIterator& actions, bool end);
+
+        const HybridActionIterator& _actions;
+
+        GroundIteratorT _ground_it;
+        const GroundIteratorT _ground_end;
+
+        //! The lifted iterator is only created once the ground actions are over, since creating it already
+        //! computes the applicable bindings of the first lifted schema. It is never created for the end iterator.
+        std::optional<JoinActionIterator::Iterator> _lifted_it;
+
+        //! The current ground action, which is overwritten in place on each advance to avoid allocations
+        LiftedActionID _ground_action;
+
+        bool on_ground() const { return _ground_it != _ground_end; }
+
+        bool finished() const { return !on_ground() && (!_lifted_it || _lifted_it->finished()); }
+
+        //! Update the current ground action, if any
+        void update();
+
+    public:
+        const Iterator& operator++() {
+            if (on_ground()) ++_ground_it;
+            else ++(*_lifted_it);
+            update();
+            return *this;
+        }
+
+        const LiftedActionID& operator*() const { return on_ground() ? _ground_action : **_lifted_it; }
+
+        //! This is not really true... but will work for the purpose of comparing with the end iterator.
+        bool operator==(const Iterator &other) const { return finished() == other.finished() && _ground_it == other._ground_it; }
+        bool operator!=(const Iterator &other) const { return !(this->operator==(other)); }
+    };
+
+    Iterator begin() const { return Iterator(*this, false); }
+    Iterator end() const { return Iterator(*this, true); }
+};
+
+} // namespaces
@@ -0,0 +1,49 @@
+
+#include "join_action_iterator.hxx"
+
+#include <fs/core/actions/action_id.hxx>
+#include <fs/core/state.hxx>
+
+
+namespace fs0 {
+
+JoinActionIterator::JoinActionIterator(const State& state, const JoinSuccessorGenerator& generator) :
+    _state(state),
+    _generator(generator)
+{}
+
+JoinActionIterator::Iterator::Iterator(const State& state, const JoinSuccessorGenerator& generator, unsigned currentIdx) :
+    _state(state),
+    _generator(generator),
+    _relations(generator, state),
+    _current_schema_idx(currentIdx),
+    _current_bindings_computed(false),
+    _current_bindings(),
+    _current_binding_idx(0),
+    _action(LiftedActionID::invalid_action_id)
+{
+    advance();
+}
+
+JoinActionIterator::Iterator::~Iterator() = default;
+
+void JoinActionIterator::Iterator::advance() {
+    for (; _current_schema_idx < _generator.num_schemas(); ++_current_schema_idx) {
+        if (!_current_bindings_computed) {
+            _generator.compute_bindings(_current_schema_idx, _state, _relations, _current_bindings);
+            _current_bindings_computed = true;
+            _current_binding_idx = 0;
+        }
+
+        if (_current_binding_idx < _current_bindings.size()) {
+            const auto& binding = _current_bindings[_current_binding_idx++];
+            _action.assign(_generator.schema(_current_schema_idx), binding.data(), binding.data() + binding.size());
+            return;
+        }
+
+        // At this point we have explored all applicable groundings of the current schema
+        _current_bindings_computed = false;
+    }
+}
+
+} // namespaces
@@ -0,0 +1,75 @@
+
+#pragma once
+
+#include <fs/core/actions/action_id.hxx>
+#include <fs/core/actions/join_successor_generator.hxx>
+
+#include <vector>
+
+
+namespace fs0 {
+
+class State;
+
+//! An iterator over the applicable lifted actions in a state, as computed by a JoinSuccessorGenerator.
+//! The bindings of each action schema are computed only once the iteration reaches it, so that iterations
+//! that stop early do not pay for the schemas that come after.
+class JoinActionIterator {
+protected:
+    const State& _state;
+
+    const JoinSuccessorGenerator& _generator;
+
+public:
+    JoinActionIterator(const State& state, const JoinSuccessorGenerator& generator);
+
+    class Iterator {
+        friend class JoinActionIterator;
+
+    public:
+        ~Iterator();
+        Iterator(Iterator&&) = default;
+
+        //! Whether all applicable actions have already been iterated
+        bool finished() const { return _current_schema_idx >= _generator.num_schemas(); }
+
+    protected:
+        Iterator(const State& state, const JoinSuccessorGenerator& generator, unsigned currentIdx);
+
+        const State& _state;
+
+        const JoinSuccessorGenerator& _generator;
+
+        //! The extensions of the symbols in the state, shared by all schemas
+        JoinSuccessorGenerator::StateRelations _relations;
+
+        unsigned _current_schema_idx;
+
+        bool _current_bindings_computed;
+
+        JoinSuccessorGenerator::BindingListT _current_bindings;
+        unsigned _current_binding_idx;
+
+        //! The current action, which is overwritten in place on each advance to avoid allocations
+        LiftedActionID _action;
+
+        void advance();
+
+    public:
+        const Iterator& operator++() {
+            advance();
+            return *this;
+        }
+
+        const LiftedActionID& operator*() const { return _action; }
+
+        //! This is not really true... but will work for the purpose of comparing with the end iterator.
+        bool operator==(const Iterator &other) const { return _current_schema_idx == other._current_schema_idx; }
+        bool operator!=(const Iterator &other) const { return !(this->operator==(other)); }
+    };
+
+    Iterator begin() const { return Iterator(_state, _generator, 0); }
+    Iterator end() const { return Iterator(_state, _generator, _generator.num_schemas()); }
+};
+
+} // namespaces
@@ -0,0 +1,347 @@
+
+#include "join_successor_generator.hxx"
+
+#include <fs/core/actions/actions.hxx>
+#include <fs/core/problem_info.hxx>
+#include <fs/core/state.hxx>
+#include <fs/core/utils/binding_iterator.hxx>
+
+#include <lapkt/tools/logging.hxx>
+
+#include <algorithm>
+#include <unordered_map>
+
+
+namespace fs0 {
+
+JoinSuccessorGenerator::StateRelations::StateRelations(const JoinSuccessorGenerator& generator, const State& state) :
+    generator_(generator),
+    state_(state),
+    rows_(generator.symbols_.size()),
+    computed_(generator.symbols_.size(), false)
+{}
+
+const std::vector<object_id>& JoinSuccessorGenerator::StateRelations::fluent_rows(unsigned symbol) {
+    if (!computed_[symbol]) {
+        generator_.compute_fluent_rows(symbol, state_, rows_[symbol]);
+        computed_[symbol] = true;
+    }
+    return rows_[symbol];
+}
+
+
+JoinSuccessorGenerator::JoinSuccessorGenerator(
+        const std::vector<const PartiallyGroundedAction*>& schemas,
+        const std::vector<SimpleLiftedOperator>& operators,
+        const ProblemInfo& info) :
+
+    info_(info),
+    symbols_(info.getNumLogicalSymbols()),
+    schemas_()
+{
+    for (const auto* schema:schemas) {
+        const auto& op = operators.at(schema->getActionData().getId());
+
+        SchemaData data;
+        data.schema = schema;
+        data.num_params = schema->numParameters();
+        data.residual.simpleeqs = op.precondition.simpleeqs;
+
+        for (const auto& atom:op.precondition.fluents) {
+            // Only positive atoms can be evaluated as selections over the (true part of the) extension of the symbol
+            bool predicate = info.isPredicate(atom.predicate_id);
+            bool joinable = !atom.negated && (!predicate ||
+                    (atom.value.type == SimpleLiftedOperator::term_t::constant && atom.value.val.o == object_id::TRUE));
+
+            if (!joinable) {
+                data.residual.fluents.push_back(atom);
+                continue;
+            }
+
+            index_symbol(atom.predicate_id);
+            JoinAtom joinatom{atom.predicate_id, atom.arguments};
+            joinatom.columns.push_back(atom.value);
+            data.atoms.push_back(std::move(joinatom));
+        }
+
+        const auto& signature = schema->getSignature();
+        const auto& binding = schema->getBinding();
+        for (unsigned p = 0; p < data.num_params; ++p) {
+            if (binding.binds(p)) data.param_values.push_back({binding.value(p)});
+            else data.param_values.push_back(info.getTypeObjects(signature[p]));
+            data.param_domains.emplace_back(data.param_values.back().begin(), data.param_values.back().end());
+        }
+
+        schemas_.push_back(std::move(data));
+    }
+
+    unsigned num_indexed = std::count_if(symbols_.begin(), symbols_.end(), [](const SymbolIndex& s) { return s.indexed; });
+    LPT_INFO("cout", "Join-based successor generator: " << schemas_.size() << " action schemas, " << num_indexed << " indexed symbols");
+}
+
+void JoinSuccessorGenerator::index_symbol(unsigned symbol) {
+    auto& data = symbols_.at(symbol);
+    if (data.indexed) return;
+    data.indexed = true;
+
+    // The extensions of predicates contain only true atoms, but we keep the value column anyway,
+    // so that all extensions can be processed uniformly
+    const auto& symbol_data = info_.getSymbolData(symbol);
+    data.predicate = info_.isPredicate(symbol);
+    data.width = symbol_data.getSignature().size() + 1;
+
+    for (utils::binding_iterator it(symbol_data.getSignature(), info_); !it.ended(); ++it) {
+        auto binding = *it;
+        const std::vector<object_id>& point = binding.get_full_binding();
+
+        if (info_.is_fluent(symbol, point)) {
+            data.fluent_vars.push_back(info_.resolveStateVariable(symbol, point));
+            data.fluent_points.insert(data.fluent_points.end(), point.begin(), point.end());
+
+        } else {
+            object_id value = symbol_data.getFunction()(point);
+            if (data.predicate && value != object_id::TRUE) continue;
+            data.static_rows.insert(data.static_rows.end(), point.begin(), point.end());
+            data.static_rows.push_back(value);
+        }
+    }
+}
+
+void JoinSuccessorGenerator::compute_fluent_rows(unsigned symbol, const State& state, std::vector<object_id>& rows) const {
+    const auto& data = symbols_[symbol];
+    unsigned arity = data.width - 1;
+    rows.clear();
+
+    for (std::size_t i = 0, n = data.fluent_vars.size(); i < n; ++i) {
+        const object_id& value = state.getValue(data.fluent_vars[i]);
+        if (data.predicate && value != object_id::TRUE) continue;
+        auto point = data.fluent_points.begin() + i * arity;
+        rows.insert(rows.end(), point, point + arity);
+        rows.push_back(value);
+    }
+}
+
+bool JoinSuccessorGenerator::select(const SchemaData& data, const JoinAtom& atom, StateRelations& relations, Table& table) const {
+    table.params.clear();
+    table.rows.clear();
+    for (const auto& term:atom.columns) {
+        if (term.type != SimpleLiftedOperator::term_t::var) continue;
+        if (std::find(table.params.begin(), table.params.end(), term.val.varidx) == table.params.end()) {
+            table.params.push_back(term.val.varidx);
+        }
+    }
+
+    const auto& symbol = symbols_[atom.symbol];
+    std::size_t matches = 0;
+    matches += select_rows(data, atom, symbol.static_rows, symbol.width, table);
+    matches += select_rows(data, atom, relations.fluent_rows(atom.symbol), symbol.width, table);
+    return matches > 0;
+}
+
+std::size_t JoinSuccessorGenerator::select_rows(const SchemaData& data, const JoinAtom& atom, const std::vector<object_id>& rows, unsigned width, Table& table) const {
+    assert(atom.columns.size() == width);
+
+    // 'slot[c]' is the column of the table that corresponds to the c-th column of the extension, if a variable.
+    // Only the first occurrence of a variable sets the value of the slot; the rest need to match it.
+    std::vector<int> slot(width, -1);
+    std::vector<bool> first(width, false);
+    std::vector<bool> seen(table.params.size(), false);
+    for (unsigned c = 0; c < width; ++c) {
+        const auto& term = atom.columns[c];
+        if (term.type != SimpleLiftedOperator::term_t::var) continue;
+        slot[c] = std::find(table.params.begin(), table.params.end(), term.val.varidx) - table.params.begin();
+        first[c] = !seen[slot[c]];
+        seen[slot[c]] = true;
+    }
+
+    std::vector<object_id> tuple(table.params.size());
+    std::size_t matches = 0;
+    for (std::size_t r = 0, n = rows.size(); r < n; r += width) {
+        bool match = true;
+        for (unsigned c = 0; c < width && match; ++c) {
+            const object_id& value = rows[r + c];
+            if (slot[c] < 0) {
+                match = (value == atom.columns[c].val.o);
+            } else if (first[c]) {
+                match = data.param_domains[table.params[slot[c]]].count(value) > 0;
+                tuple[slot[c]] = value;
+            } else {
+                match = (tuple[slot[c]] == value);
+            }
+        }
+
+        if (match) {
+            ++matches;
+            table.rows.insert(table.rows.end(), tuple.begin(), tuple.end());
+        }
+    }
+    return matches;
+}
+
+bool JoinSuccessorGenerator::reduce(std::vector<Table>& tables) {
+    // The parameters that appear in more than one table, which are the only ones that can lead to any reduction
+    std::unordered_map<unsigned, unsigned> occurrences;
+    for (const auto& table:tables) {
+        for (unsigned p:table.params) ++occurrences[p];
+    }
+
+    for (bool changed = true; changed; ) {
+        changed = false;
+
+        for (const auto& elem:occurrences) {
+            if (elem.second < 2) continue;
+            unsigned p = elem.first;
+
+            // Compute the set of values of the parameter that are supported by all tables
+            ObjectSetT support;
+            bool initialized = false;
+            for (const auto& table:tables) {
+                auto col = std::find(table.params.begin(), table.params.end(), p) - table.params.begin();
+                if (col == (long) table.params.size()) continue;
+
+                ObjectSetT projection;
+                for (std::size_t r = 0, n = table.num_rows(); r < n; ++r) {
+                    const object_id& value = table.row(r)[col];
+                    if (!initialized || support.count(value)) projection.insert(value);
+                }
+                support = std::move(projection);
+                initialized = true;
+            }
+
+            // And filter out the rest from the tables
+            for (auto& table:tables) {
+                auto col = std::find(table.params.begin(), table.params.end(), p) - table.params.begin();
+                if (col == (long) table.params.size()) continue;
+
+                std::size_t width = table.params.size(), kept = 0;
+                for (std::size_t r = 0, n = table.num_rows(); r < n; ++r) {
+                    if (!support.count(table.rows[r * width + col])) continue;
+                    if (kept != r) std::copy_n(table.rows.begin() + r * width, width, table.rows.begin() + kept * width);
+                    ++kept;
+                }
+                if (kept == table.num_rows()) continue;
+
+                table.rows.resize(kept * width);
+                if (kept == 0) return false;
+                changed = true;
+            }
+        }
+    }
+    return true;
+}
+
+JoinSuccessorGenerator::Table JoinSuccessorGenerator::join(const Table& lhs, const Table& rhs) {
+    // The positions of the shared parameters in both tables, and of the rest of parameters of the right-hand side
+    std::vector<unsigned> lhs_shared, rhs_shared, rhs_extra;
+    Table result;
+    result.params = lhs.params;
+    for (unsigned c = 0; c < rhs.params.size(); ++c) {
+        auto it = std::find(lhs.params.begin(), lhs.params.end(), rhs.params[c]);
+        if (it != lhs.params.end()) {
+            lhs_shared.push_back(it - lhs.params.begin());
+            rhs_shared.push_back(c);
+        } else {
+            rhs_extra.push_back(c);
+            result.params.push_back(rhs.params[c]);
+        }
+    }
+
+    // Hash the right-hand side on the shared parameters
+    using KeyT = std::vector<object_id>;
+    std::unordered_map<KeyT, std::vector<std::size_t>, boost::hash<KeyT>> index;
+    KeyT key(rhs_shared.size());
+    for (std::size_t r = 0, n = rhs.num_rows(); r < n; ++r) {
+        const object_id* row = rhs.row(r);
+        for (unsigned k = 0; k < rhs_shared.size(); ++k) key[k] = row[rhs_shared[k]];
+        index[key].push_back(r);
+    }
+
+    // And probe it with each row of the left-hand side
+    for (std::size_t l = 0, n = lhs.num_rows(); l < n; ++l) {
+        const object_id* row = lhs.row(l);
+        for (unsigned k = 0; k < lhs_shared.size(); ++k) key[k] = row[lhs_shared[k]];
+        auto it = index.find(key);
+        if (it == index.end()) continue;
+
+        for (std::size_t r:it->second) {
+            const object_id* match = rhs.row(r);
+            result.rows.insert(result.rows.end(), row, row + lhs.params.size());
+            for (unsigned c:rhs_extra) result.rows.push_back(match[c]);
+        }
+    }
+    return result;
+}
+
+void JoinSuccessorGenerator::compute_bindings(unsigned i, const State& state, StateRelations& relations, BindingListT& bindings) const {
+    bindings.clear();
+    const auto& data = schemas_[i];
+
+    std::vector<Table> tables;
+    tables.reserve(data.atoms.size());
+    for (const auto& atom:data.atoms) {
+        Table table;
+        if (!select(data, atom, relations, table)) return;
+        // An atom with no parameters has already been checked to be satisfied
+        if (!table.params.empty()) tables.push_back(std::move(table));
+    }
+
+    if (!reduce(tables)) return;
+
+    // Join the tables, starting with the smallest one, and then greedily picking the one that shares most parameters
+    // with the current result, breaking ties in favor of smaller tables
+    Table result;
+    std::vector<bool> bound(data.num_params, false), joined(tables.size(), false);
+    for (unsigned k = 0; k < tables.size(); ++k) {
+        int best = -1;
+        unsigned best_shared = 0;
+        for (unsigned j = 0; j < tables.size(); ++j) {
+            if (joined[j]) continue;
+            unsigned shared = std::count_if(tables[j].params.begin(), tables[j].params.end(), [&bound](unsigned p) { return bound[p]; });
+            if (best < 0 || shared > best_shared || (shared == best_shared && tables[j].num_rows() < tables[best].num_rows())) {
+                best = j;
+                best_shared = shared;
+            }
+        }
+
+        joined[best] = true;
+        for (unsigned p:tables[best].params) bound[p] = true;
+        result = (k == 0) ? std::move(tables[best]) : join(result, tables[best]);
+        if (result.num_rows() == 0) return;
+    }
+
+    // The parameters not mentioned in any atom can take any value of their type
+    std::vector<unsigned> free;
+    for (unsigned p = 0; p < data.num_params; ++p) {
+        if (bound[p]) continue;
+        if (data.param_values[p].empty()) return;
+        free.push_back(p);
+    }
+
+    std::vector<object_id> binding(data.num_params);
+    std::size_t num_rows = tables.empty() ? 1 : result.num_rows();
+    for (std::size_t r = 0; r < num_rows; ++r) {
+        for (unsigned c = 0; c < result.params.size(); ++c) binding[result.params[c]] = result.row(r)[c];
+
+        // Iterate through the cartesian product of the values of the free parameters
+        std::vector<std::size_t> position(free.size(), 0);
+        for (unsigned f = 0; f < free.size(); ++f) binding[free[f]] = data.param_values[free[f]][0];
+
+        while (true) {
+            if (evaluate_simple_condition(state, data.residual, binding.data(), info_)) bindings.push_back(binding);
+
+            unsigned f = 0;
+            for (; f < free.size(); ++f) {
+                const auto& values = data.param_values[free[f]];
+                if (++position[f] < values.size()) {
+                    binding[free[f]] = values[position[f]];
+                    break;
+                }
+                position[f] = 0;
+                binding[free[f]] = values[0];
+            }
+            if (f == free.size()) break;
+        }
+    }
+}
+
+} // namespaces
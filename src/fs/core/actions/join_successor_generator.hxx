@@ -0,0 +1,132 @@
+
+#pragma once
+
+#include <fs/core/fs_types.hxx>
+#include <fs/core/actions/simple_lifted_operators.hxx>
+
+#include <boost/functional/hash.hpp>
+
+#include <unordered_set>
+#include <vector>
+
+
+namespace fs0 {
+
+class PartiallyGroundedAction;
+class ProblemInfo;
+class State;
+
+//! A database-style lifted successor generator. The precondition of each action schema, compiled into a
+//! SimpleLiftedOperator, is seen as a conjunctive query over the relations given by the extensions of the
+//! problem symbols in the state. The applicable bindings of a schema are then the answers to that query, which are
+//! computed by:
+//!   1. Selecting, for each positive precondition atom, the tuples of the extension of its symbol that match the
+//!      constants and repeated variables of the atom, and projecting them over the schema parameters.
+//!   2. Performing a semi-join reduction, i.e. removing from each such table the tuples with some parameter value
+//!      that is not supported by all other tables that mention the same parameter, until a fixpoint is reached.
+//!   3. Hash-joining the reduced tables, starting from the smallest one and following with the one that shares most
+//!      parameters with the tables already joined.
+//!   4. Completing the bindings with all the values of those parameters that appear in no atom, and filtering out
+//!      those that do not satisfy the remaining parts of the precondition: (in)equalities and negated atoms.
+//! Unlike CSP- or SDD-based successor generation, this requires no per-instance compilation.
+class JoinSuccessorGenerator {
+public:
+    using BindingListT = std::vector<std::vector<object_id>>;
+
+    //! A set of tuples of objects, stored in row-major order, where the i-th column corresponds to the
+    //! i-th parameter in 'params'.
+    struct Table {
+        std::vector<unsigned> params;
+        std::vector<object_id> rows;
+
+        std::size_t num_rows() const { return params.empty() ? 0 : rows.size() / params.size(); }
+        const object_id* row(std::size_t i) const { return &rows[i * params.size()]; }
+    };
+
+    //! The (fluent part of the) extensions of the problem symbols on a given state, computed lazily,
+    //! so that it can be reused for all action schemas.
+    class StateRelations {
+    public:
+        StateRelations(const JoinSuccessorGenerator& generator, const State& state);
+
+        //! The rows with the fluent tuples in the extension of the given symbol
+        const std::vector<object_id>& fluent_rows(unsigned symbol);
+
+    protected:
+        const JoinSuccessorGenerator& generator_;
+        const State& state_;
+        std::vector<std::vector<object_id>> rows_;
+        std::vector<bool> computed_;
+    };
+
+    //! 'operators' must be indexed by the ID of the action schemas (as given by their ActionData)
+    JoinSuccessorGenerator(const std::vector<const PartiallyGroundedAction*>& schemas,
+                           const std::vector<SimpleLiftedOperator>& operators,
+                           const ProblemInfo& info);
+
+    JoinSuccessorGenerator(const JoinSuccessorGenerator&) = delete;
+    JoinSuccessorGenerator(JoinSuccessorGenerator&&) = default;
+    JoinSuccessorGenerator& operator=(const JoinSuccessorGenerator&) = delete;
+    JoinSuccessorGenerator& operator=(JoinSuccessorGenerator&&) = delete;
+
+    std::size_t num_schemas() const { return schemas_.size(); }
+    const PartiallyGroundedAction* schema(unsigned i) const { return schemas_[i].schema; }
+
+    //! Compute in 'bindings' the bindings of all applicable groundings of the i-th schema in the state
+    //! to which the given relations correspond.
+    void compute_bindings(unsigned i, const State& state, StateRelations& relations, BindingListT& bindings) const;
+
+protected:
+    using ObjectSetT = std::unordered_set<object_id, boost::hash<object_id>>;
+
+    //! The extension of a symbol f is made up of all tuples (x_1, ..., x_n, y) such that f(x_1, ..., x_n) = y,
+    //! where for predicates only tuples with y = true are included. Some of them hold on every state; the rest
+    //! depend on the value of some state variable.
+    struct SymbolIndex {
+        bool indexed = false;
+        bool predicate = false;
+        //! The number of columns of the extension
+        unsigned width = 0;
+        std::vector<object_id> static_rows;
+        std::vector<VariableIdx> fluent_vars;
+        //! The point (x_1, ..., x_n) of each fluent variable, row-major
+        std::vector<object_id> fluent_points;
+    };
+
+    //! A positive precondition atom, seen as a selection over the extension of its symbol.
+    //! 'columns[i]' is the term that the i-th column of the extension needs to match.
+    struct JoinAtom {
+        unsigned symbol;
+        std::vector<SimpleLiftedOperator::simple_term> columns;
+    };
+
+    struct SchemaData {
+        const PartiallyGroundedAction* schema;
+        unsigned num_params;
+        std::vector<JoinAtom> atoms;
+        //! The part of the precondition that is not evaluated through joins
+        SimpleLiftedOperator::condition_t residual;
+        //! The values each parameter can take, as a list and as a set
+        std::vector<std::vector<object_id>> param_values;
+        std::vector<ObjectSetT> param_domains;
+    };
+
+    const ProblemInfo& info_;
+    std::vector<SymbolIndex> symbols_;
+    std::vector<SchemaData> schemas_;
+
+    void index_symbol(unsigned symbol);
+    void compute_fluent_rows(unsigned symbol, const State& state, std::vector<object_id>& rows) const;
+
+    //! Select the tuples of the extension of the symbol of the atom that match it and project them over the
+    //! parameters of the atom. Return false iff there is no such tuple.
+    bool select(const SchemaData& data, const JoinAtom& atom, StateRelations& relations, Table& table) const;
+    std::size_t select_rows(const SchemaData& data, const JoinAtom& atom, const std::vector<object_id>& rows, unsigned width, Table& table) const;
+
+    //! Perform the semi-join reduction of the given tables. Return false iff some table becomes empty.
+    static bool reduce(std::vector<Table>& tables);
+
+    static Table join(const Table& lhs, const Table& rhs);
+};
+
+} // namespaces
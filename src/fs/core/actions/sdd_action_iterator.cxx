@@ -5,64 +5,91 @@
 #include <fs/core/actions/actions.hxx>
 #include <fs/core/languages/fstrips/formulae.hxx>
 #include <fs/core/utils/atom_index.hxx>
+#include <fs/core/utils/thread_pool.hxx>
 #include <sdd/sddapi.hxx>
 
 #include <lapkt/tools/logging.hxx>
 
 namespace fs0 {
 
-    SDDActionIterator::SDDActionIterator(const State& state, const std::vector<std::shared_ptr<ActionSchemaSDD>>& sdds, const AtomIndex& tuple_index) :
-            state_(state), sdds_(sdds)
-    {}
+    SDDActionIterator::SDDActionIterator(const State& state, const std::vector<std::shared_ptr<ActionSchemaSDD>>& sdds, const AtomIndex& tuple_index, ThreadPool* pool) :
+            state_(state), sdds_(sdds), precomputed_()
+    {
+        if (!pool || sdds.size() < 2) return;
+
+        // Each worker writes only the slot of the schema it processes, and only reads the values of state_ (not
+        // its derived atoms), hence no synchronization is needed. The SDD of each schema is only used by one worker.
+        precomputed_.resize(sdds.size());
+        pool->parallel_for(sdds.size(), [this](unsigned i) {
+            precomputed_[i] = sdds_[i]->compute_bindings(state_);
+        });
+    }
 
-    SDDActionIterator::Iterator::Iterator(const State& state, const std::vector<std::shared_ptr<ActionSchemaSDD>>& sdds, unsigned currentIdx) :
+    SDDActionIterator::Iterator::Iterator(const State& state, const std::vector<std::shared_ptr<ActionSchemaSDD>>& sdds,
+                                          const std::vector<std::shared_ptr<const ActionSchemaSDD::BindingListT>>* precomputed, unsigned currentIdx) :
             state_(state),
             sdds_(sdds),
+            precomputed_(precomputed),
             current_sdd_idx_(currentIdx),
             current_sdd_(nullptr),
             current_models_computed_(false),
-            _action(nullptr),
-            current_resultset_()
+            _action(LiftedActionID::invalid_action_id),
+            _binding(),
+            current_resultset_(),
+            current_resultset_idx_(0),
+            enumerator_(),
+            current_enumerated_()
     {
         advance();
     }
 
-    SDDActionIterator::Iterator::~Iterator() {
-        delete _action;
-    }
+    SDDActionIterator::Iterator::~Iterator() = default;
 
     void SDDActionIterator::Iterator::advance() {
         for (; current_sdd_idx_ < sdds_.size(); ++current_sdd_idx_) {
             ActionSchemaSDD& schema_sdd = *sdds_[current_sdd_idx_];
 
             if (!current_models_computed_) {
-                assert (current_resultset_.empty());
+                assert (!current_resultset_);
 
-                RecursiveModelEnumerator enumerator(schema_sdd.manager(), schema_sdd.collect_state_literals(state_));
-                current_resultset_ = enumerator.models(schema_sdd.node());
-
-//              std::cout << current_resultset_.size() << " models were actually retrieved" << std::endl;
+                current_resultset_ = precomputed_ ? (*precomputed_)[current_sdd_idx_] : schema_sdd.find_cached_bindings(state_);
+                if (!current_resultset_) {
+                    enumerator_.reset(schema_sdd.manager(), schema_sdd.node(), schema_sdd.collect_state_literals(state_));
+                    current_enumerated_.clear();
+                }
 
                 current_models_computed_ = true;
                 current_resultset_idx_ = 0;
             }
 
-            if (current_resultset_idx_ < current_resultset_.size()) {
-                const auto& model = current_resultset_[current_resultset_idx_];
+            if (current_resultset_) {
+                if (current_resultset_idx_ < current_resultset_->size()) {
+                    const auto& grounding = (*current_resultset_)[current_resultset_idx_];
+                    _action.assign(&schema_sdd.get_schema(), grounding.data(), grounding.data() + grounding.size());
 
-                delete _action;
-                auto grounding = schema_sdd.get_binding_from_model(model);
+                    ++current_resultset_idx_;
+                    return;
+                }
 
-                _action = new LiftedActionID(&schema_sdd.get_schema(), std::move(grounding));
+            } else if (enumerator_.next()) {
+                schema_sdd.get_binding_from_model(enumerator_.model(), _binding);
+                if (schema_sdd.caches_bindings()) current_enumerated_.push_back(_binding);
 
-                ++current_resultset_idx_;
+                _action.assign(&schema_sdd.get_schema(), _binding.data(), _binding.data() + _binding.size());
                 return;
+
+            } else {
+                // The enumeration is complete, hence the collected bindings are all the applicable ones
+                if (schema_sdd.caches_bindings()) {
+                    schema_sdd.cache_bindings(state_, std::move(current_enumerated_));
+                    current_enumerated_.clear();
+                }
             }
 
             // At this point we have explored all solutions to the current action-schema SDD
             current_sdd_ = nullptr;
             current_models_computed_ = false;
-            current_resultset_.clear();
+            current_resultset_.reset();
             current_resultset_idx_ = 0;
         }
     }
@@ -4,12 +4,13 @@
 #include <memory>
 #include <vector>
 
+#include <fs/core/actions/action_id.hxx>
 #include <fs/core/utils/sdd.hxx>
 
 
 namespace fs0 {
 	class State;
-	class LiftedActionID;
+	class ThreadPool;
 }
 
 namespace fs0::language::fstrips { class Formula; }
@@ -28,8 +29,13 @@ namespace fs0 {
 
         const std::vector<std::shared_ptr<ActionSchemaSDD>>& sdds_;
 
+        //! The bindings of the applicable groundings of each schema, if they were computed upfront in parallel
+        std::vector<std::shared_ptr<const ActionSchemaSDD::BindingListT>> precomputed_;
+
     public:
-        SDDActionIterator(const State& state, const std::vector<std::shared_ptr<ActionSchemaSDD>>& sdds, const AtomIndex& tuple_index);
+        //! If a thread pool is given, the applicable bindings of the different schemas, each of which has its own
+        //! SDD manager, are computed upfront and concurrently. They are anyway iterated in the order of the schemas.
+        SDDActionIterator(const State& state, const std::vector<std::shared_ptr<ActionSchemaSDD>>& sdds, const AtomIndex& tuple_index, ThreadPool* pool = nullptr);
 
         class Iterator {
             friend class SDDActionIterator;
@@ -39,23 +45,37 @@ namespace fs0 {
             ~Iterator();
 
         protected:
-            Iterator(const State& state, const std::vector<std::shared_ptr<ActionSchemaSDD>>& sdds, unsigned currentIdx);
+            Iterator(const State& state, const std::vector<std::shared_ptr<ActionSchemaSDD>>& sdds,
+                     const std::vector<std::shared_ptr<const ActionSchemaSDD::BindingListT>>* precomputed, unsigned currentIdx);
 
             const State& state_;
 
             const std::vector<std::shared_ptr<ActionSchemaSDD>>& sdds_;
 
+            //! Null unless the bindings were computed upfront
+            const std::vector<std::shared_ptr<const ActionSchemaSDD::BindingListT>>* precomputed_;
+
             unsigned current_sdd_idx_;
 
             SddNode* current_sdd_;
 
             bool current_models_computed_;
 
-            LiftedActionID* _action;
+            //! The current action, which is overwritten in place on each advance to avoid allocations
+            LiftedActionID _action;
 
-            std::vector<SDDModel> current_resultset_;
+            //! A buffer for the binding of the current SDD model
+            std::vector<object_id> _binding;
+
+            //! The bindings of the applicable groundings of the current schema, if found in the schema cache.
+            //! Otherwise, the SDD models are lazily enumerated, and the bindings collected in 'current_enumerated_'
+            //! are cached only if the enumeration is completed.
+            std::shared_ptr<const ActionSchemaSDD::BindingListT> current_resultset_;
             unsigned current_resultset_idx_;
 
+            DFSModelEnumerator enumerator_;
+            ActionSchemaSDD::BindingListT current_enumerated_;
+
             //! Advance into the next SDD model
             void advance();
 
@@ -66,15 +86,15 @@ namespace fs0 {
             }
             const Iterator operator++(int) {Iterator tmp(*this); operator++(); return tmp;}
 
-            const LiftedActionID& operator*() const { return *_action; }
+            const LiftedActionID& operator*() const { return _action; }
 
             //! This is not really true... but will work for the purpose of comparing with the end iterator.
             bool operator==(const Iterator &other) const { return current_sdd_idx_ == other.current_sdd_idx_; }
             bool operator!=(const Iterator &other) const { return !(this->operator==(other)); }
         };
 
-        Iterator begin() const { return {state_, sdds_, 0}; }
-        Iterator end() const { return {state_, sdds_, (unsigned int) sdds_.size()}; }
+        Iterator begin() const { return {state_, sdds_, precomputed_.empty() ? nullptr : &precomputed_, 0}; }
+        Iterator end() const { return {state_, sdds_, nullptr, (unsigned int) sdds_.size()}; }
     };
 
 
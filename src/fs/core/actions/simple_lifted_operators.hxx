@@ -96,10 +96,18 @@ public:
 
 SimpleLiftedOperator compile_schema_to_simple_lifted_operator(const PartiallyGroundedAction& action);
 
+//! Return true iff the given condition holds in the given state under the given binding, which must have
+//! one value per parameter of the action schema
+bool evaluate_simple_condition(
+        const State& state,
+        const SimpleLiftedOperator::condition_t& condition,
+        const object_id* binding,
+        const ProblemInfo& info);
+
 void evaluate_simple_lifted_operator(
         const State& state,
         const SimpleLiftedOperator& op,
-        const std::vector<object_id>& binding,
+        const object_id* binding,
         const ProblemInfo& info,
         bool check_precondition,
         std::vector<Atom>& atoms);
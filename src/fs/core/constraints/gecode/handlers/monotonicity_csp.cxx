@@ -34,7 +34,10 @@ _as_atoms(const State& state) {
 
 MonotonicityCSP::MonotonicityCSP(const fs::Formula* formula, const AtomIndex& tuple_index, const AllTransitionGraphsT& transitions, bool complete)
 	:  FormulaCSP(formula, tuple_index, !complete),
-       _monotonicity(tuple_index, transitions)
+       _monotonicity(tuple_index, transitions),
+       _propagator(_extensional_constraints.empty() ? MonotonicityPropagator::build(_formula, _monotonicity) : nullptr),
+       _native_nodes(0),
+       _gecode_nodes(0)
 {}
 
 FSGecodeSpace* MonotonicityCSP::
@@ -123,30 +126,31 @@ DomainTracker MonotonicityCSP::
 compute_base_domains(const DomainTracker& parent_domains,
                      const std::vector<Atom>& changeset) const {
 
-    // Start with a fresh copy of the parent domains. We assume that there is no empty domain there.
-    std::vector<TransitionGraph::BitmapT> resulting_domains(parent_domains.domains());
+    // Start sharing all domains with the parent. We assume that there is no empty domain there.
+    DomainTracker result(parent_domains);
 
-    // Compute reachable domains given by current state, only for those variables which have
-    // changed their value wrt the parent state. If any of those variables is not monotonic,
-    // a nullptr will be returned
-    auto modified_variable_domains = _monotonicity.retrieve_domains(changeset);
-
-//    std::cout << "Base: " << print::domain_tracker(DomainTracker(std::vector<TransitionGraph::BitmapT>(resulting_domains))) << std::endl;
+//    std::cout << "Base: " << print::domain_tracker(result) << std::endl;
 //    std::cout << "Changeset: " << std::endl;
 
-    // Compute the intersection (in place)
-    assert(modified_variable_domains.size() == changeset.size());
-    for (unsigned i = 0, s = changeset.size(); i < s; ++i) {
-        VariableIdx var = changeset[i].getVariable();
+    // Intersect the domains of those variables which have changed their value wrt the parent state
+    // with the values reachable from their new value. Only domains that actually shrink are reallocated.
+    for (const auto& atom:changeset) {
+        VariableIdx var = atom.getVariable();
         if (!_monotonicity.is_monotonic(var)) continue;
 
-//        std::cout << print::bitset(var, modified_variable_domains[i]) << std::endl;
-        assert(resulting_domains[var].size() == modified_variable_domains[i].size());
-        resulting_domains[var] &= modified_variable_domains[i];
-        if (resulting_domains[var].none()) return {};
+        const auto& reachable = _monotonicity.reachable_values(var, atom.getValue());
+        const auto& current = result.domain(var);
+//        std::cout << print::bitset(var, reachable) << std::endl;
+        assert(current.size() == reachable.size());
+        if (current.is_subset_of(reachable)) continue;
+
+        TransitionGraph::BitmapT pruned(current);
+        pruned &= reachable;
+        if (pruned.none()) return {};
+        result.update(var, std::move(pruned));
     }
 
-    return DomainTracker(std::move(resulting_domains));
+    return result;
 }
 
 DomainTracker MonotonicityCSP::
@@ -177,6 +181,13 @@ generate_node(const State& parent, const DomainTracker& parent_domains,
     // Compute the domains that will form the basis for the CSP
     auto base_domains = compute_base_domains(parent_domains, changeset);
 
+    if (_propagator) {
+        ++_native_nodes;
+        if (base_domains.is_null() || !_propagator->propagate(base_domains)) return {};
+        return base_domains;
+    }
+
+    ++_gecode_nodes;
     return post_monotonicity_csp_from_domains(child, base_domains, false);
 }
 
@@ -203,19 +214,18 @@ post_monotonicity_csp_from_domains(const State& state, const DomainTracker& doma
 
 DomainTracker MonotonicityCSP::prune_domains(const FSGecodeSpace& csp, const DomainTracker& tracker) const {
 
-    std::vector<TransitionGraph::BitmapT> pruned(tracker.size());
-    const auto& original_domains = tracker.domains();
+    // Domains not pruned by the CSP remain shared with the given tracker
+    DomainTracker pruned(tracker);
 
     for (VariableIdx var:_monotonicity.monotonic_variables()) {
 
         // For each monotonic variable, we collect the values that are locally consistent.
         // This might not be too efficient, but Gecode doesn't seem to provide a better way
         // to inspect which values are consistent.
-        auto& domain = pruned[var];
         if (_translator.is_indexed(var)) {
 
             // Start with an all-0 bitset of appropriate size
-            domain = TransitionGraph::BitmapT(original_domains[var].size(), 0);
+            TransitionGraph::BitmapT domain(tracker.domain(var).size(), 0);
 
             // And then flip to 1 those values in the domain which remain in the csp-pruned domains
             const auto& intvar = _translator.resolveInputStateVariable(csp, var);
@@ -225,15 +235,13 @@ DomainTracker MonotonicityCSP::prune_domains(const FSGecodeSpace& csp, const Dom
 
                 domain[static_cast<unsigned>(value)] = true;
             }
+
+            if (domain != tracker.domain(var)) pruned.update(var, std::move(domain));
         }
-        else {
-            // The variable is not indexed by the translator because it is involved in the goal
-            // only as a nested fluent. ATM we simply copy the domain from the parent
-            //assert(0); // This shouldn't be happening?
-            domain = original_domains[var];
-        }
+        // Otherwise, the variable is not indexed by the translator because it is involved in the goal
+        // only as a nested fluent. ATM we simply keep the domain from the parent
     }
-    return DomainTracker(std::move(pruned));
+    return pruned;
 }
 
 
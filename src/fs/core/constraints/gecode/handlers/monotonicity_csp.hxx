@@ -3,6 +3,7 @@
 
 #include <fs/core/constraints/gecode/handlers/formula_csp.hxx>
 #include <fs/core/monotonicity.hxx>
+#include <fs/core/constraints/native/monotonicity_propagator.hxx>
 
 namespace fs0 { class AtomIndex; class Problem; class Config; }
 namespace fs0 { namespace language { namespace fstrips { class Formula; }}}
@@ -32,9 +33,19 @@ public:
     generate_node(const State& parent, const DomainTracker& parent_domains, const State& child,
                   const std::vector<Atom>& changeset) const;
 
+    //! The number of nodes whose CSP was propagated natively and through Gecode, respectively
+    unsigned long native_nodes() const { return _native_nodes; }
+    unsigned long gecode_nodes() const { return _gecode_nodes; }
+
 protected:
 	const TransitionGraph _monotonicity;
 
+    //! The native propagator, if all constraints of the CSP can be natively propagated, or null otherwise
+    const std::unique_ptr<MonotonicityPropagator> _propagator;
+
+    mutable unsigned long _native_nodes;
+    mutable unsigned long _gecode_nodes;
+
     bool check_transitions(const State& parent,
                            const std::vector<Atom>& changeset) const;
 
@@ -107,8 +107,8 @@ void check_magic(std::istream& in, const std::string& magic) {
     in >> std::ws;
 }
 
-ActionSchemaCSP ActionSchemaCSP::load(std::ifstream& in, const ProblemInfo& info, std::vector<unsigned>& symbols_in_extensions) {
-    ActionSchemaCSP csp;
+ActionSchemaCSP ActionSchemaCSP::load(std::ifstream& in, const std::string& schema_name, const ProblemInfo& info, std::vector<unsigned>& symbols_in_extensions) {
+    ActionSchemaCSP csp(schema_name);
     std::string line, line2;
     std::vector<std::string> components;
     unsigned nvariables = 0, nparameters = 0, nconstraints = 0, neffrelevant = 0;
@@ -207,8 +207,16 @@ ActionSchemaCSP ActionSchemaCSP::load(std::ifstream& in, const ProblemInfo& info
     return csp;
 }
 
-ActionSchemaCSP::ActionSchemaCSP() :
-    space(new FSGecodeSpace())
+ActionSchemaCSPStats::~ActionSchemaCSPStats() {
+    if (instantiations == 0) return;
+    LPT_INFO("cout", "CSP of action schema \"" << schema_name << "\": " << instantiations << " instantiations, "
+                     << pruned_before_cloning << " pruned before cloning, " << clones << " clones, "
+                     << propagation_failures << " failed propagations, " << solutions << " solutions");
+}
+
+ActionSchemaCSP::ActionSchemaCSP(const std::string& schema_name) :
+    space(new FSGecodeSpace()),
+    stats(std::make_shared<ActionSchemaCSPStats>(schema_name))
 {}
 
 bool ActionSchemaCSP::initialize(const SymbolExtensionGenerator& extension_generator) {
@@ -240,21 +248,36 @@ bool ActionSchemaCSP::initialize(const SymbolExtensionGenerator& extension_gener
 
 
 FSGecodeSpace* ActionSchemaCSP::instantiate(const State& state, const std::vector<Gecode::TupleSet>& symbol_extensions) const {
-    // Note that for state-variable constraints we don't even need to have cloned the CSP
+    ++stats->instantiations;
+
+    // Note that for state-variable constraints we don't even need to have cloned the CSP, and neither
+    // for table constraints that we can detect (by non-Gecode means) not to be consistent
     for (const auto& c:statevar_constraints) {
-        if (!c.post(state)) return nullptr;
+        if (!c.post(state)) {
+            ++stats->pruned_before_cloning;
+            return nullptr;
+        }
+    }
+
+    for (const auto& c:table_constraints) {
+        if (!c.satisfiable(symbol_extensions.at(c.symbol_idx()))) {
+            ++stats->pruned_before_cloning;
+            return nullptr;
+        }
     }
 
     // NOLINTNEXTLINE(cppcoreguidelines-pro-type-static-cast-downcast)
     auto* clone = static_cast<FSGecodeSpace*>(space->clone());
+    ++stats->clones;
 
     for (const auto& c:table_constraints) {
-        if (!c.post(*clone, symbol_extensions.at(c.symbol_idx()))) {
-            // We detected (by non-Gecode means) that the extensional constraint is not consistent,
-            // hence we can early-abort the processing
-            delete clone;
-            return nullptr;
-        }
+        c.post(*clone, symbol_extensions.at(c.symbol_idx()));
+    }
+
+    if (!clone->propagate()) {
+        ++stats->propagation_failures;
+        delete clone;
+        return nullptr;
     }
 
     return clone;
@@ -263,11 +286,17 @@ FSGecodeSpace* ActionSchemaCSP::instantiate(const State& state, const std::vecto
 
 std::vector<object_id> ActionSchemaCSP::build_binding_from_solution(const FSGecodeSpace* solution) const {
     std::vector<object_id> values;
+    build_binding_from_solution(solution, values);
+    return values;
+}
+
+void ActionSchemaCSP::build_binding_from_solution(const FSGecodeSpace* solution, std::vector<object_id>& values) const {
+    ++stats->solutions;
+    values.clear();
     values.reserve(parameter_variables.size());
     for (int csp_var_idx:parameter_variables) {
         values.push_back(make_object(type_id::object_t, solution->intvars[csp_var_idx].val()));
     }
-    return values;
 }
 
 
@@ -4,6 +4,7 @@
 #include "constraints.hxx"
 
 #include <memory>
+#include <string>
 
 namespace fs0 {
     class LiftedActionID;
@@ -16,10 +17,26 @@ namespace fs0::gecode::v2 {
 class FSGecodeSpace;
 class SymbolExtensionGenerator;
 
+//! Counts of the work done to instantiate the CSP of a schema on different states, reported on destruction
+struct ActionSchemaCSPStats {
+    explicit ActionSchemaCSPStats(std::string schema_name) : schema_name(std::move(schema_name)) {}
+    ~ActionSchemaCSPStats();
+
+    std::string schema_name;
+    //! The number of states on which the CSP was instantiated
+    unsigned long instantiations = 0;
+    //! The number of instantiations detected to be inconsistent before having to clone the prototype space
+    unsigned long pruned_before_cloning = 0;
+    unsigned long clones = 0;
+    //! The number of clones found to be inconsistent by the propagation of the state-dependent constraints
+    unsigned long propagation_failures = 0;
+    unsigned long solutions = 0;
+};
+
 //! A CSP modeling and solving the effect of an action on a certain RPG layer
 class ActionSchemaCSP {
 protected:
-    ActionSchemaCSP();
+    explicit ActionSchemaCSP(const std::string& schema_name);
 
 public:
     ~ActionSchemaCSP() = default;
@@ -29,7 +46,7 @@ public:
     ActionSchemaCSP& operator=(ActionSchemaCSP&&) = default;
 
     //! Load an object from a serialized representation
-    static ActionSchemaCSP load(std::ifstream& in, const ProblemInfo& info, std::vector<unsigned>& symbols_in_extensions);
+    static ActionSchemaCSP load(std::ifstream& in, const std::string& schema_name, const ProblemInfo& info, std::vector<unsigned>& symbols_in_extensions);
 
     //! Post all those constraints that do not depend on any particular state.
     //! Return true iff the underlying CSP is locally consistent after that propagation.
@@ -39,17 +56,24 @@ public:
 
     //! Clone the underlying CSP and post *on the clone* those constraints that depend on the given state and
     //! set of extensions (which in turn depend on the state, but it's good for performance reasons to compute them
-    //! once for all interested CSPs). Return the cloned CSP, or null if it is not locally consistent and hence we
-    //! know can't have any solution.
+    //! once for all interested CSPs). Return the cloned and propagated CSP, or null if it is not locally consistent
+    //! and hence we know can't have any solution. Whenever possible, inconsistency is detected before cloning.
     FSGecodeSpace* instantiate(const State& state, const std::vector<Gecode::TupleSet>& symbol_extensions) const;
 
     //! Return the action binding that corresponds to the given solution
     std::vector<object_id> build_binding_from_solution(const FSGecodeSpace* solution) const;
 
+    //! Same as above, but writing the binding into 'values', whose storage is reused
+    void build_binding_from_solution(const FSGecodeSpace* solution, std::vector<object_id>& values) const;
+
 protected:
-    //! The base Gecode CSP
+    //! The base Gecode CSP, i.e. the prototype space, already propagated with all state-independent constraints,
+    //! which is cloned for each state
     std::shared_ptr<FSGecodeSpace> space;
 
+    //! Shared among all copies of the CSP, so that the stats are reported only once
+    std::shared_ptr<ActionSchemaCSPStats> stats;
+
     //! 'parameter_variables_[i]' contains the index of the integer CSP variable that models the value of i-th parameter of the action schema
     std::vector<int> parameter_variables;
 
@@ -16,7 +16,7 @@ bool TableConstraint::post(FSGecodeSpace& csp, const Gecode::TupleSet& extension
     assert(extension.finalized());
 
     // If the extension of the constraint is empty and it is not a negative constraint, flag the CSP as unsolvable
-    if (!negative && extension.tuples() == 0) return false;
+    if (!satisfiable(extension)) return false;
 
     Gecode::IntVarArgs variables;
     for (auto i:varidxs) {
@@ -37,6 +37,9 @@ public:
 	//! Constraint-posting routines
 	bool post(FSGecodeSpace& csp, const Gecode::TupleSet& extension) const;
 
+	//! Return false if the constraint is known to be unsatisfiable with the given extension without posting it
+	bool satisfiable(const Gecode::TupleSet& extension) const { return negative || extension.tuples() > 0; }
+
 	//! Prints a representation of the state to the given stream.
 	friend std::ostream& operator<<(std::ostream &os, const TableConstraint&  o) { return o.print(os); }
 	std::ostream& print(std::ostream& os) const;
@@ -7,6 +7,8 @@
 
 #include <lapkt/tools/logging.hxx>
 
+#include <algorithm>
+
 
 namespace fs0::gecode::v2 {
 
@@ -95,7 +97,8 @@ SymbolExtensionGenerator::SymbolExtensionGenerator(
         const ProblemInfo& info,
         const AtomIndex& tuple_index,
         std::vector<unsigned> managed) :
-    managed(managed)
+    managed(managed),
+    dirty(managed.size(), false)
 {
     for (unsigned s=0; s < managed.size(); ++s) {
         if ((bool) managed[s]) {
@@ -105,22 +108,50 @@ SymbolExtensionGenerator::SymbolExtensionGenerator(
             individuals.push_back(IndividualSymbolExtensionGenerator());
         }
     }
+
+    for (unsigned s=0; s < managed.size(); ++s) {
+        if (!managed[s]) continue;
+        for (const auto& elem:individuals[s].fluent_tuples) tracked.emplace_back(std::get<0>(elem), s);
+    }
+    std::sort(tracked.begin(), tracked.end());
+    tracked.erase(std::unique(tracked.begin(), tracked.end()), tracked.end());
 }
 
 std::vector<Gecode::TupleSet> SymbolExtensionGenerator::instantiate(const State& state) const {
-    std::vector<Gecode::TupleSet> result;
-    result.reserve(managed.size());
-
     auto sz = managed.size();
+
+    if (last_extensions.empty()) { // No extension has been instantiated yet, build all of them
+        last_extensions.reserve(sz);
+        for (unsigned s=0; s < sz; ++s) {
+            if (managed[s] && !is_fully_static(s)) {
+                last_extensions.emplace_back(individuals[s].instantiate(state));
+            } else {
+                last_extensions.emplace_back();
+            }
+        }
+
+        last_values.reserve(tracked.size());
+        for (const auto& elem:tracked) last_values.push_back(state.getValue(elem.first));
+        return last_extensions;
+    }
+
+    for (unsigned i = 0, n = tracked.size(); i < n; ++i) {
+        const object_id& value = state.getValue(tracked[i].first);
+        if (value != last_values[i]) {
+            last_values[i] = value;
+            dirty[tracked[i].second] = true;
+        }
+    }
+
     for (unsigned s=0; s < sz; ++s) {
-        if (managed[s] && !is_fully_static(s)) {
-            result.emplace_back(individuals[s].instantiate(state));
-        } else {
-            result.emplace_back();
+        if (dirty[s]) {
+            last_extensions[s] = individuals[s].instantiate(state);
+            dirty[s] = false;
         }
     }
 
-    return result;
+    // Copying the vector only copies the (reference-counted) tupleset handles
+    return last_extensions;
 }
 
 bool SymbolExtensionGenerator::is_fully_static(unsigned symbol_id) const {
@@ -1,7 +1,7 @@
 
 #pragma once
 
-#include <fs/core/base.hxx>
+#include <fs/core/fs_types.hxx>
 
 #include <gecode/int.hh>
 
@@ -28,6 +28,11 @@ class IndividualSymbolExtensionGenerator;
 //!
 //! Note that function extensions include the function codomain value, i.e. contain tuples of size equal to the arity
 //! of the function plus one.
+//!
+//! Since consecutive states for which extensions are requested (typically a node and its parent or siblings) differ
+//! in a few atoms only, the generator keeps the extensions last instantiated, together with the values of the state
+//! variables they were built from, and only rebuilds the extensions of symbols some of whose state variables have
+//! changed. The rest are shared, as Gecode::TupleSet is a reference-counted handle.
 class SymbolExtensionGenerator {
 public:
     //! `managed[i]` denotes that we want to manage symbol with ID i.
@@ -49,6 +54,16 @@ protected:
     std::vector<unsigned> managed;
 
     std::vector<IndividualSymbolExtensionGenerator> individuals;
+
+    //! All state variables relevant to some non-static managed symbol, along with the ID of that symbol
+    std::vector<std::pair<VariableIdx, unsigned>> tracked;
+
+    //! The last instantiated extensions, and the values of the tracked variables in the state they were built from
+    mutable std::vector<Gecode::TupleSet> last_extensions;
+    mutable std::vector<object_id> last_values;
+
+    //! A buffer to mark the symbols whose extension needs to be rebuilt
+    mutable std::vector<bool> dirty;
 };
 
 //! While the above SymbolExtensionGenerator class takes care of all symbols in the problem, this class just takes
@@ -0,0 +1,124 @@
+
+#include <algorithm>
+
+#include <fs/core/constraints/native/monotonicity_propagator.hxx>
+#include <fs/core/languages/fstrips/language.hxx>
+#include <fs/core/problem_info.hxx>
+#include <lapkt/tools/logging.hxx>
+
+
+namespace fs0 { namespace gecode {
+
+// Helper - intersect the domain of the target variable with that of the other one, of possibly different size.
+// Returns true iff the target domain changed.
+bool _intersect(DomainTracker& domains, VariableIdx target, VariableIdx other) {
+	const auto& current = domains.domain(target);
+	TransitionGraph::BitmapT result(domains.domain(other));
+	result.resize(current.size(), false);
+	result &= current;
+	if (result == current) return false;
+	domains.update(target, std::move(result));
+	return true;
+}
+
+std::unique_ptr<MonotonicityPropagator>
+MonotonicityPropagator::build(const fs::Formula* formula, const TransitionGraph& monotonicity) {
+	std::unique_ptr<MonotonicityPropagator> propagator(new MonotonicityPropagator());
+
+	if (dynamic_cast<const fs::Tautology*>(formula)) return propagator;
+
+	const auto* conjunction = dynamic_cast<const fs::Conjunction*>(formula);
+	std::vector<const fs::Formula*> conjuncts = conjunction ? conjunction->getSubformulae() : std::vector<const fs::Formula*>{formula};
+
+	for (const fs::Formula* conjunct:conjuncts) {
+		if (!propagator->index(conjunct, monotonicity)) {
+			LPT_INFO("cout", "Monotonicity CSP will be handled by Gecode, as native propagation does not support constraint: " << *conjunct);
+			return nullptr;
+		}
+	}
+
+	LPT_INFO("cout", "Monotonicity CSP will be propagated natively: " << propagator->_equalities.size() << " equalities, "
+	                 << propagator->_inequalities.size() << " inequalities, " << propagator->_bindings.size() << " bindings");
+	return propagator;
+}
+
+bool MonotonicityPropagator::index(const fs::Formula* conjunct, const TransitionGraph& monotonicity) {
+	const auto* eq_atom = dynamic_cast<const fs::EQAtomicFormula*>(conjunct);
+	const auto* neq_atom = dynamic_cast<const fs::NEQAtomicFormula*>(conjunct);
+	if (!eq_atom && !neq_atom) return false;
+
+	const auto* atom = eq_atom ? static_cast<const fs::RelationalFormula*>(eq_atom) : static_cast<const fs::RelationalFormula*>(neq_atom);
+	const auto* lhs_var = dynamic_cast<const fs::StateVariable*>(atom->lhs());
+	const auto* rhs_var = dynamic_cast<const fs::StateVariable*>(atom->rhs());
+	const auto* lhs_const = dynamic_cast<const fs::Constant*>(atom->lhs());
+	const auto* rhs_const = dynamic_cast<const fs::Constant*>(atom->rhs());
+
+	// A constraint X = Y
+	if (lhs_var && rhs_var) {
+		if (!eq_atom) return false;
+		VariableIdx x = lhs_var->getValue(), y = rhs_var->getValue();
+		// Gecode would prune the domain of the monotonic variable with the static domain of a non-monotonic one
+		if (!monotonicity.is_monotonic(x) || !monotonicity.is_monotonic(y)) return false;
+		_bindings.emplace_back(x, y);
+		return true;
+	}
+
+	// A constraint X = c or X != c
+	const fs::StateVariable* statevar = lhs_var ? lhs_var : rhs_var;
+	const fs::Constant* constant = lhs_const ? lhs_const : rhs_const;
+	if (!statevar || !constant) return false;
+
+	VariableIdx var = statevar->getValue();
+	object_id value = constant->getValue();
+
+	if (!monotonicity.is_monotonic(var)) {
+		// The domain of the variable is not restricted by monotonicity, hence the constraint has no effect on the
+		// propagation, unless it is statically unsatisfiable, a case which we leave to Gecode
+		const auto& objects = ProblemInfo::getInstance().getVariableObjects(var);
+		bool in_domain = std::find(objects.begin(), objects.end(), value) != objects.end();
+		return eq_atom ? in_domain : true;
+	}
+
+	int idx = fs0::value<int>(value);
+	if (idx < 0) return false;
+
+	if (eq_atom) _equalities.emplace_back(var, static_cast<unsigned>(idx));
+	else _inequalities.emplace_back(var, static_cast<unsigned>(idx));
+	return true;
+}
+
+bool MonotonicityPropagator::propagate(DomainTracker& domains) const {
+	for (const auto& eq:_equalities) {
+		const auto& domain = domains.domain(eq.first);
+		if (eq.second >= domain.size() || !domain.test(eq.second)) return false;
+		if (domain.count() == 1) continue;
+
+		TransitionGraph::BitmapT singleton(domain.size());
+		singleton.set(eq.second);
+		domains.update(eq.first, std::move(singleton));
+	}
+
+	for (const auto& neq:_inequalities) {
+		const auto& domain = domains.domain(neq.first);
+		if (neq.second >= domain.size() || !domain.test(neq.second)) continue;
+
+		TransitionGraph::BitmapT pruned(domain);
+		pruned.reset(neq.second);
+		if (pruned.none()) return false;
+		domains.update(neq.first, std::move(pruned));
+	}
+
+	// Equality is propagated until a fixpoint is reached, as bindings can form chains X = Y = Z
+	for (bool changed = true; changed; ) {
+		changed = false;
+		for (const auto& binding:_bindings) {
+			if (_intersect(domains, binding.first, binding.second)) changed = true;
+			if (_intersect(domains, binding.second, binding.first)) changed = true;
+			if (domains.domain(binding.first).none()) return false;
+		}
+	}
+
+	return true;
+}
+
+} } // namespaces
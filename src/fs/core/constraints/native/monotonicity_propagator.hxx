@@ -0,0 +1,40 @@
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include <fs/core/fs_types.hxx>
+#include <fs/core/languages/fstrips/language_fwd.hxx>
+#include <fs/core/monotonicity.hxx>
+
+namespace fs0 { namespace gecode {
+
+//! A native propagation engine for monotonicity CSPs whose constraints are all of the form X = c, X != c or X = Y,
+//! where X, Y are state variables and c is a constant. Constraints are propagated to arc-consistency directly on the
+//! bitsets of reachable values held by a DomainTracker, without the need to set up any Gecode space.
+//! Arc consistency is complete for this class of constraints: the CSP has a solution iff no domain becomes empty.
+class MonotonicityPropagator {
+public:
+	//! Factory method. Returns null if the given formula contains some constraint that cannot be natively propagated.
+	static std::unique_ptr<MonotonicityPropagator> build(const fs::Formula* formula, const TransitionGraph& monotonicity);
+
+	//! Prune from the given domains the values not supported by the constraints. Only the pruned domains are replaced.
+	//! Returns false iff the domain of some variable becomes empty.
+	bool propagate(DomainTracker& domains) const;
+
+protected:
+	MonotonicityPropagator() = default;
+
+	//! Process a single conjunct of the formula; returns false if it is not supported
+	bool index(const fs::Formula* conjunct, const TransitionGraph& monotonicity);
+
+	//! Constraints X = c and X != c on monotonic state variables, with c given by its index in the domain bitset of X
+	std::vector<std::pair<VariableIdx, unsigned>> _equalities;
+	std::vector<std::pair<VariableIdx, unsigned>> _inequalities;
+
+	//! Constraints X = Y on monotonic state variables
+	std::vector<std::pair<VariableIdx, VariableIdx>> _bindings;
+};
+
+} } // namespaces
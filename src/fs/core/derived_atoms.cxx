@@ -0,0 +1,351 @@
+
+#include <fs/core/derived_atoms.hxx>
+
+#include <fs/core/atom.hxx>
+#include <fs/core/problem_info.hxx>
+#include <fs/core/state.hxx>
+#include <fs/core/languages/fstrips/axioms.hxx>
+#include <fs/core/languages/fstrips/formulae.hxx>
+#include <fs/core/languages/fstrips/terms.hxx>
+#include <fs/core/languages/fstrips/operations/basic.hxx>
+#include <fs/core/utils/binding.hxx>
+#include <fs/core/utils/config.hxx>
+#include <fs/core/utils/printers/helper.hxx>
+
+#include <algorithm>
+#include <functional>
+#include <set>
+
+
+namespace fs0 {
+
+DerivedAtomTable::DerivedAtomTable(const AxiomEvaluator& evaluator) :
+	_evaluator(evaluator),
+	_strata(evaluator._strata.size())
+{}
+
+DerivedAtomTable::~DerivedAtomTable() {
+	for (const auto& slot:_strata) {
+		if (const Stratum* stratum = slot.load(std::memory_order_relaxed)) intrusive_ptr_release(stratum);
+	}
+}
+
+const DerivedAtomTable::Stratum&
+DerivedAtomTable::install(unsigned s, const boost::intrusive_ptr<const Stratum>& stratum) {
+	const Stratum* expected = nullptr;
+	intrusive_ptr_add_ref(stratum.get());
+	if (_strata[s].compare_exchange_strong(expected, stratum.get(), std::memory_order_acq_rel, std::memory_order_acquire)) return *stratum;
+	intrusive_ptr_release(stratum.get());
+	return *expected;
+}
+
+//! The recursive strata that the current thread is computing, whose atoms can be accessed
+//! while iterating to the fixpoint, before the stratum is installed in its table
+struct ComputingStratum {
+	const DerivedAtomTable* table;
+	unsigned stratum;
+	const std::vector<std::vector<bool>>* values;
+};
+static thread_local std::vector<ComputingStratum> computing_strata;
+
+
+//! Collect the references to axioms that occur positively in the given formula, i.e. as atoms p(t) = true or
+//! p(t) != false under an even number of negations. Any other occurrence is conservatively considered negative.
+static void collect_positive_references(const fs::Formula* formula, bool positive, std::set<const fs::AxiomaticTermWrapper*>& result) {
+	if (auto negation = dynamic_cast<const fs::Negation*>(formula)) {
+		for (const fs::Formula* subformula:negation->getSubformulae()) collect_positive_references(subformula, !positive, result);
+
+	} else if (auto open = dynamic_cast<const fs::OpenFormula*>(formula)) {
+		for (const fs::Formula* subformula:open->getSubformulae()) collect_positive_references(subformula, positive, result);
+
+	} else if (auto quantified = dynamic_cast<const fs::QuantifiedFormula*>(formula)) {
+		collect_positive_references(quantified->getSubformula(), positive, result);
+
+	} else if (auto relational = dynamic_cast<const fs::RelationalFormula*>(formula)) {
+		bool eq = relational->symbol() == fs::RelationalFormula::Symbol::EQ;
+		if (!eq && relational->symbol() != fs::RelationalFormula::Symbol::NEQ) return;
+		auto wrapper = dynamic_cast<const fs::AxiomaticTermWrapper*>(relational->lhs());
+		auto constant = dynamic_cast<const fs::Constant*>(relational->rhs());
+		if (!wrapper || !constant) {
+			wrapper = dynamic_cast<const fs::AxiomaticTermWrapper*>(relational->rhs());
+			constant = dynamic_cast<const fs::Constant*>(relational->lhs());
+		}
+		if (!wrapper || !constant) return;
+		object_id value = constant->getValue();
+		if (value != make_object(true) && value != make_object(false)) return;
+		if ((eq == (value == make_object(true))) == positive) result.insert(wrapper);
+	}
+}
+
+AxiomEvaluator::AxiomEvaluator(const std::unordered_map<std::string, const fs::Axiom*>& axioms, const ProblemInfo& info) :
+	_info(info)
+{
+	unsigned max_table_size = Config::instance().getOption<unsigned>("axioms.max_table_size", 10000);
+	for (const auto& it:axioms) {
+		const fs::Axiom* axiom = it.second;
+		AxiomData data{axiom, 0, 0, {}, {}, 1, false};
+		for (TypeIdx type:axiom->getSignature()) {
+			const std::vector<object_id>& objects = info.getTypeObjects(type);
+			std::unordered_map<object_id, unsigned> positions;
+			for (unsigned i = 0; i < objects.size(); ++i) positions.insert(std::make_pair(objects[i], i));
+			data.domains.push_back(&objects);
+			data.positions.push_back(std::move(positions));
+			data.num_ground *= objects.size();
+		}
+		_axioms.push_back(std::move(data));
+	}
+	// Sort the axioms by name, so that the stratification does not depend on the order of the hash map
+	std::sort(_axioms.begin(), _axioms.end(), [](const AxiomData& a, const AxiomData& b) { return a.axiom->getName() < b.axiom->getName(); });
+	// References are resolved by name, since the definitions of the axioms of a copy of the problem
+	// still refer to the axioms of the original problem
+	std::unordered_map<std::string, unsigned> by_name;
+	for (unsigned a = 0; a < _axioms.size(); ++a) {
+		_axiom_idx[_axioms[a].axiom] = a;
+		by_name[_axioms[a].axiom->getName()] = a;
+	}
+
+	// Collect the axioms and the fluent symbols that each axiom definition refers to
+	unsigned num_axioms = _axioms.size();
+	std::vector<std::set<unsigned>> references(num_axioms), negative_references(num_axioms), symbols(num_axioms);
+	std::vector<bool> opaque(num_axioms, false);
+	for (unsigned a = 0; a < num_axioms; ++a) {
+		std::set<const fs::AxiomaticTermWrapper*> positive;
+		collect_positive_references(_axioms[a].axiom->getDefinition(), true, positive);
+
+		for (const fs::LogicalElement* node:fs::all_nodes(*_axioms[a].axiom->getDefinition())) {
+			if (auto wrapper = dynamic_cast<const fs::AxiomaticTermWrapper*>(node)) {
+				auto it = by_name.find(wrapper->getAxiom()->getName());
+				if (it == by_name.end()) throw std::runtime_error(printer() << "Axiom '" << _axioms[a].axiom->getName() << "' refers to unknown axiom '" << wrapper->getAxiom()->getName() << "'");
+				references[a].insert(it->second);
+				if (positive.find(wrapper) == positive.end()) negative_references[a].insert(it->second);
+
+			} else if (auto sv = dynamic_cast<const fs::StateVariable*>(node)) {
+				symbols[a].insert(info.getVariableData(sv->getValue()).first);
+
+			} else if (auto nested = dynamic_cast<const fs::FluentHeadedNestedTerm*>(node)) {
+				symbols[a].insert(nested->getSymbolId());
+
+			} else if (dynamic_cast<const fs::AxiomaticTerm*>(node) || dynamic_cast<const fs::AxiomaticFormula*>(node)) {
+				opaque[a] = true; // Externally-defined elements might depend on any part of the state
+			}
+		}
+	}
+
+	// Stratify the axioms: Tarjan's algorithm yields the strongly connected components of the reference graph
+	// in such an order that every component comes after all the components it refers to
+	std::vector<int> index(num_axioms, -1), lowlink(num_axioms, 0);
+	std::vector<bool> on_stack(num_axioms, false);
+	std::vector<unsigned> stack;
+	int next_index = 0;
+	std::function<void(unsigned)> connect = [&](unsigned a) {
+		index[a] = lowlink[a] = next_index++;
+		stack.push_back(a);
+		on_stack[a] = true;
+		for (unsigned b:references[a]) {
+			if (index[b] < 0) {
+				connect(b);
+				lowlink[a] = std::min(lowlink[a], lowlink[b]);
+			} else if (on_stack[b]) {
+				lowlink[a] = std::min(lowlink[a], index[b]);
+			}
+		}
+		if (lowlink[a] != index[a]) return;
+
+		std::vector<unsigned> component;
+		unsigned b;
+		do {
+			b = stack.back();
+			stack.pop_back();
+			on_stack[b] = false;
+			_axioms[b].stratum = _strata.size();
+			_axioms[b].position = component.size();
+			component.push_back(b);
+		} while (b != a);
+		_recursive.push_back(component.size() > 1 || references[a].count(a) > 0);
+		_strata.push_back(std::move(component));
+	};
+	for (unsigned a = 0; a < num_axioms; ++a) {
+		if (index[a] < 0) connect(a);
+	}
+
+	// The least fixpoint of a recursive stratum is only well-defined if there is no negation through recursion
+	for (unsigned a = 0; a < num_axioms; ++a) {
+		for (unsigned b:negative_references[a]) {
+			if (_axioms[a].stratum == _axioms[b].stratum) {
+				throw std::runtime_error(printer() << "Axiom '" << _axioms[a].axiom->getName() << "' refers negatively to axiom '" << _axioms[b].axiom->getName() << "' through recursion, hence the axioms cannot be stratified");
+			}
+		}
+	}
+
+	// Large non-recursive axioms are evaluated on demand, since the tables of most of them would be mostly unused
+	for (AxiomData& data:_axioms) {
+		data.on_demand = !_recursive[data.stratum] && data.num_ground > max_table_size;
+	}
+
+	// Propagate the symbol dependencies upwards through the strata, which are already in topological order
+	unsigned num_strata = _strata.size();
+	std::vector<std::set<unsigned>> stratum_symbols(num_strata);
+	std::vector<bool> stratum_opaque(num_strata, false);
+	for (unsigned s = 0; s < num_strata; ++s) {
+		for (unsigned a:_strata[s]) {
+			stratum_symbols[s].insert(symbols[a].begin(), symbols[a].end());
+			if (opaque[a]) stratum_opaque[s] = true;
+			for (unsigned b:references[a]) {
+				unsigned t = _axioms[b].stratum;
+				if (t == s) continue;
+				assert(t < s);
+				stratum_symbols[s].insert(stratum_symbols[t].begin(), stratum_symbols[t].end());
+				if (stratum_opaque[t]) stratum_opaque[s] = true;
+			}
+		}
+	}
+
+	_symbol_strata.resize(info.getNumLogicalSymbols());
+	for (unsigned s = 0; s < num_strata; ++s) {
+		for (unsigned symbol:stratum_symbols[s]) _symbol_strata.at(symbol).push_back(s);
+		if (stratum_opaque[s]) _opaque_strata.push_back(s);
+	}
+}
+
+void
+AxiomEvaluator::add_aliases(const std::unordered_map<std::string, const fs::Axiom*>& axioms) {
+	for (unsigned a = 0; a < _axioms.size(); ++a) {
+		auto it = axioms.find(_axioms[a].axiom->getName());
+		if (it != axioms.end()) _axiom_idx[it->second] = a;
+	}
+}
+
+bool
+AxiomEvaluator::value(const State& state, const fs::Axiom& axiom, const std::vector<object_id>& arguments) const {
+	auto it = _axiom_idx.find(&axiom);
+	if (it == _axiom_idx.end()) throw std::runtime_error(printer() << "Unknown axiom '" << axiom.getName() << "'");
+	const AxiomData& data = _axioms[it->second];
+
+	if (!data.on_demand) return stratum_values(state, data.stratum)[data.position][rank(data, arguments)];
+
+	Binding binding;
+	data.axiom->getBindingUnit().update_binding(binding, arguments);
+	return data.axiom->getDefinition()->interpret(state, binding);
+}
+
+DerivedAtomTable&
+AxiomEvaluator::table(const State& state) const {
+	DerivedAtomTable* derived = state._derived.load(std::memory_order_acquire);
+	if (!derived) {
+		auto created = new DerivedAtomTable(*this);
+		intrusive_ptr_add_ref(created);
+		if (state._derived.compare_exchange_strong(derived, created, std::memory_order_acq_rel, std::memory_order_acquire)) {
+			derived = created;
+		} else {
+			intrusive_ptr_release(created); // Some other thread installed a table first
+		}
+	}
+	assert(&derived->_evaluator == this);
+	return *derived;
+}
+
+const std::vector<std::vector<bool>>&
+AxiomEvaluator::stratum_values(const State& state, unsigned stratum) const {
+	DerivedAtomTable& derived = table(state);
+	if (const DerivedAtomTable::Stratum* installed = derived._strata[stratum].load(std::memory_order_acquire)) {
+		return installed->values;
+	}
+	// A stratum that is being computed can only be accessed from itself, while iterating to the fixpoint
+	for (const ComputingStratum& computing:computing_strata) {
+		if (computing.table == &derived && computing.stratum == stratum) return *computing.values;
+	}
+	return derived.install(stratum, compute_stratum(state, derived, stratum)).values;
+}
+
+boost::intrusive_ptr<const DerivedAtomTable::Stratum>
+AxiomEvaluator::compute_stratum(const State& state, const DerivedAtomTable& table, unsigned stratum) const {
+	const std::vector<unsigned>& axioms = _strata[stratum];
+	boost::intrusive_ptr<DerivedAtomTable::Stratum> result(new DerivedAtomTable::Stratum());
+	assert(!_axioms[axioms[0]].on_demand); // The atoms of on-demand axioms are evaluated directly by 'value'
+	for (unsigned a:axioms) result->values.emplace_back(_axioms[a].num_ground, false);
+
+	struct ComputingGuard {
+		ComputingGuard(const ComputingStratum& computing) { computing_strata.push_back(computing); }
+		~ComputingGuard() { computing_strata.pop_back(); }
+	} guard({&table, stratum, &result->values});
+
+	// Non-recursive strata only need one pass. In recursive strata, atoms can only go from false to true,
+	// so only those that are still false need to be reevaluated on each iteration.
+	bool changed = true;
+	while (changed) {
+		changed = false;
+		for (unsigned a:axioms) {
+			const AxiomData& data = _axioms[a];
+			const fs::Formula* definition = data.axiom->getDefinition();
+			std::vector<bool>& values = result->values[data.position];
+			std::vector<unsigned> positions(data.domains.size(), 0);
+			std::vector<object_id> arguments(data.domains.size());
+			Binding binding;
+
+			for (unsigned i = 0; i < data.num_ground; ++i) {
+				if (!values[i]) {
+					for (unsigned p = 0; p < positions.size(); ++p) arguments[p] = data.domains[p]->at(positions[p]);
+					data.axiom->getBindingUnit().update_binding(binding, arguments);
+					if (definition->interpret(state, binding)) {
+						values[i] = true;
+						changed = true;
+					}
+				}
+
+				// Advance to the next tuple of arguments, in the same order used by 'rank'
+				for (int p = positions.size() - 1; p >= 0; --p) {
+					if (++positions[p] < data.domains[p]->size()) break;
+					positions[p] = 0;
+				}
+			}
+		}
+		if (!_recursive[stratum]) break;
+	}
+	return result;
+}
+
+unsigned
+AxiomEvaluator::rank(const AxiomData& data, const std::vector<object_id>& arguments) const {
+	assert(arguments.size() == data.positions.size());
+	unsigned result = 0;
+	for (unsigned p = 0; p < arguments.size(); ++p) {
+		auto it = data.positions[p].find(arguments[p]);
+		if (it == data.positions[p].end()) throw std::runtime_error(printer() << "Argument #" << p << " of axiom '" << data.axiom->getName() << "' out of its domain");
+		result = result * data.domains[p]->size() + it->second;
+	}
+	return result;
+}
+
+boost::intrusive_ptr<DerivedAtomTable>
+AxiomEvaluator::successor(DerivedAtomTable& parent, const std::vector<Atom>& changeset) {
+	const AxiomEvaluator& evaluator = parent._evaluator;
+	std::vector<bool> dirty(evaluator._strata.size(), false);
+	bool affected = false;
+
+	for (unsigned s:evaluator._opaque_strata) {
+		dirty[s] = affected = true;
+	}
+	for (const Atom& atom:changeset) {
+		unsigned symbol = evaluator._info.getVariableData(atom.getVariable()).first;
+		for (unsigned s:evaluator._symbol_strata[symbol]) {
+			dirty[s] = affected = true;
+		}
+	}
+
+	// If no derived atom can have changed, the successor can share the table of the parent,
+	// even if some strata of it have not been computed yet
+	if (!affected) return boost::intrusive_ptr<DerivedAtomTable>(&parent);
+
+	// Strata that have not yet been computed in the parent are left to be computed in the successor
+	boost::intrusive_ptr<DerivedAtomTable> table(new DerivedAtomTable(evaluator));
+	for (unsigned s = 0; s < dirty.size(); ++s) {
+		if (dirty[s]) continue;
+		if (const DerivedAtomTable::Stratum* stratum = parent._strata[s].load(std::memory_order_acquire)) {
+			intrusive_ptr_add_ref(stratum);
+			table->_strata[s].store(stratum, std::memory_order_relaxed);
+		}
+	}
+	return table;
+}
+
+} // namespaces
@@ -0,0 +1,125 @@
+
+#pragma once
+
+#include <fs/core/fs_types.hxx>
+#include <fs/core/languages/fstrips/language_fwd.hxx>
+
+#include <boost/smart_ptr/intrusive_ptr.hpp>
+#include <boost/smart_ptr/intrusive_ref_counter.hpp>
+
+#include <atomic>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace fs0 {
+
+class Atom;
+class AxiomEvaluator;
+class ProblemInfo;
+class State;
+
+//! The values of all ground derived atoms in some state, organized by strata. Each stratum is computed lazily,
+//! the first time that one of its atoms is accessed, and then atomically installed in the table, after which it is
+//! never modified; hence tables can be read from several threads without any locking. Should two threads compute
+//! the same stratum at once, the stratum of the first one to finish is kept. The table of a successor of some state
+//! shares with the table of that state those strata not affected by the changes between the two states. Tables are
+//! shared by all the copies of a state, as well as by those successors reached through changes that affect no axiom.
+class DerivedAtomTable : public boost::intrusive_ref_counter<DerivedAtomTable> {
+	friend class AxiomEvaluator;
+public:
+	explicit DerivedAtomTable(const AxiomEvaluator& evaluator);
+	~DerivedAtomTable();
+
+	DerivedAtomTable(const DerivedAtomTable&) = delete;
+	DerivedAtomTable& operator=(const DerivedAtomTable&) = delete;
+
+protected:
+	//! 'values[i][j]' is the value of the j-th ground atom of the i-th axiom of the stratum
+	struct Stratum : public boost::intrusive_ref_counter<Stratum> {
+		std::vector<std::vector<bool>> values;
+	};
+
+	const AxiomEvaluator& _evaluator;
+
+	//! '_strata[s]' is the s-th stratum, or null if it has not been computed yet. The table holds a reference to each of them.
+	std::vector<std::atomic<const Stratum*>> _strata;
+
+	//! Install the given stratum in the s-th position, unless some other thread installed one first, and return the installed one
+	const Stratum& install(unsigned s, const boost::intrusive_ptr<const Stratum>& stratum);
+};
+
+//! Evaluates the axioms of the problem once per state, through a stratified least fixpoint over all their ground
+//! atoms. Axioms are stratified according to the strongly connected components of the graph of references
+//! between axiom definitions; each stratum is evaluated after all the strata it depends on, and the atoms of
+//! recursive strata are iterated to a fixpoint starting from false, which is sound since recursion through negative
+//! references is rejected. The derived atoms are cached in a table attached to the state. Non-recursive axioms
+//! with more ground atoms than the value of option 'axioms.max_table_size' are instead evaluated atom by atom,
+//! whenever needed. The evaluator can be used from several threads at once.
+class AxiomEvaluator {
+	friend class DerivedAtomTable;
+public:
+	AxiomEvaluator(const std::unordered_map<std::string, const fs::Axiom*>& axioms, const ProblemInfo& info);
+	~AxiomEvaluator() = default;
+
+	AxiomEvaluator(const AxiomEvaluator&) = delete;
+	AxiomEvaluator(AxiomEvaluator&&) = delete;
+	AxiomEvaluator& operator=(const AxiomEvaluator&) = delete;
+	AxiomEvaluator& operator=(AxiomEvaluator&&) = delete;
+
+	//! Evaluate each of the given axioms as the axiom of the evaluator with the same name. The definitions of the
+	//! axioms of a copy of some problem still refer to the axioms of the original problem, but are to be evaluated
+	//! with the evaluator of the copy.
+	void add_aliases(const std::unordered_map<std::string, const fs::Axiom*>& axioms);
+
+	//! Return the value of the ground derived atom 'axiom(arguments)' in the given state
+	bool value(const State& state, const fs::Axiom& axiom, const std::vector<object_id>& arguments) const;
+
+	//! Return the table of derived atoms for a successor of a state with table 'parent', reached through the given
+	//! changeset: the parent table itself if the changeset affects no axiom, or a new table that shares those
+	//! strata of the parent that are not affected.
+	static boost::intrusive_ptr<DerivedAtomTable> successor(DerivedAtomTable& parent, const std::vector<Atom>& changeset);
+
+protected:
+	struct AxiomData {
+		const fs::Axiom* axiom;
+		unsigned stratum;
+		//! The position of the axiom within its stratum
+		unsigned position;
+		//! 'domains[i]' are the possible values of the i-th parameter, and 'positions[i]' maps each of them to its position
+		std::vector<const std::vector<object_id>*> domains;
+		std::vector<std::unordered_map<object_id, unsigned>> positions;
+		unsigned num_ground;
+		//! Whether the ground atoms of the axiom are evaluated one by one, on demand
+		bool on_demand;
+	};
+
+	const ProblemInfo& _info;
+
+	std::vector<AxiomData> _axioms;
+
+	std::unordered_map<const fs::Axiom*, unsigned> _axiom_idx;
+
+	//! The axioms of each stratum, and whether the stratum is recursive
+	std::vector<std::vector<unsigned>> _strata;
+	std::vector<bool> _recursive;
+
+	//! '_symbol_strata[s]' are the strata that (directly or transitively) depend on fluent symbol 's'
+	std::vector<std::vector<unsigned>> _symbol_strata;
+
+	//! The strata that depend on the state in ways we cannot track, e.g. through externally-defined terms
+	std::vector<unsigned> _opaque_strata;
+
+	//! Return the table of the given state, which is created if it has none yet
+	DerivedAtomTable& table(const State& state) const;
+
+	//! Return the values of the given stratum of the given state, which are computed if not available yet
+	const std::vector<std::vector<bool>>& stratum_values(const State& state, unsigned stratum) const;
+
+	boost::intrusive_ptr<const DerivedAtomTable::Stratum> compute_stratum(const State& state, const DerivedAtomTable& table, unsigned stratum) const;
+
+	//! The position of the given ground atom in the table of its axiom
+	unsigned rank(const AxiomData& data, const std::vector<object_id>& arguments) const;
+};
+
+} // namespaces
@@ -0,0 +1,426 @@
+
+#include <fs/core/heuristics/relaxed_plan/unary_relaxed_heuristic.hxx>
+
+#include <fs/core/actions/actions.hxx>
+#include <fs/core/applicability/formula_interpreter.hxx>
+#include <fs/core/languages/fstrips/language.hxx>
+#include <fs/core/problem.hxx>
+#include <fs/core/problem_info.hxx>
+#include <fs/core/state.hxx>
+#include <fs/core/utils/atom_index.hxx>
+#include <fs/core/utils/printers/helper.hxx>
+#include <lapkt/tools/logging.hxx>
+
+#include <algorithm>
+#include <cassert>
+#include <unordered_map>
+
+
+namespace fs0 {
+
+namespace {
+
+//! Helper to compile the ground actions of a problem into unary operators
+class UnaryCompiler {
+public:
+	UnaryCompiler(const AtomIndex& atom_index, const ProblemInfo& info) :
+		_atom_index(atom_index), _info(info), _num_facts(atom_index.size())
+	{}
+
+	struct Operator {
+		unsigned action;
+		unsigned cost;
+		unsigned effect;
+		std::vector<unsigned> pre;
+	};
+
+	//! Add to 'facts' the facts corresponding to the atoms of the given condition. Return false iff the
+	//! condition can never hold, which happens only if it contains an atom X=c which is not indexed
+	bool compile_condition(const fs::Formula* formula, std::vector<unsigned>& facts) {
+		if (!formula || dynamic_cast<const fs::Tautology*>(formula)) return true;
+
+		std::vector<const fs::Formula*> conjuncts{formula};
+		if (const auto* conjunction = dynamic_cast<const fs::Conjunction*>(formula)) conjuncts = conjunction->getSubformulae();
+
+		for (const auto* conjunct:conjuncts) {
+			const auto* eq_atom = dynamic_cast<const fs::EQAtomicFormula*>(conjunct);
+			const auto* neq_atom = dynamic_cast<const fs::NEQAtomicFormula*>(conjunct);
+			const fs::RelationalFormula* atom = eq_atom ? static_cast<const fs::RelationalFormula*>(eq_atom) : neq_atom;
+			const auto* statevar = atom ? dynamic_cast<const fs::StateVariable*>(atom->lhs()) : nullptr;
+			const auto* value = atom ? dynamic_cast<const fs::Constant*>(atom->rhs()) : nullptr;
+			if (!statevar || !value) {
+				// Ignoring the condition only makes the relaxation less informed
+				LPT_DEBUG("cout", "Unary relaxation only accounts for conditions with simple equality atoms, ignoring: " << *conjunct);
+				continue;
+			}
+
+			VariableIdx var = statevar->getValue();
+			object_id val = value->getValue();
+			if (!_atom_index.is_indexed(var, val)) {
+				if (eq_atom) return false;
+				continue; // The atom X!=c always holds
+			}
+
+			AtomIdx fact = _atom_index.to_index(var, val);
+			facts.push_back(eq_atom ? fact : inequality_fact(var, val, fact));
+		}
+		return true;
+	}
+
+	//! Compile the given action into unary operators, one per add effect (or per value of Y, for effects X:=Y)
+	void compile(const GroundAction& action) {
+		std::vector<unsigned> pre;
+		if (!compile_condition(action.getPrecondition(), pre)) return;
+
+		for (const fs::ActionEffect* effect:action.getEffects()) {
+			if (effect->is_del()) continue;
+
+			const auto* lhs = dynamic_cast<const fs::StateVariable*>(effect->lhs());
+			const auto* constant_rhs = dynamic_cast<const fs::Constant*>(effect->rhs());
+			const auto* sv_rhs = dynamic_cast<const fs::StateVariable*>(effect->rhs());
+			if (!lhs || (!constant_rhs && !sv_rhs)) {
+				LPT_DEBUG("cout", "Unary relaxation only accounts for effects X:=c and X:=Y, ignoring: " << *effect);
+				continue;
+			}
+
+			std::vector<unsigned> effect_pre(pre);
+			if (!compile_condition(effect->condition(), effect_pre)) continue;
+
+			VariableIdx var = lhs->getValue();
+			if (constant_rhs) { // The effect has form X := c
+				if (!_atom_index.is_indexed(var, constant_rhs->getValue())) continue;
+				add_operator(action.getId(), 1, _atom_index.to_index(var, constant_rhs->getValue()), effect_pre);
+
+			} else { // The effect has form X := Y, which we compile into one operator per value of Y
+				VariableIdx rhs_var = sv_rhs->getValue();
+				for (object_id value:_info.getVariableObjects(rhs_var)) {
+					if (!_atom_index.is_indexed(var, value) || !_atom_index.is_indexed(rhs_var, value)) continue;
+					std::vector<unsigned> value_pre(effect_pre);
+					value_pre.push_back(_atom_index.to_index(rhs_var, value));
+					add_operator(action.getId(), 1, _atom_index.to_index(var, value), value_pre);
+				}
+			}
+		}
+	}
+
+	unsigned num_facts() const { return _num_facts; }
+	std::vector<Operator>& operators() { return _operators; }
+
+protected:
+	const AtomIndex& _atom_index;
+	const ProblemInfo& _info;
+	unsigned _num_facts;
+	std::vector<Operator> _operators;
+
+	//! The auxiliary facts X!=c, indexed by the atom X=c
+	std::unordered_map<AtomIdx, unsigned> _inequalities;
+
+	void add_operator(unsigned action, unsigned cost, unsigned effect, std::vector<unsigned> pre) {
+		// Repeated preconditions would break the counting of unsatisfied preconditions
+		std::sort(pre.begin(), pre.end());
+		pre.erase(std::unique(pre.begin(), pre.end()), pre.end());
+		_operators.push_back(Operator{action, cost, effect, std::move(pre)});
+	}
+
+	unsigned inequality_fact(VariableIdx var, object_id val, AtomIdx atom) {
+		auto it = _inequalities.find(atom);
+		if (it != _inequalities.end()) return it->second;
+
+		unsigned fact = _num_facts++;
+		_inequalities.emplace(atom, fact);
+		for (object_id other:_info.getVariableObjects(var)) {
+			if (other == val || !_atom_index.is_indexed(var, other)) continue;
+			add_operator(std::numeric_limits<unsigned>::max(), 0, fact, {_atom_index.to_index(var, other)});
+		}
+		return fact;
+	}
+};
+
+} // anonymous namespace
+
+
+UnaryRelaxedHeuristic::Type UnaryRelaxedHeuristic::parse_type(const std::string& name) {
+	if (name == "hmax") return Type::hmax;
+	if (name == "hadd") return Type::hadd;
+	if (name == "hff") return Type::hff;
+	throw std::runtime_error("Unknown unary relaxation heuristic '" + name + "'. Options are: hmax, hadd, hff");
+}
+
+UnaryRelaxedHeuristic::UnaryRelaxedHeuristic(const Problem& problem, Type type, bool incremental) :
+	_problem(problem),
+	_atom_index(problem.get_tuple_index()),
+	_type(type),
+	_incremental(incremental),
+	_unreachable_goal(false),
+	_timestamp(0),
+	_has_reference(false)
+{
+	const auto& actions = problem.getGroundActions();
+
+	UnaryCompiler compiler(_atom_index, ProblemInfo::getInstance());
+	for (const GroundAction* action:actions) compiler.compile(*action);
+	if (!compiler.compile_condition(problem.getGoalConditions(), _goal)) _unreachable_goal = true;
+	std::sort(_goal.begin(), _goal.end());
+	_goal.erase(std::unique(_goal.begin(), _goal.end()), _goal.end());
+
+	_num_facts = compiler.num_facts();
+	const auto& operators = compiler.operators();
+	unsigned num_ops = operators.size();
+
+	// Flatten everything into CSR arrays
+	_op_action.reserve(num_ops); _op_base_cost.reserve(num_ops); _op_effect.reserve(num_ops); _op_num_pre.reserve(num_ops);
+	_op_pre_begin.reserve(num_ops + 1);
+	_fact_ops_begin.assign(_num_facts + 1, 0);
+	for (unsigned op = 0; op < num_ops; ++op) {
+		const auto& unary = operators[op];
+		_op_action.push_back(unary.action);
+		_op_base_cost.push_back(unary.cost);
+		_op_effect.push_back(unary.effect);
+		_op_num_pre.push_back(unary.pre.size());
+		_op_pre_begin.push_back(_op_pre.size());
+		_op_pre.insert(_op_pre.end(), unary.pre.begin(), unary.pre.end());
+		if (unary.pre.empty()) _no_pre_ops.push_back(op);
+		for (unsigned fact:unary.pre) ++_fact_ops_begin[fact + 1];
+	}
+	_op_pre_begin.push_back(_op_pre.size());
+
+	for (unsigned f = 0; f < _num_facts; ++f) _fact_ops_begin[f + 1] += _fact_ops_begin[f];
+	_fact_ops.resize(_fact_ops_begin[_num_facts]);
+	std::vector<unsigned> next(_fact_ops_begin.begin(), _fact_ops_begin.end() - 1);
+	for (unsigned op = 0; op < num_ops; ++op) {
+		for (unsigned fact:operators[op].pre) _fact_ops[next[fact]++] = op;
+	}
+
+	_fact_achievers_begin.assign(_num_facts + 1, 0);
+	for (unsigned op = 0; op < num_ops; ++op) ++_fact_achievers_begin[_op_effect[op] + 1];
+	for (unsigned f = 0; f < _num_facts; ++f) _fact_achievers_begin[f + 1] += _fact_achievers_begin[f];
+	_fact_achievers.resize(num_ops);
+	next.assign(_fact_achievers_begin.begin(), _fact_achievers_begin.end() - 1);
+	for (unsigned op = 0; op < num_ops; ++op) _fact_achievers[next[_op_effect[op]]++] = op;
+
+	_is_goal.assign(_num_facts, false);
+	for (unsigned fact:_goal) _is_goal[fact] = true;
+
+	_fact_cost.resize(_num_facts);
+	_best_supporter.resize(_num_facts);
+	_fact_mark.assign(_num_facts, 0);
+	_action_mark.assign(actions.size(), 0);
+	_op_cost.resize(num_ops);
+	_op_unsat.resize(num_ops);
+
+	LPT_INFO("cout", "Unary relaxation: " << actions.size() << " actions compiled into " << num_ops << " unary operators over "
+	                 << _num_facts << " facts (" << _num_facts - _atom_index.size() << " auxiliary)");
+	if (_incremental) LPT_INFO("cout", "Unary relaxation: costs will be repaired incrementally from the previously evaluated state");
+}
+
+void UnaryRelaxedHeuristic::enqueue(unsigned fact, CostT cost) {
+	if (cost >= _buckets.size()) _buckets.resize(cost + 1);
+	_buckets[cost].push_back(fact);
+}
+
+bool UnaryRelaxedHeuristic::propagate(const State& state) {
+	std::fill(_fact_cost.begin(), _fact_cost.end(), INFTY);
+	std::copy(_op_base_cost.begin(), _op_base_cost.end(), _op_cost.begin());
+	std::copy(_op_num_pre.begin(), _op_num_pre.end(), _op_unsat.begin());
+
+	for (VariableIdx var = 0, n = state.numAtoms(); var < n; ++var) {
+		object_id value = state.getValue(var);
+		if (!_atom_index.is_indexed(var, value)) continue;
+		AtomIdx fact = _atom_index.to_index(var, value);
+		_fact_cost[fact] = 0;
+		_best_supporter[fact] = NO_SUPPORTER;
+		enqueue(fact, 0);
+	}
+
+	for (unsigned op:_no_pre_ops) {
+		unsigned effect = _op_effect[op];
+		if (_op_cost[op] < _fact_cost[effect]) {
+			_fact_cost[effect] = _op_cost[op];
+			_best_supporter[effect] = op;
+			enqueue(effect, _op_cost[op]);
+		}
+	}
+
+	// The costs of all facts are needed to later repair them incrementally, otherwise we stop as soon as all goals are reached
+	unsigned pending_goals = _incremental ? std::numeric_limits<unsigned>::max() : _goal.size();
+	for (CostT cost = 0; cost < _buckets.size() && pending_goals > 0; ++cost) {
+		// The bucket might grow while we process it, hence no iterators or references to it
+		for (std::size_t i = 0; i < _buckets[cost].size() && pending_goals > 0; ++i) {
+			unsigned fact = _buckets[cost][i];
+			if (_fact_cost[fact] < cost) continue; // A stale entry, the fact has already been processed
+			if (_is_goal[fact]) --pending_goals;
+
+			for (unsigned k = _fact_ops_begin[fact], end = _fact_ops_begin[fact + 1]; k < end; ++k) {
+				unsigned op = _fact_ops[k];
+				if (_type == Type::hmax) _op_cost[op] = std::max(_op_cost[op], cost + _op_base_cost[op]);
+				else _op_cost[op] += cost;
+
+				if (--_op_unsat[op] > 0) continue;
+
+				unsigned effect = _op_effect[op];
+				if (_op_cost[op] < _fact_cost[effect]) {
+					_fact_cost[effect] = _op_cost[op];
+					_best_supporter[effect] = op;
+					enqueue(effect, _op_cost[op]);
+				}
+			}
+		}
+	}
+
+	for (auto& bucket:_buckets) bucket.clear(); // Clear any leftover, keeping the storage
+	return _incremental ? goals_reached() : pending_goals == 0;
+}
+
+bool UnaryRelaxedHeuristic::goals_reached() const {
+	for (unsigned fact:_goal) {
+		if (_fact_cost[fact] == INFTY) return false;
+	}
+	return true;
+}
+
+UnaryRelaxedHeuristic::CostT UnaryRelaxedHeuristic::operator_cost(unsigned op) const {
+	CostT cost = 0;
+	for (unsigned k = _op_pre_begin[op], end = _op_pre_begin[op + 1]; k < end; ++k) {
+		CostT pre = _fact_cost[_op_pre[k]];
+		if (pre == INFTY) return INFTY;
+		cost = (_type == Type::hmax) ? std::max(cost, pre) : cost + pre;
+	}
+	return cost + _op_base_cost[op];
+}
+
+void UnaryRelaxedHeuristic::update_reference(const State& state) {
+	_reference.resize(state.numAtoms());
+	for (VariableIdx var = 0, n = state.numAtoms(); var < n; ++var) _reference[var] = state.getValue(var);
+	_has_reference = true;
+}
+
+bool UnaryRelaxedHeuristic::repair(const State& state) {
+	// Collect the facts that hold in the reference state but not in the new one, and vice versa
+	_stack.clear();
+	_added.clear();
+	for (VariableIdx var = 0, n = state.numAtoms(); var < n; ++var) {
+		object_id value = state.getValue(var);
+		if (value == _reference[var]) continue;
+		if (_atom_index.is_indexed(var, _reference[var])) _stack.push_back(_atom_index.to_index(var, _reference[var]));
+		if (_atom_index.is_indexed(var, value)) _added.push_back(_atom_index.to_index(var, value));
+		_reference[var] = value;
+	}
+
+	// Deleted facts can only increase the costs of those facts whose best supporters depend, transitively, on them.
+	// We mark all of them as affected, and reset their costs.
+	++_timestamp;
+	_affected.clear();
+	while (!_stack.empty()) {
+		unsigned fact = _stack.back();
+		_stack.pop_back();
+		if (_fact_mark[fact] == _timestamp) continue;
+		_fact_mark[fact] = _timestamp;
+		_affected.push_back(fact);
+
+		for (unsigned k = _fact_ops_begin[fact], end = _fact_ops_begin[fact + 1]; k < end; ++k) {
+			unsigned op = _fact_ops[k];
+			unsigned effect = _op_effect[op];
+			if (_best_supporter[effect] == op && _fact_mark[effect] != _timestamp) _stack.push_back(effect);
+		}
+	}
+	for (unsigned fact:_affected) _fact_cost[fact] = INFTY;
+
+	// The new cost estimate of each affected fact is given by its best achiever among those not affected
+	for (unsigned fact:_affected) {
+		for (unsigned k = _fact_achievers_begin[fact], end = _fact_achievers_begin[fact + 1]; k < end; ++k) {
+			unsigned op = _fact_achievers[k];
+			CostT cost = operator_cost(op);
+			if (cost < _fact_cost[fact]) {
+				_fact_cost[fact] = cost;
+				_best_supporter[fact] = op;
+			}
+		}
+		if (_fact_cost[fact] != INFTY) enqueue(fact, _fact_cost[fact]);
+	}
+
+	// Added facts, in turn, can only decrease costs
+	for (unsigned fact:_added) {
+		_fact_cost[fact] = 0;
+		_best_supporter[fact] = NO_SUPPORTER;
+		enqueue(fact, 0);
+	}
+
+	// Finally, propagate all changes in order of increasing cost. All queued facts have a cost that is an upper bound
+	// of their actual cost, and any other fact is consistent with the costs of its achievers that have not changed
+	for (CostT cost = 0; cost < _buckets.size(); ++cost) {
+		for (std::size_t i = 0; i < _buckets[cost].size(); ++i) {
+			unsigned fact = _buckets[cost][i];
+			if (_fact_cost[fact] < cost) continue; // A stale entry
+
+			for (unsigned k = _fact_ops_begin[fact], end = _fact_ops_begin[fact + 1]; k < end; ++k) {
+				unsigned op = _fact_ops[k];
+				unsigned effect = _op_effect[op];
+				if (_fact_cost[effect] <= cost) continue; // The operator cannot improve the effect
+				CostT op_cost = operator_cost(op);
+				if (op_cost < _fact_cost[effect]) {
+					_fact_cost[effect] = op_cost;
+					_best_supporter[effect] = op;
+					enqueue(effect, op_cost);
+				}
+			}
+		}
+		_buckets[cost].clear();
+	}
+	return goals_reached();
+}
+
+long UnaryRelaxedHeuristic::extract_relaxed_plan() {
+	++_timestamp;
+	long cost = 0;
+
+	_stack.assign(_goal.begin(), _goal.end());
+	while (!_stack.empty()) {
+		unsigned fact = _stack.back();
+		_stack.pop_back();
+		if (_fact_mark[fact] == _timestamp || _fact_cost[fact] == 0) continue;
+		_fact_mark[fact] = _timestamp;
+
+		unsigned op = _best_supporter[fact];
+		unsigned action = _op_action[op];
+		if (action != NO_ACTION && _action_mark[action] != _timestamp) {
+			_action_mark[action] = _timestamp;
+			++cost;
+		}
+		_stack.insert(_stack.end(), _op_pre.begin() + _op_pre_begin[op], _op_pre.begin() + _op_pre_begin[op + 1]);
+	}
+	return cost;
+}
+
+long UnaryRelaxedHeuristic::evaluate(const State& state) {
+	if (_problem.getGoalSatManager().satisfied(state)) return 0; // The state is a goal
+	if (_unreachable_goal) return -1;
+
+	bool reachable;
+	if (_incremental && _has_reference) {
+		reachable = repair(state);
+#ifdef DEBUG
+		// Check the repaired costs against those computed from scratch, keeping the repaired supporters
+		std::vector<CostT> repaired_cost(_fact_cost);
+		std::vector<unsigned> repaired_supporter(_best_supporter);
+		bool reachable_from_scratch = propagate(state);
+		assert(reachable == reachable_from_scratch);
+		assert(_fact_cost == repaired_cost);
+		_best_supporter.swap(repaired_supporter);
+#endif
+	} else {
+		reachable = propagate(state);
+		if (_incremental) update_reference(state);
+	}
+	if (!reachable) return -1;
+
+	if (_type == Type::hff) return extract_relaxed_plan();
+
+	long h = 0;
+	for (unsigned fact:_goal) {
+		if (_type == Type::hmax) h = std::max<long>(h, _fact_cost[fact]);
+		else h += _fact_cost[fact];
+	}
+	return h;
+}
+
+} // namespaces
@@ -0,0 +1,134 @@
+
+#pragma once
+
+#include <fs/core/fs_types.hxx>
+#include <fs/core/languages/fstrips/language_fwd.hxx>
+
+#include <limits>
+#include <string>
+#include <vector>
+
+namespace fs0 {
+
+class AtomIndex;
+class GroundAction;
+class Problem;
+class ProblemInfo;
+class State;
+
+//! A delete-free relaxation heuristic (h_max, h_add or h_FF) for ground problems, computed over a compilation of
+//! the ground actions into unary operators, i.e. operators with a single add effect. Each operator keeps a counter of
+//! its unsatisfied preconditions, and costs are propagated through a bucket-based Dijkstra exploration over flat arrays
+//! that are allocated once and reused across evaluations. The h_FF relaxed plan is extracted from the best supporters
+//! of the h_add costs. Only preconditions, goals and effect conditions that are conjunctions of atoms X=c and X!=c, and
+//! effects of the form X:=c and X:=Y, are compiled; the rest are ignored, which still yields a relaxation.
+//! In incremental mode, the costs of all facts are kept between evaluations, and the costs for a new state are
+//! obtained by repairing those of the previously evaluated state (typically a sibling or the parent of the new one):
+//! the facts whose best supporters depend on deleted atoms are reset, and the changes are then propagated Dijkstra-style,
+//! in the manner of incremental shortest-path algorithms.
+class UnaryRelaxedHeuristic {
+public:
+	enum class Type {hmax, hadd, hff};
+
+	//! Parse the type of heuristic from its name: "hmax", "hadd" or "hff"
+	static Type parse_type(const std::string& name);
+
+	UnaryRelaxedHeuristic(const Problem& problem, Type type, bool incremental);
+	~UnaryRelaxedHeuristic() = default;
+
+	UnaryRelaxedHeuristic(const UnaryRelaxedHeuristic&) = delete;
+	UnaryRelaxedHeuristic(UnaryRelaxedHeuristic&&) = default;
+	UnaryRelaxedHeuristic& operator=(const UnaryRelaxedHeuristic&) = delete;
+	UnaryRelaxedHeuristic& operator=(UnaryRelaxedHeuristic&&) = delete;
+
+	//! Return the heuristic value of the given state, or -1 if the goal is unreachable in the relaxation
+	long evaluate(const State& state);
+
+protected:
+	using CostT = unsigned;
+	static const CostT INFTY = std::numeric_limits<CostT>::max();
+
+	//! The action of those auxiliary operators that do not come from any action
+	static const unsigned NO_ACTION = std::numeric_limits<unsigned>::max();
+
+	//! The best supporter of those facts that hold in the state being evaluated
+	static const unsigned NO_SUPPORTER = std::numeric_limits<unsigned>::max();
+
+	const Problem& _problem;
+
+	const AtomIndex& _atom_index;
+
+	const Type _type;
+
+	//! Whether to repair the costs of the previously evaluated state instead of computing them from scratch
+	const bool _incremental;
+
+	//! Facts are the atoms of the problem, indexed as in the atom index, followed by one auxiliary fact
+	//! for each atom X!=c that appears in some condition, achieved by the facts X=d, d != c
+	unsigned _num_facts;
+
+	//! The operators, one entry per operator
+	std::vector<unsigned> _op_action;
+	std::vector<CostT> _op_base_cost;
+	std::vector<unsigned> _op_effect;
+	std::vector<unsigned> _op_num_pre;
+
+	//! The operators that have no precondition at all
+	std::vector<unsigned> _no_pre_ops;
+
+	//! The operators that have each fact as a precondition, in CSR format:
+	//! those of fact f are '_fact_ops[_fact_ops_begin[f]]' to '_fact_ops[_fact_ops_begin[f+1]-1]'
+	std::vector<unsigned> _fact_ops_begin;
+	std::vector<unsigned> _fact_ops;
+
+	//! The preconditions of each operator, in CSR format as well
+	std::vector<unsigned> _op_pre_begin;
+	std::vector<unsigned> _op_pre;
+
+	//! The operators that achieve each fact, in CSR format, used only by the incremental repair
+	std::vector<unsigned> _fact_achievers_begin;
+	std::vector<unsigned> _fact_achievers;
+
+	//! The facts of the goal. If some goal atom is not in the atom index, the goal is unreachable
+	std::vector<unsigned> _goal;
+	std::vector<bool> _is_goal;
+	bool _unreachable_goal;
+
+	//! Scratch data, reused across evaluations to avoid allocations
+	std::vector<CostT> _fact_cost;
+	std::vector<unsigned> _best_supporter;
+	std::vector<CostT> _op_cost;
+	std::vector<unsigned> _op_unsat;
+	std::vector<std::vector<unsigned>> _buckets;
+	std::vector<unsigned> _fact_mark;
+	std::vector<unsigned> _action_mark;
+	std::vector<unsigned> _stack;
+	unsigned _timestamp;
+
+	//! The values of the state whose costs are currently stored, in incremental mode
+	bool _has_reference;
+	std::vector<object_id> _reference;
+	std::vector<unsigned> _added;
+	std::vector<unsigned> _affected;
+
+	//! Run the Dijkstra-like cost propagation from the given state. Return false iff some goal is unreachable.
+	bool propagate(const State& state);
+
+	//! Repair the costs of the reference state so that they become those of the given state, which becomes
+	//! the new reference. Return false iff some goal is unreachable.
+	bool repair(const State& state);
+
+	void update_reference(const State& state);
+
+	//! The cost of the given operator according to the current costs of its preconditions
+	CostT operator_cost(unsigned op) const;
+
+	bool goals_reached() const;
+
+	//! Extract a relaxed plan from the best supporters and return the number of different actions in it
+	long extract_relaxed_plan();
+
+	void enqueue(unsigned fact, CostT cost);
+};
+
+} // namespaces
@@ -2,6 +2,9 @@
 
 #include <fs/core/problem.hxx>
 #include <fs/core/languages/fstrips/formulae.hxx>
+#include <fs/core/languages/fstrips/terms.hxx>
+#include <fs/core/atom.hxx>
+#include <fs/core/state.hxx>
 
 #include <fs/core/heuristics/unsat_goal_atoms.hxx>
 #include <fs/core/languages/fstrips/complex_existential_formula.hxx>
@@ -9,10 +12,45 @@
 namespace fs0 {
 
 UnsatisfiedGoalAtomsCounter::UnsatisfiedGoalAtomsCounter(const fs::Formula* formula, const AtomIndex& atomidx) :
-	_formula_atoms(extract_formula_components(formula, atomidx))
-{}
+	_formula_atoms(extract_formula_components(formula, atomidx)),
+	_atomic(true)
+{
+	for (const auto& component:_formula_atoms) {
+		if (dynamic_cast<const fs::Tautology*>(component.get())) continue;
+
+		const auto* atom = dynamic_cast<const fs::RelationalFormula*>(component.get());
+		const auto* lhs = atom ? dynamic_cast<const fs::StateVariable*>(atom->lhs()) : nullptr;
+		const auto* rhs = atom ? dynamic_cast<const fs::Constant*>(atom->rhs()) : nullptr;
+		bool eq = atom && atom->symbol() == fs::RelationalFormula::Symbol::EQ;
+		bool neq = atom && atom->symbol() == fs::RelationalFormula::Symbol::NEQ;
+		if (!lhs || !rhs || (!eq && !neq)) {
+			_atomic = false;
+			break;
+		}
+		_atoms.push_back(GoalAtom{lhs->getValue(), rhs->getValue(), neq});
+	}
+
+	if (!_atomic) {
+		_atoms.clear();
+		return;
+	}
+
+	for (unsigned i = 0; i < _atoms.size(); ++i) {
+		VariableIdx var = _atoms[i].variable;
+		if (var >= _variable_atoms.size()) _variable_atoms.resize(var + 1);
+		_variable_atoms[var].push_back(i);
+	}
+}
 
 unsigned UnsatisfiedGoalAtomsCounter::evaluate(const State& state) const {
+	if (_atomic) {
+		unsigned unsatisfied = 0;
+		for (const auto& atom:_atoms) {
+			if (!atom.holds(state.getValue(atom.variable))) ++unsatisfied;
+		}
+		return unsatisfied;
+	}
+
     unsigned unsatisfied = 0;
 	for (const auto& condition:_formula_atoms) {
 		if (!condition->interpret(state)) ++unsatisfied;
@@ -20,6 +58,34 @@ unsigned UnsatisfiedGoalAtomsCounter::evaluate(const State& state) const {
 	return unsatisfied;
 }
 
+unsigned UnsatisfiedGoalAtomsCounter::evaluate(const State& state, const State& parent, unsigned parent_unsatisfied, const std::vector<Atom>& changeset) const {
+	if (!_atomic) return evaluate(state);
+
+	unsigned unsatisfied = parent_unsatisfied;
+	for (std::size_t i = 0; i < changeset.size(); ++i) {
+		VariableIdx var = changeset[i].getVariable();
+		if (var >= _variable_atoms.size() || _variable_atoms[var].empty()) continue;
+
+		// The same variable might appear more than once in the changeset, but we need to account for it only once
+		bool repeated = false;
+		for (std::size_t j = 0; j < i && !repeated; ++j) repeated = (changeset[j].getVariable() == var);
+		if (repeated) continue;
+
+		const object_id& before = parent.getValue(var);
+		const object_id& after = state.getValue(var);
+		if (before == after) continue;
+
+		for (unsigned idx:_variable_atoms[var]) {
+			const GoalAtom& atom = _atoms[idx];
+			bool held = atom.holds(before), holds = atom.holds(after);
+			if (held && !holds) ++unsatisfied;
+			else if (!held && holds) --unsatisfied;
+		}
+	}
+	assert(unsatisfied == evaluate(state));
+	return unsatisfied;
+}
+
 
 std::vector<std::shared_ptr<const fs::Formula>>
 extract_formula_components(const fs::Formula* formula, const AtomIndex& atomidx) {
@@ -1,17 +1,23 @@
 
 #pragma once
 
+#include <fs/core/fs_types.hxx>
 #include <fs/core/languages/fstrips/language_fwd.hxx>
 #include <vector>
 #include <memory>
 
 namespace fs0 {
 
+class Atom;
 class Problem;
+class State;
 
 std::vector<std::shared_ptr<const fs::Formula>> extract_formula_components(const fs::Formula* formula, const AtomIndex&);
 
-//! The heuristic value of any given state is the number of unsatisfied goal conditions (atoms) on that state
+//! The heuristic value of any given state is the number of unsatisfied goal conditions (atoms) on that state.
+//! When the goal is a plain conjunction of atoms X=c and X!=c, the count of a state can be updated incrementally
+//! from that of its parent, looking only at the goal atoms over the variables changed by the action, and the
+//! state is a goal iff the count is zero.
 class UnsatisfiedGoalAtomsCounter {
 public:
 	explicit UnsatisfiedGoalAtomsCounter(const fs::Formula* formula, const AtomIndex&);
@@ -20,8 +26,30 @@ public:
 	//! The actual evaluation of the heuristic value for any given non-relaxed state s.
 	unsigned evaluate(const State& state) const;
 
+	//! The evaluation of a state that results from applying the given changeset to the given parent state, whose
+	//! number of unsatisfied goal conditions is 'parent_unsatisfied'
+	unsigned evaluate(const State& state, const State& parent, unsigned parent_unsatisfied, const std::vector<Atom>& changeset) const;
+
+	//! Whether the goal is a plain conjunction of atoms, in which case a state is a goal iff it has no unsatisfied atom
+	bool is_atomic() const { return _atomic; }
+
 protected:
 	const std::vector<std::shared_ptr<const fs::Formula>> _formula_atoms;
+
+	//! A goal atom X=c, or X!=c if negated
+	struct GoalAtom {
+		VariableIdx variable;
+		object_id value;
+		bool negated;
+
+		bool holds(const object_id& val) const { return (val == value) != negated; }
+	};
+
+	bool _atomic;
+
+	//! The goal atoms, if the goal is atomic, and the indexes of the goal atoms over each state variable
+	std::vector<GoalAtom> _atoms;
+	std::vector<std::vector<unsigned>> _variable_atoms;
 };
 
 } // namespaces
@@ -4,6 +4,7 @@
 #include <fs/core/languages/fstrips/terms.hxx>
 #include <fs/core/languages/fstrips/builtin.hxx>
 #include <fs/core/languages/fstrips/axioms.hxx>
+#include <fs/core/languages/fstrips/query_plan.hxx>
 #include <fs/core/problem.hxx>
 #include <fs/core/utils/utils.hxx>
 #include <fs/core/state.hxx>
@@ -194,15 +195,26 @@ interpret(const State& state, Binding& binding) const {
 	return !_subformulae[0]->interpret(state, binding);
 }
 
+QuantifiedFormula::QuantifiedFormula(const std::vector<const BoundVariable*>& variables, const Formula* subformula) :
+	_variables(variables), _subformula(subformula), _plan(nullptr), _plan_compiled()
+{}
+
 QuantifiedFormula::~QuantifiedFormula() {
 	delete _subformula;
 	for (auto ptr:_variables) delete ptr;
 }
 
 QuantifiedFormula::QuantifiedFormula(const QuantifiedFormula& other) :
-_variables(Utils::clone(other._variables)), _subformula(other._subformula->clone())
+_variables(Utils::clone(other._variables)), _subformula(other._subformula->clone()), _plan(nullptr), _plan_compiled()
 {}
 
+const QueryPlan* QuantifiedFormula::get_plan(bool universal) const {
+	std::call_once(_plan_compiled, [this, universal]() {
+		_plan.reset(QueryPlan::compile(_variables, *_subformula, universal, ProblemInfo::getInstance()));
+	});
+	return _plan.get();
+}
+
 //! Prints a representation of the object to the given stream.
 std::ostream& QuantifiedFormula::print(std::ostream& os, const fs0::ProblemInfo& info) const {
 	os << name() << " ";
@@ -221,6 +233,7 @@ bool ExistentiallyQuantifiedFormula::interpret(const PartialAssignment& assignme
 
 bool ExistentiallyQuantifiedFormula::interpret(const State& state, Binding& binding) const {
 	assert(binding.size()==0); // ATM we do not allow for nested quantifications
+	if (const QueryPlan* plan = get_plan(false)) return plan->find(state, binding, *_subformula, true);
 	return interpret_rec(state, binding, 0);
 }
 
@@ -245,6 +258,8 @@ bool UniversallyQuantifiedFormula::interpret(const PartialAssignment& assignment
 }
 
 bool UniversallyQuantifiedFormula::interpret(const State& state, Binding& binding) const {
+	// The formula holds iff no binding makes the subformula false
+	if (const QueryPlan* plan = get_plan(true)) return !plan->find(state, binding, *_subformula, false);
 	return interpret_rec(state, binding, 0);
 }
 
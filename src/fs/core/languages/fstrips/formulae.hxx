@@ -2,6 +2,8 @@
 #pragma once
 
 #include <iostream>
+#include <memory>
+#include <mutex>
 
 #include <fs/core/languages/fstrips/language_fwd.hxx>
 #include <fs/core/languages/fstrips/base.hxx>
@@ -18,6 +20,7 @@ namespace fs0::language::fstrips {
 
 class Term;
 class BoundVariable;
+class QueryPlan;
 class AtomicFormula;
 class Conjunction;
 class ExistentiallyQuantifiedFormula;
@@ -243,7 +246,7 @@ public:
 //! A formula quantified by at least one variable
 class QuantifiedFormula : public Formula {
 public:
-	QuantifiedFormula(const std::vector<const BoundVariable*>& variables, const Formula* subformula) : _variables(variables), _subformula(subformula) {}
+	QuantifiedFormula(const std::vector<const BoundVariable*>& variables, const Formula* subformula);
 
 	virtual ~QuantifiedFormula();
 
@@ -267,6 +270,13 @@ protected:
 
 	//! ATM we only allow quantification of conjunctions
 	const Formula* _subformula;
+
+	//! The index-driven plan to enumerate the bindings of the variables, compiled on first use, or null if there is none.
+	//! The compilation happens only once even if the formula is first interpreted from several threads at once.
+	mutable std::unique_ptr<const QueryPlan> _plan;
+	mutable std::once_flag _plan_compiled;
+
+	const QueryPlan* get_plan(bool universal) const;
 };
 
 //! A formula quantified by at least one existential variable
@@ -0,0 +1,212 @@
+
+#include <fs/core/languages/fstrips/query_plan.hxx>
+#include <fs/core/languages/fstrips/formulae.hxx>
+#include <fs/core/languages/fstrips/terms.hxx>
+#include <fs/core/problem_info.hxx>
+#include <fs/core/state.hxx>
+#include <fs/core/utils/binding.hxx>
+
+#include <unordered_set>
+
+
+namespace fs0::language::fstrips {
+
+//! Build the generator that corresponds to the given element of the subformula, if it is an atom p(t_1, ..., t_n) with
+//! the given polarity, where p is a predicate symbol, each t_i is a constant or a variable, and some t_i is quantified.
+static bool build_generator(const Formula* element, bool positive, const std::vector<const BoundVariable*>& variables, const ProblemInfo& info, std::vector<int>& slots, std::vector<const Term*>& fixed, unsigned& symbol, bool& fluent) {
+	auto relational = dynamic_cast<const RelationalFormula*>(element);
+	if (!relational) return false;
+	bool eq = relational->symbol() == RelationalFormula::Symbol::EQ;
+	if (!eq && relational->symbol() != RelationalFormula::Symbol::NEQ) return false;
+
+	auto nested = dynamic_cast<const NestedTerm*>(relational->lhs());
+	auto constant = dynamic_cast<const Constant*>(relational->rhs());
+	if (!nested || !constant) {
+		nested = dynamic_cast<const NestedTerm*>(relational->rhs());
+		constant = dynamic_cast<const Constant*>(relational->lhs());
+	}
+	if (!nested || !constant) return false;
+
+	if (dynamic_cast<const FluentHeadedNestedTerm*>(nested)) fluent = true;
+	else if (dynamic_cast<const UserDefinedStaticTerm*>(nested)) fluent = false;
+	else return false;
+
+	symbol = nested->getSymbolId();
+	if (!info.isPredicate(symbol)) return false;
+
+	// The atom is positive iff it reads p(t) = true or p(t) != false
+	object_id value = constant->getValue();
+	if (value != make_object(true) && value != make_object(false)) return false;
+	if ((eq == (value == make_object(true))) != positive) return false;
+
+	slots.clear();
+	fixed.clear();
+	bool quantified = false;
+	for (const Term* subterm:nested->getSubterms()) {
+		int slot = -1;
+		if (auto variable = dynamic_cast<const BoundVariable*>(subterm)) {
+			for (unsigned i = 0; i < variables.size(); ++i) {
+				if (variables[i]->getVariableId() == variable->getVariableId()) slot = i;
+			}
+		} else if (!dynamic_cast<const Constant*>(subterm)) {
+			return false;
+		}
+		quantified = quantified || slot >= 0;
+		slots.push_back(slot);
+		fixed.push_back(slot < 0 ? subterm : nullptr);
+	}
+	return quantified;
+}
+
+//! Whether the given tuple of arguments is compatible with the types of the quantified variables and with the constants of the atom
+static bool compatible(const std::vector<object_id>& tuple, const std::vector<int>& slots, const std::vector<const Term*>& fixed, const std::vector<std::unordered_set<object_id>>& domains) {
+	for (unsigned i = 0; i < tuple.size(); ++i) {
+		if (slots[i] >= 0) {
+			if (domains[slots[i]].find(tuple[i]) == domains[slots[i]].end()) return false;
+		} else if (auto constant = dynamic_cast<const Constant*>(fixed[i])) {
+			if (constant->getValue() != tuple[i]) return false;
+		}
+	}
+	return true;
+}
+
+QueryPlan*
+QueryPlan::compile(const std::vector<const BoundVariable*>& variables, const Formula& subformula, bool universal, const ProblemInfo& info) {
+	std::vector<const Formula*> elements{&subformula};
+	if (!universal && dynamic_cast<const Conjunction*>(&subformula)) elements = static_cast<const Conjunction&>(subformula).getSubformulae();
+	if (universal && dynamic_cast<const Disjunction*>(&subformula)) elements = static_cast<const Disjunction&>(subformula).getSubformulae();
+
+	std::vector<std::unordered_set<object_id>> domains;
+	for (const BoundVariable* variable:variables) {
+		const std::vector<object_id>& objects = info.getTypeObjects(variable->getType());
+		domains.emplace_back(objects.begin(), objects.end());
+	}
+
+	// Build one candidate generator per suitable atom, along with its candidate tuples
+	std::vector<Generator> candidates;
+	for (const Formula* element:elements) {
+		Generator generator;
+		if (!build_generator(element, !universal, variables, info, generator.slots, generator.fixed, generator.symbol, generator.fluent)) continue;
+
+		const SymbolData& data = info.getSymbolData(generator.symbol);
+		if (generator.fluent) {
+			for (VariableIdx variable:data.getVariables()) {
+				const std::vector<object_id>& tuple = info.getVariableData(variable).second;
+				if (!compatible(tuple, generator.slots, generator.fixed, domains)) continue;
+				generator.tuples.push_back(tuple);
+				generator.variables.push_back(variable);
+			}
+
+		} else {
+			// Index the extension of the static predicate by enumerating all tuples of its signature, if not too many
+			std::vector<const std::vector<object_id>*> signature;
+			std::size_t size = 1;
+			for (TypeIdx type:data.getSignature()) {
+				signature.push_back(&info.getTypeObjects(type));
+				size *= signature.back()->size();
+				if (size > MAX_STATIC_TUPLES) break;
+			}
+			if (size > MAX_STATIC_TUPLES) continue;
+
+			const Function& function = data.getFunction();
+			std::vector<object_id> tuple(signature.size());
+			std::vector<unsigned> positions(signature.size(), 0);
+			for (std::size_t k = 0; k < size; ++k) {
+				for (unsigned i = 0; i < signature.size(); ++i) tuple[i] = signature[i]->at(positions[i]);
+				if (compatible(tuple, generator.slots, generator.fixed, domains) && function(tuple) == make_object(true)) {
+					generator.tuples.push_back(tuple);
+				}
+				for (int i = signature.size() - 1; i >= 0; --i) {
+					if (++positions[i] < signature[i]->size()) break;
+					positions[i] = 0;
+				}
+			}
+		}
+		candidates.push_back(std::move(generator));
+	}
+
+	// Greedily pick as generators the candidates with the fewest tuples among those that bind some new variable
+	std::vector<Generator> generators;
+	std::vector<bool> bound(variables.size(), false);
+	while (true) {
+		int best = -1;
+		for (unsigned c = 0; c < candidates.size(); ++c) {
+			bool binds = false;
+			for (int slot:candidates[c].slots) binds = binds || (slot >= 0 && !bound[slot]);
+			if (binds && (best < 0 || candidates[c].tuples.size() < candidates[best].tuples.size())) best = c;
+		}
+		if (best < 0) break;
+
+		for (int slot:candidates[best].slots) if (slot >= 0) bound[slot] = true;
+		generators.push_back(std::move(candidates[best]));
+		candidates.erase(candidates.begin() + best);
+	}
+
+	if (generators.empty()) return nullptr;
+	return new QueryPlan(variables, std::move(generators));
+}
+
+QueryPlan::QueryPlan(const std::vector<const BoundVariable*>& variables, std::vector<Generator>&& generators) :
+	_variables(variables), _generators(std::move(generators))
+{}
+
+bool
+QueryPlan::find(const State& state, Binding& binding, const Formula& subformula, bool expected) const {
+	std::vector<bool> bound(_variables.size(), false);
+	return find_rec(state, binding, subformula, expected, 0, bound);
+}
+
+bool
+QueryPlan::find_rec(const State& state, Binding& binding, const Formula& subformula, bool expected, unsigned level, std::vector<bool>& bound) const {
+	if (level == _generators.size()) return enumerate(state, binding, subformula, expected, 0, bound);
+
+	const Generator& generator = _generators[level];
+	unsigned arity = generator.slots.size();
+
+	// Fixed arguments do not depend on the variables bound by the plan, hence can be interpreted only once
+	std::vector<object_id> fixed(arity);
+	for (unsigned i = 0; i < arity; ++i) {
+		if (generator.slots[i] < 0) fixed[i] = generator.fixed[i]->interpret(state, binding);
+	}
+
+	std::vector<unsigned> newly_bound;
+	for (unsigned k = 0; k < generator.tuples.size(); ++k) {
+		if (generator.fluent && state.getValue(generator.variables[k]) != make_object(true)) continue;
+
+		const std::vector<object_id>& tuple = generator.tuples[k];
+		bool consistent = true;
+		newly_bound.clear();
+		for (unsigned i = 0; i < arity && consistent; ++i) {
+			int slot = generator.slots[i];
+			if (slot < 0) {
+				consistent = fixed[i] == tuple[i];
+			} else if (bound[slot]) {
+				consistent = binding.value(_variables[slot]->getVariableId()) == tuple[i];
+			} else {
+				binding.set(_variables[slot]->getVariableId(), tuple[i]);
+				bound[slot] = true;
+				newly_bound.push_back(slot);
+			}
+		}
+
+		bool found = consistent && find_rec(state, binding, subformula, expected, level + 1, bound);
+		for (unsigned slot:newly_bound) bound[slot] = false;
+		if (found) return true;
+	}
+	return false;
+}
+
+bool
+QueryPlan::enumerate(const State& state, Binding& binding, const Formula& subformula, bool expected, unsigned i, std::vector<bool>& bound) const {
+	if (i == _variables.size()) return subformula.interpret(state, binding) == expected;
+	if (bound[i]) return enumerate(state, binding, subformula, expected, i + 1, bound);
+
+	const BoundVariable* variable = _variables[i];
+	for (const object_id& elem:ProblemInfo::getInstance().getTypeObjects(variable->getType())) {
+		binding.set(variable->getVariableId(), elem);
+		if (enumerate(state, binding, subformula, expected, i + 1, bound)) return true;
+	}
+	return false;
+}
+
+} // namespaces
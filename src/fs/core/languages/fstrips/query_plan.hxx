@@ -0,0 +1,65 @@
+
+#pragma once
+
+#include <fs/core/fs_types.hxx>
+
+#include <vector>
+
+namespace fs0 {
+class State;
+class ProblemInfo;
+class Binding;
+}
+
+namespace fs0::language::fstrips {
+
+class BoundVariable;
+class Formula;
+class Term;
+
+//! An index-driven plan to enumerate the bindings of the variables of a quantified formula. Instead of iterating over
+//! the cartesian product of the type domains of all variables, the plan iterates over the tuples of a sequence of
+//! "generator" atoms p(x_1, ..., x_n) of the subformula, binding the variables from them: for fluent predicates, over
+//! the state variables of p that are true in the state, and for static predicates, over a precomputed index of the
+//! tuples in the extension of p. Only the variables that no generator binds are enumerated over their full domain.
+//! For an existential formula, generators are taken from the positive atoms in the top-level conjunction of the
+//! subformula, since any binding that satisfies the formula must make them true; for a universal formula, from the
+//! negative atoms in its top-level disjunction, since any binding that makes them false satisfies the formula.
+class QueryPlan {
+public:
+	//! Compile a plan for the given quantification, or return nullptr if no atom of the subformula can drive it
+	static QueryPlan* compile(const std::vector<const BoundVariable*>& variables, const Formula& subformula, bool universal, const ProblemInfo& info);
+
+	//! Return true iff some of the bindings generated by the plan, extending the given one, gives the
+	//! subformula the given truth value in the given state
+	bool find(const State& state, Binding& binding, const Formula& subformula, bool expected) const;
+
+	//! Static predicates with more candidate tuples than this are not indexed
+	static const unsigned MAX_STATIC_TUPLES = 100000;
+
+protected:
+	struct Generator {
+		unsigned symbol;
+		bool fluent;
+		//! 'slots[i]' is the index of the quantified variable that appears as the i-th argument of the atom,
+		//! or -1 if the argument is fixed, i.e. a constant or a variable bound elsewhere, given by 'fixed[i]'
+		std::vector<int> slots;
+		std::vector<const Term*> fixed;
+		//! The candidate tuples of arguments of the atom, and, for fluent predicates, their state variables
+		std::vector<std::vector<object_id>> tuples;
+		std::vector<VariableIdx> variables;
+	};
+
+	QueryPlan(const std::vector<const BoundVariable*>& variables, std::vector<Generator>&& generators);
+
+	const std::vector<const BoundVariable*>& _variables;
+
+	std::vector<Generator> _generators;
+
+	bool find_rec(const State& state, Binding& binding, const Formula& subformula, bool expected, unsigned level, std::vector<bool>& bound) const;
+
+	//! Enumerate the values of the variables not bound by any generator, starting from the i-th one
+	bool enumerate(const State& state, Binding& binding, const Formula& subformula, bool expected, unsigned i, std::vector<bool>& bound) const;
+};
+
+} // namespaces
@@ -1,7 +1,9 @@
 
 #include <boost/functional/hash.hpp>
 
+#include <fs/core/problem.hxx>
 #include <fs/core/problem_info.hxx>
+#include <fs/core/derived_atoms.hxx>
 #include <fs/core/languages/fstrips/terms.hxx>
 #include <fs/core/languages/fstrips/builtin.hxx>
 #include <fs/core/state.hxx>
@@ -54,9 +56,8 @@ object_id AxiomaticTermWrapper::interpret(const PartialAssignment& assignment, c
 object_id AxiomaticTermWrapper::interpret(const State& state, const Binding& binding) const {
 	NestedTerm::interpret_subterms(_subterms, state, binding, _interpreted_subterms);
 
-	// The binding to interpret the inner condition of the axiom is independent, i.e. axioms need to be sentences
-	Binding axiom_binding;
-	bool res = _axiom->getDefinition()->interpret(state, axiom_binding);
+	// The derived atom is computed only once per state, and then cached in the state itself
+	bool res = Problem::getInstance().get_axiom_evaluator().value(state, *_axiom, _interpreted_subterms);
 	return make_object<int>(res); // The hack: transform the bool into an int
 }
 
@@ -10,6 +10,7 @@
 #include <fs/core/problem.hxx>
 #include <fs/core/state.hxx>
 #include <fs/core/utils/system.hxx>
+#include <fs/core/utils/thread_pool.hxx>
 
 #include <boost/filesystem.hpp>   // includes all needed Boost.Filesystem declarations
 
@@ -26,14 +27,16 @@ CSPLiftedStateModel::CSPLiftedStateModel(
         std::vector<const PartiallyGroundedAction*>&& schemas,
         std::vector<SimpleLiftedOperator>&& lifted_operators,
         std::vector<gecode::v2::ActionSchemaCSP>&& schema_csps,
-        gecode::v2::SymbolExtensionGenerator&& extension_generator) :
+        gecode::v2::SymbolExtensionGenerator&& extension_generator,
+        std::shared_ptr<ThreadPool> pool) :
 
     problem(problem),
     _subgoals(std::move(subgoals)),
     schemas(std::move(schemas)),
     lifted_operators(std::move(lifted_operators)),
     schema_csps(std::move(schema_csps)),
-    extension_generator(std::move(extension_generator))
+    extension_generator(std::move(extension_generator)),
+    _pool(std::move(pool))
 {}
 
 CSPLiftedStateModel::~CSPLiftedStateModel() = default;
@@ -55,13 +58,13 @@ State CSPLiftedStateModel::next(const State& state, const LiftedActionID& aid) c
     auto& adata = aid.getActionData();
     auto& op = lifted_operators[adata.getId()];
     // Note that we don't need to check the precondition of the operator, only evaluate the effects:
-    evaluate_simple_lifted_operator(state, op, aid.get_binding(), ProblemInfo::getInstance(), false, _effects_cache);
+    evaluate_simple_lifted_operator(state, op, aid.get_binding().data(), ProblemInfo::getInstance(), false, _effects_cache);
     return State(state, _effects_cache); // Copy everything into the new state and apply the changeset
 }
 
 gecode::CSPActionIterator CSPLiftedStateModel::applicable_actions(const State& state, bool enforce_state_constraints) const {
     // TODO At the moment we don't support state constraints anymore
-    return gecode::CSPActionIterator(state, schema_csps, extension_generator.instantiate(state), schemas);
+    return gecode::CSPActionIterator(state, schema_csps, extension_generator.instantiate(state), schemas, _pool.get());
 }
 
 
@@ -103,7 +106,7 @@ CSPLiftedStateModel::build(const Problem& problem, const ProblemInfo& info, cons
             std::cerr << "Non-existing CSP file for action \"" << schema_name << "\"" << std::endl;
             exit_with(ExitCode::SEARCH_INPUT_ERROR);
         }
-        csps_tmp.push_back(gecode::v2::ActionSchemaCSP::load(ifs, info, symbols_in_extensions));
+        csps_tmp.push_back(gecode::v2::ActionSchemaCSP::load(ifs, schema_name, info, symbols_in_extensions));
         ifs.close();
     }
 
@@ -123,13 +126,16 @@ CSPLiftedStateModel::build(const Problem& problem, const ProblemInfo& info, cons
         }
     }
 
+    auto pool = create_successor_pool(csps.size());
+
     return CSPLiftedStateModel(
             problem,
             obtain_goal_atoms(problem.getGoalConditions()),
             std::move(schemas),
             std::move(ops),
             std::move(csps),
-            std::move(extension_generator));
+            std::move(extension_generator),
+            std::move(pool));
 }
 
 } // namespaces
@@ -13,6 +13,7 @@ namespace fs0 {
 
 class LiftedActionID;
 class Problem;
+class ThreadPool;
 class State;
 class GroundAction;
 
@@ -31,7 +32,8 @@ protected:
             std::vector<const PartiallyGroundedAction*>&& schemas,
             std::vector<SimpleLiftedOperator>&& lifted_operators,
             std::vector<gecode::v2::ActionSchemaCSP>&& schema_csps,
-            gecode::v2::SymbolExtensionGenerator&& extension_generator);
+            gecode::v2::SymbolExtensionGenerator&& extension_generator,
+            std::shared_ptr<ThreadPool> pool);
 
 public:
 
@@ -86,6 +88,9 @@ protected:
 
     gecode::v2::SymbolExtensionGenerator extension_generator;
 
+	//! The pool on which the CSPs of the different schemas are solved, if any
+	std::shared_ptr<ThreadPool> _pool;
+
 	//! A cache to hold the effects of the last-applied action and avoid memory allocations.
 	mutable std::vector<Atom> _effects_cache;
 };
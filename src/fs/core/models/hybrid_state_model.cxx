@@ -0,0 +1,158 @@
+
+#include <fs/core/models/hybrid_state_model.hxx>
+
+#include <fs/core/actions/actions.hxx>
+#include <fs/core/actions/grounding.hxx>
+#include <fs/core/applicability/action_managers.hxx>
+#include <fs/core/applicability/formula_interpreter.hxx>
+#include <fs/core/languages/fstrips/language.hxx>
+#include <fs/core/models/simple_state_model.hxx>
+#include <fs/core/models/utils.hxx>
+#include <fs/core/problem.hxx>
+#include <fs/core/problem_info.hxx>
+#include <fs/core/state.hxx>
+#include <fs/core/utils/config.hxx>
+#include <lapkt/tools/logging.hxx>
+
+#include <utility>
+
+
+namespace fs0 {
+
+HybridStateModel::HybridStateModel(
+		const Problem& problem,
+		std::vector<const fs::Formula*> subgoals,
+		std::vector<const PartiallyGroundedAction*>&& schemas,
+		std::vector<bool>&& ground_schemas,
+		std::vector<SimpleLiftedOperator>&& lifted_operators,
+		std::shared_ptr<const JoinSuccessorGenerator> generator,
+		std::shared_ptr<const ActionManagerI> ground_manager,
+		std::shared_ptr<const GroundIndexT> ground_index) :
+
+	_problem(problem),
+	_subgoals(std::move(subgoals)),
+	_schemas(std::move(schemas)),
+	_ground_schemas(std::move(ground_schemas)),
+	_lifted_operators(std::move(lifted_operators)),
+	_generator(std::move(generator)),
+	_ground_manager(std::move(ground_manager)),
+	_ground_index(std::move(ground_index))
+{}
+
+
+State HybridStateModel::init() const {
+	// We need to make a copy so that we can return it as non-const.
+	// This is only called once per search.
+	return State(_problem.getInitialState());
+}
+
+bool HybridStateModel::goal(const State& state) const {
+	return _problem.getGoalSatManager().satisfied(state);
+}
+
+State HybridStateModel::next(const State& state, const LiftedActionID& aid) const {
+	// We don't need to check the precondition of the action in either case
+	unsigned id = aid.getActionData().getId();
+	if (_ground_schemas[id]) {
+		auto it = _ground_index->find(aid);
+		assert(it != _ground_index->end());
+		NaiveApplicabilityManager::computeEffects(state, *_problem.getGroundActions()[it->second], _effects_cache);
+	} else {
+		evaluate_simple_lifted_operator(state, _lifted_operators[id], aid.get_binding().data(), ProblemInfo::getInstance(), false, _effects_cache);
+	}
+	return State(state, _effects_cache); // Copy everything into the new state and apply the changeset
+}
+
+HybridActionIterator HybridStateModel::applicable_actions(const State& state, bool enforce_state_constraints) const {
+	return HybridActionIterator(
+			_ground_manager->applicable(state, enforce_state_constraints),
+			JoinActionIterator(state, *_generator),
+			_problem.getGroundActions(),
+			_schemas);
+}
+
+bool HybridStateModel::goal(const StateT& s, unsigned i) const {
+	Binding binding;
+	return _subgoals.at(i)->interpret(s, binding);
+}
+
+std::vector<bool>
+HybridStateModel::select_ground_schemas(const std::vector<const ActionData*>& action_data, const ProblemInfo& info, std::vector<const GroundAction*>& grounded) {
+	double max_groundings = Config::instance().getOption<double>("hybrid.max_groundings", 10000);
+
+	std::vector<const ActionData*> candidates;
+	for (const ActionData* data:action_data) {
+		// The size of the binding space of the schema, which is an upper bound on its number of ground actions
+		double groundings = 1;
+		for (TypeIdx type:data->getSignature()) groundings *= info.getTypeObjects(type).size();
+
+		if (groundings <= max_groundings * MAX_PRUNING_RATIO) {
+			candidates.push_back(data);
+		} else {
+			LPT_INFO("cout", "Action schema \"" << data->getName() << "\" has " << groundings << " possible groundings: keeping it lifted");
+		}
+	}
+
+	std::vector<bool> grounded_candidates;
+	grounded = ActionGrounder::ground_schemas(candidates, info, (unsigned long) max_groundings, grounded_candidates);
+
+	std::vector<unsigned> num_ground_actions(action_data.size(), 0);
+	for (const GroundAction* action:grounded) ++num_ground_actions.at(action->getActionData().getId());
+
+	std::vector<bool> ground(action_data.size(), false);
+	for (unsigned i = 0; i < candidates.size(); ++i) {
+		unsigned id = candidates[i]->getId();
+		ground.at(id) = grounded_candidates[i];
+		if (ground[id]) {
+			LPT_INFO("cout", "Action schema \"" << candidates[i]->getName() << "\" has " << num_ground_actions[id] << " statically applicable groundings: grounding it");
+		} else {
+			LPT_INFO("cout", "Action schema \"" << candidates[i]->getName() << "\" has more than " << max_groundings << " statically applicable groundings: keeping it lifted");
+		}
+	}
+	return ground;
+}
+
+HybridStateModel
+HybridStateModel::build(const Problem& problem, const ProblemInfo& info, const std::vector<bool>& ground_schemas) {
+	const auto& all_schemas = problem.getPartiallyGroundedActions();
+
+	// Schemas and operators are indexed by action schema ID, as required by the successor generator
+	std::vector<const PartiallyGroundedAction*> schemas(problem.getActionData().size(), nullptr);
+	std::vector<SimpleLiftedOperator> ops(problem.getActionData().size());
+	std::vector<const PartiallyGroundedAction*> lifted;
+	for (const auto* schema:all_schemas) {
+		unsigned id = schema->getActionData().getId();
+		schemas.at(id) = schema;
+		if (!ground_schemas.at(id)) {
+			ops.at(id) = compile_schema_to_simple_lifted_operator(*schema);
+			lifted.push_back(schema);
+		}
+	}
+
+	// Ground actions are identified by the lifted ID of the schema they come from, as done by the action iterator
+	auto index = std::make_shared<GroundIndexT>();
+	const auto& ground_actions = problem.getGroundActions();
+	for (unsigned i = 0; i < ground_actions.size(); ++i) {
+		const auto& values = ground_actions[i]->getBinding().get_full_binding();
+		const auto* schema = schemas.at(ground_actions[i]->getActionData().getId());
+		index->emplace(LiftedActionID(schema, values.data(), values.data() + values.size()), i);
+	}
+
+	LPT_INFO("cout", "Hybrid successor generation: " << ground_actions.size() << " ground actions, "
+	                 << lifted.size() << " lifted action schemas");
+
+	auto generator = std::make_shared<const JoinSuccessorGenerator>(lifted, ops, info);
+	std::shared_ptr<const ActionManagerI> manager(SimpleStateModel::build_action_manager(problem));
+
+	return HybridStateModel(
+			problem,
+			obtain_goal_atoms(problem.getGoalConditions()),
+			std::move(schemas),
+			std::vector<bool>(ground_schemas),
+			std::move(ops),
+			std::move(generator),
+			std::move(manager),
+			std::move(index));
+}
+
+} // namespaces
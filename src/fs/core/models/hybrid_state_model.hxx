@@ -0,0 +1,125 @@
+
+#pragma once
+
+#include <fs/core/atom.hxx>
+#include <fs/core/actions/action_id.hxx>
+#include <fs/core/actions/hybrid_action_iterator.hxx>
+#include <fs/core/actions/simple_lifted_operators.hxx>
+#include <fs/core/languages/fstrips/language_fwd.hxx>
+
+#include <memory>
+#include <unordered_map>
+
+
+namespace fs0 {
+
+class ActionData;
+class ActionManagerI;
+class GroundAction;
+class Problem;
+class ProblemInfo;
+class State;
+
+
+//! A state model that grounds those action schemas with a small number of groundings, whose applicability
+//! is then checked by a standard action manager (e.g. a match tree), and keeps the rest lifted, computing their
+//! applicable groundings with a JoinSuccessorGenerator. All actions are identified by lifted action IDs, but
+//! ground actions are applied as such, and only lifted schemas are compiled into simple lifted operators.
+class HybridStateModel
+{
+public:
+	using StateT = State;
+	using ActionType = LiftedActionID;
+
+	//! Maps the lifted ID of each ground action to its index in the vector of ground actions of the problem
+	using GroundIndexT = std::unordered_map<LiftedActionID, unsigned, std::hash<ActionID>>;
+
+protected:
+	HybridStateModel(
+			const Problem& problem,
+			std::vector<const fs::Formula*> subgoals,
+			std::vector<const PartiallyGroundedAction*>&& schemas,
+			std::vector<bool>&& ground_schemas,
+			std::vector<SimpleLiftedOperator>&& lifted_operators,
+			std::shared_ptr<const JoinSuccessorGenerator> generator,
+			std::shared_ptr<const ActionManagerI> ground_manager,
+			std::shared_ptr<const GroundIndexT> ground_index);
+
+public:
+	//! Schemas whose binding space is more than this many times larger than the threshold of option
+	//! 'hybrid.max_groundings' are not even tried to be grounded, since enumerating it would take too long
+	static constexpr double MAX_PRUNING_RATIO = 100;
+
+	//! Ground those action schemas that result in at most 'hybrid.max_groundings' ground actions once statically
+	//! inapplicable groundings are pruned, placing their ground actions in 'grounded', and return, for each action
+	//! schema, whether it was grounded
+	static std::vector<bool> select_ground_schemas(const std::vector<const ActionData*>& action_data, const ProblemInfo& info,
+	                                               std::vector<const GroundAction*>& grounded);
+
+	//! Factory method. The ground actions of the problem must be those of the schemas marked as ground,
+	//! and its partially grounded actions the fully lifted version of all schemas.
+	static HybridStateModel build(const Problem& problem, const ProblemInfo& info, const std::vector<bool>& ground_schemas);
+
+	~HybridStateModel() = default;
+
+	HybridStateModel(const HybridStateModel&) = default;
+	HybridStateModel& operator=(const HybridStateModel&) = delete;
+	HybridStateModel(HybridStateModel&&) = default;
+	HybridStateModel& operator=(HybridStateModel&&) = delete;
+
+	//! Returns initial state of the problem
+	State init() const;
+
+	//! Returns true if state is a goal state
+	bool goal(const State& state) const;
+
+	//! Returns applicable action set object
+	HybridActionIterator applicable_actions(const State& state, bool enforce_state_constraints) const;
+	HybridActionIterator applicable_actions(const State& state) const {
+		return applicable_actions(state, true);
+	}
+
+	//! Returns the state resulting from applying the given action action on the given state
+	State next(const State& state, const ActionType& aid) const;
+
+	const Problem& getTask() const { return _problem; }
+
+	//! Returns the number of subgoals into which the goal can be decomposed
+	unsigned num_subgoals() const { return _subgoals.size(); }
+
+	//! Returns true iff the given state satisfies the i-th subgoal
+	bool goal(const StateT& s, unsigned i) const;
+
+	const std::vector<Atom>& get_last_changeset() const {
+		return _effects_cache;
+	}
+
+protected:
+	// The underlying planning problem.
+	const Problem& _problem;
+
+	const std::vector<const fs::Formula*> _subgoals;
+
+	//! The fully lifted action schemas, indexed by their ID
+	std::vector<const PartiallyGroundedAction*> _schemas;
+
+	//! Whether each action schema, indexed by ID, has been grounded
+	std::vector<bool> _ground_schemas;
+
+	//! The simple lifted operators, indexed by action schema ID. Only those of lifted schemas are compiled.
+	std::vector<SimpleLiftedOperator> _lifted_operators;
+
+	//! The successor generator of the lifted schemas, shared among the copies of the model
+	std::shared_ptr<const JoinSuccessorGenerator> _generator;
+
+	//! The action manager of the ground actions, shared among the copies of the model
+	std::shared_ptr<const ActionManagerI> _ground_manager;
+
+	//! The index of ground actions by lifted ID, shared among the copies of the model
+	std::shared_ptr<const GroundIndexT> _ground_index;
+
+	//! A cache to hold the effects of the last-applied action and avoid memory allocations.
+	mutable std::vector<Atom> _effects_cache;
+};
+
+} // namespaces
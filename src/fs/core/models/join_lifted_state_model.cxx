@@ -0,0 +1,77 @@
+
+#include <fs/core/models/join_lifted_state_model.hxx>
+
+#include <fs/core/actions/actions.hxx>
+#include <fs/core/applicability/formula_interpreter.hxx>
+#include <fs/core/languages/fstrips/language.hxx>
+#include <fs/core/models/utils.hxx>
+#include <fs/core/problem.hxx>
+#include <fs/core/problem_info.hxx>
+#include <fs/core/state.hxx>
+
+#include <utility>
+
+
+namespace fs0 {
+
+JoinLiftedStateModel::JoinLiftedStateModel(
+		const Problem& problem,
+		std::vector<const fs::Formula*> subgoals,
+		std::vector<SimpleLiftedOperator>&& lifted_operators,
+		std::shared_ptr<const JoinSuccessorGenerator> generator) :
+
+	_problem(problem),
+	_subgoals(std::move(subgoals)),
+	_lifted_operators(std::move(lifted_operators)),
+	_generator(std::move(generator))
+{}
+
+
+State JoinLiftedStateModel::init() const {
+	// We need to make a copy so that we can return it as non-const.
+	// Ugly, but this way we make it fit the search engine interface without further changes,
+	// and this is only called once per search.
+	return State(_problem.getInitialState());
+}
+
+bool JoinLiftedStateModel::goal(const State& state) const {
+	return _problem.getGoalSatManager().satisfied(state);
+}
+
+State JoinLiftedStateModel::next(const State& state, const LiftedActionID& aid) const {
+	const auto& op = _lifted_operators[aid.getActionData().getId()];
+	// Note that we don't need to check the precondition of the operator, only evaluate the effects:
+	evaluate_simple_lifted_operator(state, op, aid.get_binding().data(), ProblemInfo::getInstance(), false, _effects_cache);
+	return State(state, _effects_cache); // Copy everything into the new state and apply the changeset
+}
+
+JoinActionIterator JoinLiftedStateModel::applicable_actions(const State& state, bool enforce_state_constraints) const {
+	// As with the rest of lifted models, state constraints are not supported
+	return JoinActionIterator(state, *_generator);
+}
+
+bool JoinLiftedStateModel::goal(const StateT& s, unsigned i) const {
+	Binding binding;
+	return _subgoals.at(i)->interpret(s, binding);
+}
+
+JoinLiftedStateModel
+JoinLiftedStateModel::build(const Problem& problem, const ProblemInfo& info) {
+	const auto& schemas = problem.getPartiallyGroundedActions();
+
+	// Operators are indexed by action schema ID, as required by the successor generator
+	std::vector<SimpleLiftedOperator> ops(problem.getActionData().size());
+	for (const auto* schema:schemas) {
+		ops.at(schema->getActionData().getId()) = compile_schema_to_simple_lifted_operator(*schema);
+	}
+
+	auto generator = std::make_shared<const JoinSuccessorGenerator>(schemas, ops, info);
+
+	return JoinLiftedStateModel(
+			problem,
+			obtain_goal_atoms(problem.getGoalConditions()),
+			std::move(ops),
+			std::move(generator));
+}
+
+} // namespaces
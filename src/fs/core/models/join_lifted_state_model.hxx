@@ -0,0 +1,90 @@
+
+#pragma once
+
+#include <fs/core/atom.hxx>
+#include <fs/core/actions/action_id.hxx>
+#include <fs/core/actions/join_action_iterator.hxx>
+#include <fs/core/actions/simple_lifted_operators.hxx>
+#include <fs/core/languages/fstrips/language_fwd.hxx>
+
+#include <memory>
+
+
+namespace fs0 {
+
+class Problem;
+class ProblemInfo;
+class State;
+
+
+//! A state model that works with lifted actions, whose applicable groundings are computed natively
+//! by means of a JoinSuccessorGenerator.
+class JoinLiftedStateModel
+{
+public:
+	using StateT = State;
+	using ActionType = LiftedActionID;
+
+protected:
+	JoinLiftedStateModel(
+			const Problem& problem,
+			std::vector<const fs::Formula*> subgoals,
+			std::vector<SimpleLiftedOperator>&& lifted_operators,
+			std::shared_ptr<const JoinSuccessorGenerator> generator);
+
+public:
+
+	//! Factory method
+	static JoinLiftedStateModel build(const Problem& problem, const ProblemInfo& info);
+
+	~JoinLiftedStateModel() = default;
+
+	JoinLiftedStateModel(const JoinLiftedStateModel&) = default;
+	JoinLiftedStateModel& operator=(const JoinLiftedStateModel&) = delete;
+	JoinLiftedStateModel(JoinLiftedStateModel&&) = default;
+	JoinLiftedStateModel& operator=(JoinLiftedStateModel&&) = delete;
+
+	//! Returns initial state of the problem
+	State init() const;
+
+	//! Returns true if state is a goal state
+	bool goal(const State& state) const;
+
+	//! Returns applicable action set object
+	JoinActionIterator applicable_actions(const State& state, bool enforce_state_constraints) const;
+	JoinActionIterator applicable_actions(const State& state) const {
+		return applicable_actions(state, true);
+	}
+
+	//! Returns the state resulting from applying the given action action on the given state
+	State next(const State& state, const ActionType& aid) const;
+
+	const Problem& getTask() const { return _problem; }
+
+	//! Returns the number of subgoals into which the goal can be decomposed
+	unsigned num_subgoals() const { return _subgoals.size(); }
+
+	//! Returns true iff the given state satisfies the i-th subgoal
+	bool goal(const StateT& s, unsigned i) const;
+
+	const std::vector<Atom>& get_last_changeset() const {
+		return _effects_cache;
+	}
+
+protected:
+	// The underlying planning problem.
+	const Problem& _problem;
+
+	const std::vector<const fs::Formula*> _subgoals;
+
+	//! The simple lifted operators, indexed by action schema ID
+	std::vector<SimpleLiftedOperator> _lifted_operators;
+
+	//! The successor generator is shared among the copies of the model, as it can be large
+	std::shared_ptr<const JoinSuccessorGenerator> _generator;
+
+	//! A cache to hold the effects of the last-applied action and avoid memory allocations.
+	mutable std::vector<Atom> _effects_cache;
+};
+
+} // namespaces
@@ -9,6 +9,7 @@
 #include <fs/core/languages/fstrips/language.hxx>
 #include <utility>
 #include <fs/core/utils/config.hxx>
+#include <fs/core/utils/thread_pool.hxx>
 
 #include <lapkt/tools/logging.hxx>
 #include "utils.hxx"
@@ -43,7 +44,7 @@ namespace fs0 {
 
 
     SDDActionIterator SDDLiftedStateModel::applicable_actions(const State& state) const {
-        return {state, sdds_, _task.get_tuple_index()};
+        return {state, sdds_, _task.get_tuple_index(), _pool.get()};
     }
 
     SDDActionIterator SDDLiftedStateModel::applicable_actions(const State& state, bool enforce_state_constraints) const {
@@ -65,14 +66,16 @@ namespace fs0 {
     SDDLiftedStateModel::build(const Problem& problem) {
         const ProblemInfo& info = ProblemInfo::getInstance();
         auto sdds = load_sdds_from_disk(problem.getPartiallyGroundedActions(), info.getDataDir() + "/sdd");
-        auto model = SDDLiftedStateModel(problem, sdds, obtain_goal_atoms(problem.getGoalConditions()));
+        auto model = SDDLiftedStateModel(problem, sdds, obtain_goal_atoms(problem.getGoalConditions()), create_successor_pool(sdds.size()));
         return model;
     }
 
-    SDDLiftedStateModel::SDDLiftedStateModel(const Problem& problem, std::vector<std::shared_ptr<ActionSchemaSDD>> sdds, std::vector<const fs::Formula*> subgoals) :
+    SDDLiftedStateModel::SDDLiftedStateModel(const Problem& problem, std::vector<std::shared_ptr<ActionSchemaSDD>> sdds, std::vector<const fs::Formula*> subgoals,
+                                             std::shared_ptr<ThreadPool> pool) :
             _task(problem),
             sdds_(std::move(sdds)),
-            _subgoals(std::move(subgoals))
+            _subgoals(std::move(subgoals)),
+            _pool(std::move(pool))
     {
         // At the moment we just ignore the state constraints. TODO We should do better error handling,
         // but all of this state constraint code is bound to be refactored soon.
@@ -14,6 +14,7 @@ namespace fs0 {
 class Problem;
 class State;
 class GroundAction;
+class ThreadPool;
 
 
 //! A state model that works with lifted actions instead of grounded actions
@@ -24,7 +25,8 @@ public:
 	using ActionType = LiftedActionID;
 
 protected:
-	SDDLiftedStateModel(const Problem& problem, std::vector<std::shared_ptr<ActionSchemaSDD>> sdds, std::vector<const fs::Formula*> subgoals);
+	SDDLiftedStateModel(const Problem& problem, std::vector<std::shared_ptr<ActionSchemaSDD>> sdds, std::vector<const fs::Formula*> subgoals,
+	                    std::shared_ptr<ThreadPool> pool);
 
 public:
 
@@ -56,6 +58,8 @@ public:
 
 	const Problem& getTask() const { return _task; }
 
+	const std::vector<std::shared_ptr<ActionSchemaSDD>>& get_sdds() const { return sdds_; }
+
 	//! Returns the number of subgoals into which the goal can be decomposed
 	unsigned num_subgoals() const { return _subgoals.size(); }
 
@@ -74,6 +78,9 @@ protected:
 
 	const std::vector<const fs::Formula*> _subgoals;
 
+	//! The pool on which the applicable bindings of the different schemas are computed, if any
+	std::shared_ptr<ThreadPool> _pool;
+
 	//! A cache to hold the effects of the last-applied action and avoid memory allocations.
 	mutable std::vector<Atom> _effects_cache;
 };
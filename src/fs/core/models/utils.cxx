@@ -1,5 +1,12 @@
 
+#include <algorithm>
+
 #include <fs/core/languages/fstrips/language.hxx>
+#include <fs/core/utils/config.hxx>
+#include <fs/core/utils/thread_pool.hxx>
+#include <lapkt/tools/logging.hxx>
+
+#include "utils.hxx"
 
 //! A helper to derive the distinct goal atoms
 std::vector<const fs::Formula*>
@@ -16,4 +23,15 @@ obtain_goal_atoms(const fs::Formula* goal) {
     }
 
     return goal_atoms;
-}
\ No newline at end of file
+}
+
+std::shared_ptr<fs0::ThreadPool>
+create_successor_pool(unsigned num_schemas) {
+    unsigned nthreads = fs0::Config::instance().getOption<unsigned>("lifted.threads", 1);
+    if (nthreads == 0) nthreads = std::max(1u, std::thread::hardware_concurrency());
+    nthreads = std::min(nthreads, num_schemas);
+    if (nthreads <= 1) return nullptr;
+
+    LPT_INFO("cout", "Applicable bindings of the " << num_schemas << " action schemas will be computed on " << nthreads << " threads");
+    return std::make_shared<fs0::ThreadPool>(nthreads);
+}
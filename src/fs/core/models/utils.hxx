@@ -1,10 +1,16 @@
 
 #pragma once
 
+#include <memory>
 #include <vector>
 
+namespace fs0 { class ThreadPool; }
 namespace fs0::language::fstrips { class Formula; }
 
 namespace fs = fs0::language::fstrips;
 
-std::vector<const fs::Formula*> obtain_goal_atoms(const fs::Formula* goal);
\ No newline at end of file
+std::vector<const fs::Formula*> obtain_goal_atoms(const fs::Formula* goal);
+
+//! Create the pool on which lifted models compute concurrently the applicable bindings of their action schemas,
+//! as configured by option 'lifted.threads'. Return null if bindings are to be computed sequentially.
+std::shared_ptr<fs0::ThreadPool> create_successor_pool(unsigned num_schemas);
@@ -79,19 +79,24 @@ TransitionGraph::retrieve_domains(const std::vector<Atom>& changeset) const {
             continue;
         }
 
-        const auto& all_domains = _reachable_bitsets[var];
-        const auto& it = all_domains.find(atom.getValue());
-        if (it == all_domains.end()) {
-            throw std::runtime_error("Monotonicity domain mapping is wrong - "
-                                     "it should have a set of allowed transitions for any possible value in the domain of any monotonic variable");
-        }
-
-        result.push_back(it->second); // copy the domain into the result
+        result.push_back(reachable_values(var, atom.getValue())); // copy the domain into the result
     }
 
     return result;
 }
 
+const TransitionGraph::BitmapT&
+TransitionGraph::reachable_values(VariableIdx var, const object_id& value) const {
+    assert(is_monotonic(var));
+    const auto& all_domains = _reachable_bitsets[var];
+    const auto& it = all_domains.find(value);
+    if (it == all_domains.end()) {
+        throw std::runtime_error("Monotonicity domain mapping is wrong - "
+                                 "it should have a set of allowed transitions for any possible value in the domain of any monotonic variable");
+    }
+    return it->second;
+}
+
 
 bool TransitionGraph::transition_is_valid(VariableIdx variable, const object_id& val0, const object_id& val1) const {
     const auto& var_transitions = _transitions.at(variable);
@@ -301,10 +306,10 @@ std::vector<Gecode::IntSet> DomainTracker::to_intsets() const {
     assert(!is_null());
 
     std::vector<Gecode::IntSet> res;
-    res.reserve(_domains->size());
+    res.reserve(_domains.size());
 
-    for (const auto& dom:*_domains) {
-        std::vector<int> values = as_vector(dom);
+    for (const auto& dom:_domains) {
+        std::vector<int> values = as_vector(*dom);
         res.emplace_back(values.data(), values.size());
     }
 
@@ -327,10 +332,9 @@ std::ostream& print::bitset::print(std::ostream& os) const {
 }
 
 std::ostream& print::domain_tracker::print(std::ostream& os) const {
-    const auto& domains = _domains.domains();
     os << "DomainTracker:" << std::endl;
-    for (unsigned var = 0; var < domains.size(); ++var) {
-        os << print::bitset(var, domains[var]);
+    for (unsigned var = 0; var < _domains.size(); ++var) {
+        os << print::bitset(var, _domains.domain(var));
     }
     return os << std::endl;
 }
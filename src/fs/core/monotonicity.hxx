@@ -6,6 +6,7 @@
 
 #include <boost/dynamic_bitset.hpp>
 
+#include <memory>
 #include <unordered_map>
 #include <unordered_set>
 #include <gecode/int.hh>
@@ -28,6 +29,9 @@ public:
     std::vector<TransitionGraph::BitmapT>
     retrieve_domains(const std::vector<Atom>& changeset) const;
 
+    //! Return the set of values reachable by the given monotonic variable once it has taken the given value
+    const BitmapT& reachable_values(VariableIdx var, const object_id& value) const;
+
 protected:
     const AtomIndex& _tuple_index;
 
@@ -109,31 +113,42 @@ protected:
 };
 
 
-//!
+//! The sets of reachable values of all state variables in a certain state of the search.
+//! The domains are immutable and shared among the trackers of a node and its children, so that a child
+//! only allocates new domains for those variables whose domain has been pruned wrt the parent.
+//! A default-constructed (i.e. null) tracker allocates nothing.
 class DomainTracker {
+public:
+    using DomainPT = std::shared_ptr<const TransitionGraph::BitmapT>;
+
 protected:
-    //! _reachable[x] contains a bitmap with the set of reachable values for state variable x
+    //! _domains[x] points to a bitmap with the set of reachable values for state variable x
     //! in a certain state of the search. If variable x is not a monotonic variable, then
-    //! _reachable[x] will be empty
-    std::unique_ptr<std::vector<TransitionGraph::BitmapT>> _domains;
+    //! the bitmap will be empty
+    std::vector<DomainPT> _domains;
+
 public:
-    const std::vector<TransitionGraph::BitmapT>& domains() const { return *_domains; }
+    const std::vector<DomainPT>& domains() const { return _domains; }
 
-    DomainTracker() :
-            _domains(new std::vector<TransitionGraph::BitmapT>)
-    {}
+    const TransitionGraph::BitmapT& domain(VariableIdx var) const { assert(_domains[var]); return *_domains[var]; }
 
-    DomainTracker(std::vector<TransitionGraph::BitmapT>&& domains) :
-            _domains(new std::vector<TransitionGraph::BitmapT>(std::move(domains)))
-    {}
+    DomainTracker() = default;
+
+    explicit DomainTracker(std::vector<TransitionGraph::BitmapT>&& domains) {
+        _domains.reserve(domains.size());
+        for (auto& domain:domains) _domains.push_back(std::make_shared<const TransitionGraph::BitmapT>(std::move(domain)));
+    }
+
+    //! Replace the domain of the given variable, which is not shared with any other tracker that shares the old one
+    void update(VariableIdx var, TransitionGraph::BitmapT&& domain) {
+        _domains[var] = std::make_shared<const TransitionGraph::BitmapT>(std::move(domain));
+    }
 
-    std::size_t size() const { assert(_domains); return _domains->size(); }
-    bool is_null() const { assert(_domains); return _domains->empty(); }
+    std::size_t size() const { return _domains.size(); }
+    bool is_null() const { return _domains.empty(); }
 
     void release() {
-//        _domains.clear();
-//        std::vector<TransitionGraph::BitmapT>().swap(_domains);
-        _domains.reset();
+        std::vector<DomainPT>().swap(_domains);
     }
 
     std::vector<Gecode::IntSet> to_intsets() const;
@@ -3,6 +3,7 @@
 
 #include <fs/core/actions/actions.hxx>
 #include <fs/core/applicability/formula_interpreter.hxx>
+#include <fs/core/derived_atoms.hxx>
 #include <fs/core/languages/fstrips/formulae.hxx>
 #include <fs/core/languages/fstrips/metrics.hxx>
 #include <fs/core/languages/fstrips/operations/axioms.hxx>
@@ -17,6 +18,7 @@
 namespace fs0 {
 
 std::unique_ptr<Problem> Problem::_instance = nullptr;
+thread_local const Problem* Problem::_thread_instance = nullptr;
 
 Problem::Problem(
         State* init,
@@ -34,6 +36,7 @@ Problem::Problem(
 	_state_indexer(state_indexer),
 	_action_data(std::move(action_data)),
 	_axioms(std::move(axioms)),
+	_axiom_evaluator(new AxiomEvaluator(_axioms, ProblemInfo::getInstance())),
 	_ground(),
 	_partials(),
 	_state_constraints(std::move(state_constraints)),
@@ -73,19 +76,23 @@ Problem::Problem(const Problem& other) :
 	_init(new State(*other._init)),
 	_state_indexer(new StateAtomIndexer(*other._state_indexer)),
 	_action_data(Utils::copy(other._action_data)),
-	_axioms(other._axioms),
+	_axioms(_clone_axioms(other._axioms)),
+	_axiom_evaluator(new AxiomEvaluator(_axioms, ProblemInfo::getInstance())),
 	_ground(Utils::copy(other._ground)),
 	_partials(Utils::copy(other._partials)),
-    _state_constraints(other._state_constraints),
+    _state_constraints(_clone_axioms(other._state_constraints)),
 	_goal_formula(other._goal_formula->clone()),
-    _metric(new fs::Metric(*other._metric)),
+    _metric(other._metric ? new fs::Metric(*other._metric) : nullptr),
 	_goal_sat_manager(other._goal_sat_manager->clone()),
-	_is_predicative(other._is_predicative)
+	_is_predicative(other._is_predicative),
+    _transition_graphs(other._transition_graphs)
 {
     //! Store pointers to the state constraint definitions for ease of use
     for ( auto c : _state_constraints ) {
         _state_constraints_formulae.push_back( c.second->getDefinition() );
     }
+    // The copied definitions and formulas still refer to the axioms of the original problem
+    _axiom_evaluator->add_aliases(other._axioms);
 }
 const fs::Formula* Problem::getGoalConditions() const { return _goal_formula; }
 
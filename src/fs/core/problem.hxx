@@ -16,6 +16,7 @@ class ActionData;
 class ActionBase;
 class PartiallyGroundedAction;
 class GroundAction;
+class AxiomEvaluator;
 
 class Problem {
 public:
@@ -67,6 +68,9 @@ public:
 		return it->second;
 	}
 
+	//! The evaluator of the (derived atoms of the) axioms of the problem
+	const AxiomEvaluator& get_axiom_evaluator() const { return *_axiom_evaluator; }
+
 	const FormulaInterpreter& getGoalSatManager() const { return *_goal_sat_manager; }
 
 	//! Set the global singleton problem instance
@@ -79,12 +83,17 @@ public:
 		return std::move(_instance);
 	}
 
-	//! Global singleton object accessor
+	//! Global singleton object accessor. On threads bound to a private copy of the problem, return that copy instead.
 	static const Problem& getInstance() {
+		if (_thread_instance) return *_thread_instance;
 		assert(_instance);
 		return *_instance;
 	}
 
+	//! Bind the calling thread to the given copy of the problem, which 'getInstance' will return on that thread
+	//! from then on. Null unbinds the thread.
+	static void bindThreadInstance(const Problem* problem) { _thread_instance = problem; }
+
 	const fs::Axiom* getStateConstraint(const std::string& name) const {
 		auto it = _state_constraints.find(name);
 		if (it == _state_constraints.end()) return nullptr;
@@ -116,6 +125,8 @@ protected:
 	//! An index mapping symbol names to the axiomatic definition of the symbol, if it exists.
 	std::unordered_map<std::string, const fs::Axiom*> _axioms;
 
+	std::unique_ptr<AxiomEvaluator> _axiom_evaluator;
+
 	// The set of grounded actions of the problem
 	std::vector<const GroundAction*> _ground;
 
@@ -139,6 +150,9 @@ protected:
 	//! The singleton instance
 	static std::unique_ptr<Problem> _instance;
 
+	//! The copy of the problem the current thread is bound to, if any
+	static thread_local const Problem* _thread_instance;
+
 	static bool check_is_predicative();
 
 	AllTransitionGraphsT _transition_graphs;
@@ -1,6 +1,8 @@
 
 #pragma once
 
+#include <algorithm>
+#include <deque>
 #include <functional>
 
 #include <fs/core/search/nodes/blind_node.hxx>
@@ -8,18 +10,107 @@
 #include <lapkt/algorithms/breadth_first_search.hxx>
 
 #include <lapkt/novelty/novelty_based_acceptor.hxx>
+#include <lapkt/tools/resources_control.hxx>
 
 #include <fs/core/search/drivers/registry.hxx>
 #include <fs/core/search/drivers/setups.hxx>
 
 #include <fs/core/search/events.hxx>
 #include <fs/core/search/stats.hxx>
+#include <fs/core/search/novelty/tuple_novelty.hxx>
 
 
 namespace fs0 { class SearchStats; }
 
 namespace fs0 { namespace drivers {
 
+//! A breadth-first search that prunes all nodes with novelty greater than some width k, for k > 2, for which there is
+//! no specialized novelty evaluator; the tuples of each width are kept in hash sets instead.
+//! Duplicate states are pruned by the novelty test itself. The search raises the same events as the lapkt
+//! breadth-first search, so that it can be observed by the same handlers.
+template <typename NodeT, typename StateModelT, typename FeatureSetT>
+class TupleIWSearch : public lapkt::events::Subject {
+public:
+	using PlanT = std::vector<typename StateModelT::ActionType::IdType>;
+	using NodePT = std::shared_ptr<NodeT>;
+
+	//! Relevant events
+	using NodeOpenEvent = lapkt::events::NodeOpenEvent<NodeT>;
+	using GoalFoundEvent = lapkt::events::GoalFoundEvent<NodeT>;
+	using NodeExpansionEvent = lapkt::events::NodeExpansionEvent<NodeT>;
+	using NodeCreationEvent = lapkt::events::NodeCreationEvent<NodeT>;
+	using NodeGenerationEvent = lapkt::events::NodeGenerationEvent<NodeT>;
+
+	TupleIWSearch(const StateModelT& model, const FeatureSetT& featureset, unsigned width, bool ignore_neg_literals) :
+		_model(model), _featureset(featureset), _width(width), _evaluator(width, ignore_neg_literals)
+	{}
+
+	virtual ~TupleIWSearch() = default;
+
+	TupleIWSearch(const TupleIWSearch&) = delete;
+	TupleIWSearch(TupleIWSearch&&) = default;
+	TupleIWSearch& operator=(const TupleIWSearch&) = delete;
+	TupleIWSearch& operator=(TupleIWSearch&&) = delete;
+
+	bool search(const State& seed, PlanT& solution) {
+		NodePT root = std::make_shared<NodeT>(seed);
+		this->notify(NodeCreationEvent(*root));
+		if (_model.goal(root->state)) {
+			this->notify(GoalFoundEvent(*root));
+			return true;
+		}
+		_evaluator.evaluate(_featureset.evaluate(root->state));
+
+		std::deque<NodePT> open{root};
+		while (!open.empty()) {
+			NodePT current = open.front();
+			open.pop_front();
+			this->notify(NodeOpenEvent(*current));
+			this->notify(NodeExpansionEvent(*current));
+
+			const auto& parent_valuation = _featureset.evaluate(current->state);
+			for (const auto& action:_model.applicable_actions(current->state)) {
+				State s_a = _model.next(current->state, action);
+				NodePT successor = std::make_shared<NodeT>(std::move(s_a), action, current);
+				this->notify(NodeCreationEvent(*successor));
+				this->notify(NodeGenerationEvent(*successor));
+
+				if (_model.goal(successor->state)) {
+					this->notify(GoalFoundEvent(*successor));
+					report_tuple_tables();
+					for (NodePT node = successor; node->has_parent(); node = node->parent) solution.push_back(node->action);
+					std::reverse(solution.begin(), solution.end());
+					return true;
+				}
+
+				if (_evaluator.evaluate(_featureset.evaluate(successor->state), &parent_valuation) <= _width) {
+					open.push_back(successor);
+				}
+			}
+		}
+
+		report_tuple_tables();
+		return false;
+	}
+
+protected:
+	const StateModelT& _model;
+
+	const FeatureSetT& _featureset;
+
+	const unsigned _width;
+
+	bfws::TupleNoveltyEvaluator _evaluator;
+
+	void report_tuple_tables() const {
+		for (unsigned k = 1; k <= _evaluator.max_width(); ++k) {
+			const auto& table = _evaluator.table(k);
+			LPT_INFO("search", "IW: Width-" << k << " tuple table: " << table.size() << " tuples, " << table.bytes() / 1024 << " kB");
+		}
+	}
+};
+
+
 //! The original IW algorithm, adapted to FStrips
 template <typename StateModelT, typename FeatureSetT, typename NoveltyEvaluatorT>
 class FS0IWAlgorithm {
@@ -39,8 +130,12 @@ public:
 
 	using NoveltyEvaluatorPT = std::unique_ptr<NoveltyEvaluatorT>;
 
-	FS0IWAlgorithm(const StateModelT& model, unsigned initial_max_width, unsigned final_max_width, FeatureSetT&& featureset, NoveltyEvaluatorT* evaluator_prototype, SearchStats& stats)
-		: _model(model), _featureset(std::move(featureset)), _evaluator_prototype(evaluator_prototype), _algorithm(nullptr) , _current_max_width(initial_max_width), _final_max_width(final_max_width), _stats(stats)
+	//! The breadth-first search used for widths above 2
+	using TupleIWSearchT = TupleIWSearch<NodeT, StateModelT, FeatureSetT>;
+
+	//! The evaluator prototype is used for widths up to 2; higher widths are run with tuple hash sets
+	FS0IWAlgorithm(const StateModelT& model, unsigned initial_max_width, unsigned final_max_width, FeatureSetT&& featureset, NoveltyEvaluatorT* evaluator_prototype, SearchStats& stats, bool ignore_neg_literals = true)
+		: _model(model), _featureset(std::move(featureset)), _evaluator_prototype(evaluator_prototype), _algorithm(nullptr) , _current_max_width(initial_max_width), _final_max_width(final_max_width), _ignore_neg_literals(ignore_neg_literals), _stats(stats)
 	{
 		EventUtils::setup_stats_observer<NodeT>(_stats, _handlers);
 		setup_base_algorithm(_current_max_width);
@@ -56,9 +151,16 @@ public:
 	bool search(const State& state, PlanT& solution) {
 		while(_current_max_width <= _final_max_width) {
 			LPT_INFO("search", "IW: Starting search with novelty bound of " << _current_max_width);
-			if(_algorithm->search(state, solution)) return true;
+			if (_current_max_width > 2) {
+				TupleIWSearchT tuple_search(_model, _featureset, _current_max_width, _ignore_neg_literals);
+				lapkt::events::subscribe(tuple_search, _handlers);
+				if (tuple_search.search(state, solution)) return true;
+			} else if(_algorithm->search(state, solution)) return true;
+
+			LPT_INFO("search", "IW: Finished search with novelty bound of " << _current_max_width << ". Expanded / generated nodes so far: "
+								<< _stats.expanded() << " / " << _stats.generated() << ". Mem. usage: " << get_current_memory_in_kb() << " kB.");
 			++_current_max_width;
-			setup_base_algorithm(_current_max_width);
+			if (_current_max_width <= 2) setup_base_algorithm(_current_max_width);
 			solution.clear();
 		}
 		return false;
@@ -97,6 +199,9 @@ protected:
 	//!
 	unsigned _final_max_width;
 
+	//! Whether the tuple tables used for widths > 2 ignore negative boolean atoms
+	bool _ignore_neg_literals;
+
 	//!
 	std::vector<std::unique_ptr<lapkt::events::EventHandler>> _handlers;
 
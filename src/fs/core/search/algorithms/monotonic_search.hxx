@@ -51,6 +51,7 @@ public:
 
 	virtual bool _search(const StateT& s, PlanT& solution) {
 		NodePT n = std::make_shared<NodeT>(s, _generated++);
+		n->unachieved_subgoals = _goalcounter.evaluate(n->state);
 		this->notify(NodeCreationEvent(*n));
 
 
@@ -115,7 +116,8 @@ public:
 
                 if (successor->dead_end()) ++_num_deadends;
 
-				successor->unachieved_subgoals = _goalcounter.evaluate(successor->state);
+				// The changeset is still that of the state of the successor, as no other state has been generated since
+				successor->unachieved_subgoals = _goalcounter.evaluate(successor->state, current->state, current->unachieved_subgoals, _model.get_last_changeset());
 
 				_open.insert(successor);
 			}
@@ -136,6 +138,10 @@ public:
     bool search(const StateT& s, PlanT& solution) {
         auto res = _search(s, solution);
         LPT_INFO("cout", "Nodes pruned by monotonicity constraints: " << _num_pruned);
+        if (_monotonicity_csp_manager) {
+            LPT_INFO("cout", "Monotonicity CSPs propagated natively / by Gecode: " << _monotonicity_csp_manager->native_nodes()
+                             << " / " << _monotonicity_csp_manager->gecode_nodes());
+        }
         LPT_INFO("cout", "Number of deadends: " << _num_deadends);
         return res;
     }
@@ -148,7 +154,9 @@ public:
 protected:
 	
 	virtual bool check_goal(const NodePT& node, PlanT& solution) {
-		if ( _model.goal(node->state)) { // Solution found, we're done
+		// With a conjunctive goal, the number of unachieved goal atoms already tells whether the node is a goal
+		bool is_goal = _goalcounter.is_atomic() ? (node->unachieved_subgoals == 0) : _model.goal(node->state);
+		if (is_goal) { // Solution found, we're done
 			this->notify(GoalFoundEvent(*node));
 			retrieve_solution(node, solution);
 			return true;
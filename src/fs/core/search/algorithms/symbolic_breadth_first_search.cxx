@@ -0,0 +1,351 @@
+
+#include <fs/core/search/algorithms/symbolic_breadth_first_search.hxx>
+
+#include <fs/core/actions/actions.hxx>
+#include <fs/core/actions/simple_lifted_operators.hxx>
+#include <fs/core/languages/fstrips/language.hxx>
+#include <fs/core/models/sdd_lifted_state_model.hxx>
+#include <fs/core/problem.hxx>
+#include <fs/core/problem_info.hxx>
+#include <fs/core/state.hxx>
+#include <fs/core/utils/printers/helper.hxx>
+#include <fs/core/utils/sdd.hxx>
+#include <fs/core/utils/system.hxx>
+#include <lapkt/tools/logging.hxx>
+
+#include <sdd/sddapi.hxx>
+
+#include <algorithm>
+#include <stdexcept>
+
+
+namespace fs0 {
+
+SymbolicBreadthFirstSearch::SymbolicBreadthFirstSearch(const SDDLiftedStateModel& model, const ProblemInfo& info) :
+    _problem(model.getTask()),
+    _info(info),
+    _num_state_vars(info.getNumVariables()),
+    _num_param_vars(0),
+    _manager(nullptr),
+    _goal(nullptr)
+{
+    if (!_problem.getStateAtomIndexer().is_fully_binary()) {
+        throw std::runtime_error("Symbolic search is only supported for problems with binary state variables");
+    }
+
+    const auto& sdds = model.get_sdds();
+    for (const auto& sdd:sdds) {
+        for (const auto& param:sdd->get_parameter_bindings()) _num_param_vars += param.size();
+    }
+
+    // Parameter variables go first, and then the current- and next-state variables of each state variable,
+    // interleaved, which tends to keep the transition relations small
+    LiteralT nvars = _num_param_vars + 2 * _num_state_vars;
+    Vtree* vtree = sdd_vtree_new(nvars, "right");
+    _manager = sdd_manager_new(vtree);
+    sdd_vtree_free(vtree); // The manager keeps its own copy of the vtree
+
+    _exists_map.assign(nvars + 1, 0);
+    _rename_map.resize(nvars + 1);
+    for (LiteralT var = 0; var <= nvars; ++var) _rename_map[var] = var;
+    for (LiteralT var = 1; var <= _num_param_vars; ++var) _exists_map[var] = 1;
+    for (VariableIdx v = 0; v < _num_state_vars; ++v) {
+        _exists_map[x(v)] = 1;
+        _rename_map[x(v)] = y(v);
+        _rename_map[y(v)] = x(v);
+    }
+
+    LiteralT first_param_var = 1;
+    for (const auto& sdd:sdds) {
+        _transitions.push_back(build_transition(*sdd, first_param_var));
+        for (const auto& param:sdd->get_parameter_bindings()) first_param_var += param.size();
+        LPT_INFO("cout", "Transition relation of action schema \"" << sdd->get_schema().getName() << "\" has size "
+                         << sdd_size(_transitions.back().relation));
+    }
+
+    _goal = encode_goal();
+    sdd_ref(_goal, _manager);
+}
+
+SymbolicBreadthFirstSearch::~SymbolicBreadthFirstSearch() {
+    sdd_manager_free(_manager); // This frees all nodes
+}
+
+SddNode* SymbolicBreadthFirstSearch::literal(LiteralT lit) const { return sdd_manager_literal(lit, _manager); }
+SddNode* SymbolicBreadthFirstSearch::conjoin(SddNode* lhs, SddNode* rhs) const { return sdd_conjoin(lhs, rhs, _manager); }
+SddNode* SymbolicBreadthFirstSearch::disjoin(SddNode* lhs, SddNode* rhs) const { return sdd_disjoin(lhs, rhs, _manager); }
+
+SddNode* SymbolicBreadthFirstSearch::equiv(SddNode* lhs, SddNode* rhs) const {
+    return disjoin(conjoin(lhs, rhs), conjoin(sdd_negate(lhs, _manager), sdd_negate(rhs, _manager)));
+}
+
+SddNode* SymbolicBreadthFirstSearch::exactly_one(const std::vector<std::pair<object_id, LiteralT>>& values) const {
+    SddNode* none = sdd_manager_true(_manager); // No value seen so far is true
+    SddNode* one = sdd_manager_false(_manager); // Exactly one value seen so far is true
+    for (const auto& value:values) {
+        SddNode* lit = literal(value.second);
+        SddNode* neg = literal(-value.second);
+        one = disjoin(conjoin(one, neg), conjoin(none, lit));
+        none = conjoin(none, neg);
+    }
+    return one;
+}
+
+SddNode* SymbolicBreadthFirstSearch::translate(SddNode* node, const std::unordered_map<LiteralT, LiteralT>& varmap,
+                                               std::unordered_map<std::size_t, SddNode*>& cache) {
+    if (sdd_node_is_true(node)) return sdd_manager_true(_manager);
+    if (sdd_node_is_false(node)) return sdd_manager_false(_manager);
+
+    auto it = cache.find(sdd_id(node));
+    if (it != cache.end()) return it->second;
+
+    SddNode* result;
+    if (sdd_node_is_literal(node)) {
+        LiteralT lit = sdd_node_literal(node);
+        LiteralT var = varmap.at(std::abs(lit));
+        result = literal(lit > 0 ? var : -var);
+
+    } else {
+        assert(sdd_node_is_decision(node));
+        result = sdd_manager_false(_manager);
+        SddNode** elements = sdd_node_elements(node);
+        for (SddSize i = 0, n = sdd_node_size(node); i < n; ++i) {
+            SddNode* prime = translate(elements[2*i], varmap, cache);
+            SddNode* sub = translate(elements[2*i+1], varmap, cache);
+            result = disjoin(result, conjoin(prime, sub));
+        }
+    }
+
+    cache.emplace(sdd_id(node), result);
+    return result;
+}
+
+SymbolicBreadthFirstSearch::Transition
+SymbolicBreadthFirstSearch::build_transition(ActionSchemaSDD& sdd, LiteralT first_param_var) {
+    const auto& schema = sdd.get_schema();
+    Transition transition{&schema, nullptr, {}};
+
+    // Map the variables of the SDD of the schema into ours. Any other variable of the SDD is auxiliary,
+    // and is quantified away before the translation.
+    std::unordered_map<LiteralT, LiteralT> varmap;
+    for (const auto& atom:sdd.get_relevant_atoms()) varmap.emplace(atom.second, x(atom.first));
+
+    LiteralT var = first_param_var;
+    for (const auto& param:sdd.get_parameter_bindings()) {
+        transition.params.emplace_back();
+        for (const auto& value:param) {
+            varmap.emplace(value.second, var);
+            transition.params.back().emplace_back(value.first, var);
+            ++var;
+        }
+    }
+
+    SddNode* precondition = sdd.node();
+    unsigned local_vars = sdd.var_count();
+    std::vector<int> auxiliary(local_vars + 1, 0);
+    bool has_auxiliary = false;
+    for (unsigned i = 1; i <= local_vars; ++i) {
+        if (varmap.find(i) == varmap.end()) auxiliary[i] = has_auxiliary = true;
+    }
+    if (has_auxiliary) precondition = sdd_exists_multiple(auxiliary.data(), precondition, sdd.manager());
+
+    std::unordered_map<std::size_t, SddNode*> cache;
+    SddNode* relation = translate(precondition, varmap, cache);
+    for (const auto& param:transition.params) relation = conjoin(relation, exactly_one(param));
+
+    // Now the effects, which will be of the form y_v <-> add_v or (x_v and not del_v), where add_v (del_v) is the
+    // disjunction of the bindings of the schema parameters that make the schema add (delete) the atom v
+    std::vector<SddNode*> add(_num_state_vars, nullptr), del(_num_state_vars, nullptr);
+    const SimpleLiftedOperator op = compile_schema_to_simple_lifted_operator(schema);
+    for (const auto& effect:op.effects) {
+        if (!effect.condition.simpleeqs.empty() || !effect.condition.fluents.empty()) {
+            throw std::runtime_error(fs0::printer() << "Symbolic search does not support conditional effects. Action: " << schema);
+        }
+
+        const auto& atom = effect.atom;
+        if (atom.value.type != SimpleLiftedOperator::term_t::constant) {
+            throw std::runtime_error(fs0::printer() << "Symbolic search only supports effects with constant values. Action: " << schema);
+        }
+        bool is_add = fs0::value<bool>(atom.value.val.o);
+
+        // Enumerate all possible values of the parameters appearing in the head of the effect
+        std::vector<unsigned> head_params;
+        for (const auto& arg:atom.arguments) {
+            if (arg.type == SimpleLiftedOperator::term_t::var) head_params.push_back(arg.val.varidx);
+        }
+
+        std::vector<unsigned> idx(head_params.size(), 0);
+        std::vector<object_id> args(atom.arguments.size());
+        while (true) {
+            SddNode* selector = sdd_manager_true(_manager);
+            for (std::size_t k = 0, j = 0; k < atom.arguments.size(); ++k) {
+                const auto& arg = atom.arguments[k];
+                if (arg.type == SimpleLiftedOperator::term_t::constant) { args[k] = arg.val.o; continue; }
+                const auto& value = transition.params.at(arg.val.varidx).at(idx[j++]);
+                args[k] = value.first;
+                selector = conjoin(selector, literal(value.second));
+            }
+
+            // Bindings that give rise to non-fluent atoms are filtered out by the precondition of the schema
+            const auto& index = _info.get_fluent_index();
+            auto it = index.find(std::make_pair(atom.predicate_id, args));
+            if (it != index.end()) {
+                auto& target = is_add ? add[it->second] : del[it->second];
+                target = target ? disjoin(target, selector) : selector;
+            }
+
+            // Advance to the next combination of values of the head parameters
+            std::size_t j = 0;
+            for (; j < idx.size(); ++j) {
+                if (++idx[j] < transition.params.at(head_params[j]).size()) break;
+                idx[j] = 0;
+            }
+            if (j == idx.size()) break;
+        }
+    }
+
+    for (VariableIdx v = 0; v < _num_state_vars; ++v) {
+        SddNode* next = literal(x(v));
+        if (del[v]) next = conjoin(next, sdd_negate(del[v], _manager));
+        if (add[v]) next = disjoin(next, add[v]);
+        relation = conjoin(relation, equiv(literal(y(v)), next));
+    }
+
+    transition.relation = relation;
+    sdd_ref(transition.relation, _manager);
+    return transition;
+}
+
+SddNode* SymbolicBreadthFirstSearch::encode_state(const State& state) const {
+    SddNode* cube = sdd_manager_true(_manager);
+    for (VariableIdx v = 0; v < _num_state_vars; ++v) {
+        cube = conjoin(cube, literal(fs0::value<bool>(state.getValue(v)) ? x(v) : -x(v)));
+    }
+    return cube;
+}
+
+SddNode* SymbolicBreadthFirstSearch::encode_goal() const {
+    const fs::Formula* goal = _problem.getGoalConditions();
+    if (dynamic_cast<const fs::Tautology*>(goal)) return sdd_manager_true(_manager);
+
+    std::vector<const fs::Formula*> conjuncts{goal};
+    if (const auto* conjunction = dynamic_cast<const fs::Conjunction*>(goal)) conjuncts = conjunction->getSubformulae();
+
+    SddNode* result = sdd_manager_true(_manager);
+    for (const fs::Formula* conjunct:conjuncts) {
+        const auto* atom = dynamic_cast<const fs::RelationalFormula*>(conjunct);
+        const auto* lhs = atom ? dynamic_cast<const fs::StateVariable*>(atom->lhs()) : nullptr;
+        const auto* rhs = atom ? dynamic_cast<const fs::Constant*>(atom->rhs()) : nullptr;
+        if (!lhs || !rhs || (atom->symbol() != fs::RelationalFormula::Symbol::EQ && atom->symbol() != fs::RelationalFormula::Symbol::NEQ)) {
+            throw std::runtime_error(fs0::printer() << "Symbolic search only supports goals that are conjunctions of atoms. Goal: " << *goal);
+        }
+
+        bool value = fs0::value<bool>(rhs->getValue());
+        if (atom->symbol() == fs::RelationalFormula::Symbol::NEQ) value = !value;
+        result = conjoin(result, literal(value ? x(lhs->getValue()) : -x(lhs->getValue())));
+    }
+    return result;
+}
+
+SddNode* SymbolicBreadthFirstSearch::image(SddNode* states) const {
+    SddNode* result = sdd_manager_false(_manager);
+    for (const auto& transition:_transitions) {
+        SddNode* successors = sdd_exists_multiple(const_cast<int*>(_exists_map.data()), conjoin(states, transition.relation), _manager);
+        result = disjoin(result, successors);
+    }
+    // The result is over next-state variables only, which we rename back to current-state variables
+    return sdd_rename_variables(result, const_cast<LiteralT*>(_rename_map.data()), _manager);
+}
+
+bool SymbolicBreadthFirstSearch::solve_model(PlanT& plan) {
+    SddNode* layer = encode_state(_problem.getInitialState());
+    SddNode* reached = layer;
+    sdd_ref(reached, _manager);
+
+    std::vector<SddNode*> layers;
+    while (true) {
+        sdd_ref(layer, _manager);
+        layers.push_back(layer);
+
+        SddNode* goal_states = conjoin(layer, _goal);
+        if (!sdd_node_is_false(goal_states)) {
+            LPT_INFO("cout", "Goal found at depth " << layers.size() - 1);
+            reconstruct(layers, goal_states, plan);
+            return true;
+        }
+
+        SddNode* next = conjoin(image(layer), sdd_negate(reached, _manager));
+        if (sdd_node_is_false(next)) return false;
+
+        SddNode* updated = disjoin(reached, next);
+        sdd_ref(updated, _manager);
+        sdd_deref(reached, _manager);
+        reached = updated;
+        layer = next;
+
+        sdd_ref(layer, _manager);
+        sdd_manager_garbage_collect(_manager);
+        sdd_deref(layer, _manager);
+
+        LPT_INFO("cout", "Layer " << layers.size() << " computed. SDD size: " << sdd_size(layer)
+                         << ", reached states SDD size: " << sdd_size(reached)
+                         << ". Mem. usage: " << get_current_memory_in_kb() << "kB.");
+    }
+}
+
+SddNode* SymbolicBreadthFirstSearch::pick(SddNode* node, LiteralT var, bool& value) const {
+    SddNode* result = sdd_condition(var, node, _manager);
+    value = !sdd_node_is_false(result);
+    return value ? result : sdd_condition(-var, node, _manager);
+}
+
+void SymbolicBreadthFirstSearch::reconstruct(const std::vector<SddNode*>& layers, SddNode* goal_states, PlanT& plan) const {
+    // Pick any goal state, and then go backwards picking at each layer some state and action that lead to the state
+    // picked in the next layer. Any predecessor of a state first reached in layer i+1 must have been reached in layer i.
+    std::vector<bool> target(_num_state_vars), source(_num_state_vars);
+    SddNode* node = goal_states;
+    for (VariableIdx v = 0; v < _num_state_vars; ++v) {
+        bool value;
+        node = pick(node, x(v), value);
+        target[v] = value;
+    }
+
+    plan.clear();
+    for (std::size_t i = layers.size() - 1; i > 0; --i) {
+        SddNode* next = sdd_manager_true(_manager);
+        for (VariableIdx v = 0; v < _num_state_vars; ++v) next = conjoin(next, literal(target[v] ? y(v) : -y(v)));
+
+        bool found = false;
+        for (const auto& transition:_transitions) {
+            SddNode* candidates = conjoin(conjoin(layers[i-1], transition.relation), next);
+            if (sdd_node_is_false(candidates)) continue;
+
+            for (VariableIdx v = 0; v < _num_state_vars; ++v) {
+                bool value;
+                candidates = pick(candidates, x(v), value);
+                source[v] = value;
+            }
+
+            std::vector<object_id> binding;
+            for (const auto& param:transition.params) {
+                for (const auto& value:param) {
+                    bool selected;
+                    candidates = pick(candidates, value.second, selected);
+                    if (selected) binding.push_back(value.first);
+                }
+            }
+            assert(binding.size() == transition.params.size());
+
+            plan.emplace_back(transition.schema, std::move(binding));
+            std::swap(target, source);
+            found = true;
+            break;
+        }
+
+        if (!found) throw std::runtime_error("Symbolic search: could not reconstruct the plan from the search layers");
+    }
+
+    std::reverse(plan.begin(), plan.end());
+}
+
+} // namespaces
@@ -0,0 +1,106 @@
+
+#pragma once
+
+#include <unordered_map>
+#include <vector>
+
+#include <fs/core/fs_types.hxx>
+#include <fs/core/actions/action_id.hxx>
+
+// Forward-declare the basic SddNode and SDDManager typedefs from the SDD API
+struct sdd_node_t; typedef struct sdd_node_t SddNode;
+struct sdd_manager_t; typedef struct sdd_manager_t SddManager;
+
+namespace fs0 {
+
+class ActionSchemaSDD;
+class PartiallyGroundedAction;
+class Problem;
+class ProblemInfo;
+class SDDLiftedStateModel;
+class State;
+
+//! A breadth-first search that represents sets of states as SDDs, over a single SDD manager with one "current"
+//! variable x_v and one "next" variable y_v per (binary) state variable v, plus one variable per possible value of
+//! each action schema parameter. Each action schema is given a transition relation T(x, p, y), made up of the
+//! precondition SDD of the schema, translated from its own manager, the effects of the schema on y, and the frame
+//! axioms y_v <-> x_v for those variables that the schema does not affect. The states reached at each layer are
+//! computed at once as the image of the previous layer, and the plan is then recovered by picking one concrete
+//! state and action from each layer, going backwards from the first layer that contains goal states.
+//! Only STRIPS-like problems are supported: binary state variables, no conditional effects, and goals that are
+//! conjunctions of atoms.
+class SymbolicBreadthFirstSearch {
+public:
+    using PlanT = std::vector<LiftedActionID>;
+
+    SymbolicBreadthFirstSearch(const SDDLiftedStateModel& model, const ProblemInfo& info);
+    ~SymbolicBreadthFirstSearch();
+
+    SymbolicBreadthFirstSearch(const SymbolicBreadthFirstSearch&) = delete;
+    SymbolicBreadthFirstSearch(SymbolicBreadthFirstSearch&&) = delete;
+    SymbolicBreadthFirstSearch& operator=(const SymbolicBreadthFirstSearch&) = delete;
+    SymbolicBreadthFirstSearch& operator=(SymbolicBreadthFirstSearch&&) = delete;
+
+    //! Return true iff a plan is found, in which case it is left in 'plan'
+    bool solve_model(PlanT& plan);
+
+protected:
+    //! SDD literals, as in the SDD API
+    using LiteralT = long;
+
+    //! The transition relation of a single action schema
+    struct Transition {
+        const PartiallyGroundedAction* schema;
+        SddNode* relation;
+        //! 'params[i]' holds the pairs (object, SDD variable) for each possible value of the i-th parameter
+        std::vector<std::vector<std::pair<object_id, LiteralT>>> params;
+    };
+
+    const Problem& _problem;
+
+    const ProblemInfo& _info;
+
+    unsigned _num_state_vars;
+
+    LiteralT _num_param_vars;
+
+    SddManager* _manager;
+
+    std::vector<Transition> _transitions;
+
+    //! The variables to be quantified away when computing an image: all x and parameter variables
+    std::vector<int> _exists_map;
+
+    //! The renaming of next-state into current-state variables, and vice versa
+    std::vector<LiteralT> _rename_map;
+
+    SddNode* _goal;
+
+    LiteralT x(VariableIdx v) const { return _num_param_vars + 2 * v + 1; }
+    LiteralT y(VariableIdx v) const { return _num_param_vars + 2 * v + 2; }
+
+    //! Build the transition relation of the given schema, whose parameter variables start at 'first_param_var'
+    Transition build_transition(ActionSchemaSDD& sdd, LiteralT first_param_var);
+
+    //! Translate a node from the SDD manager of a schema into our manager, with the given mapping of variables
+    SddNode* translate(SddNode* node, const std::unordered_map<LiteralT, LiteralT>& varmap, std::unordered_map<std::size_t, SddNode*>& cache);
+
+    SddNode* literal(LiteralT lit) const;
+    SddNode* conjoin(SddNode* lhs, SddNode* rhs) const;
+    SddNode* disjoin(SddNode* lhs, SddNode* rhs) const;
+    SddNode* equiv(SddNode* lhs, SddNode* rhs) const;
+    SddNode* exactly_one(const std::vector<std::pair<object_id, LiteralT>>& values) const;
+
+    SddNode* encode_state(const State& state) const;
+    SddNode* encode_goal() const;
+
+    //! The states reachable from the given set of states through a single action
+    SddNode* image(SddNode* states) const;
+
+    //! Restrict the given node to some value of the given variable, which is stored in 'value'
+    SddNode* pick(SddNode* node, LiteralT var, bool& value) const;
+
+    void reconstruct(const std::vector<SddNode*>& layers, SddNode* goal_states, PlanT& plan) const;
+};
+
+} // namespaces
@@ -28,6 +28,18 @@ BreadthFirstSearchDriver<SDDLiftedStateModel>::setup(Problem& problem) const {
     return GroundingSetup::sdd_lifted_model(problem);
 }
 
+template <>
+JoinLiftedStateModel
+BreadthFirstSearchDriver<JoinLiftedStateModel>::setup(Problem& problem) const {
+	return GroundingSetup::join_lifted_model(problem);
+}
+
+template <>
+HybridStateModel
+BreadthFirstSearchDriver<HybridStateModel>::setup(Problem& problem) const {
+	return GroundingSetup::hybrid_model(problem);
+}
+
 template <typename StateModelT>
 ExitCode
 BreadthFirstSearchDriver<StateModelT>::search(Problem& problem, const Config& config, const EngineOptions& options, float start_time) {
@@ -45,5 +57,7 @@ BreadthFirstSearchDriver<StateModelT>::search(Problem& problem, const Config& co
 template class BreadthFirstSearchDriver<GroundStateModel>;
 template class BreadthFirstSearchDriver<CSPLiftedStateModel>;
 template class BreadthFirstSearchDriver<SDDLiftedStateModel>;
+template class BreadthFirstSearchDriver<JoinLiftedStateModel>;
+template class BreadthFirstSearchDriver<HybridStateModel>;
 
 } // namespaces
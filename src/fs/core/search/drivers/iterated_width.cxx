@@ -24,8 +24,11 @@ create(const Config& config, FeatureEvaluatorT&& featureset, const StateModelT&
 //	assert(0); // TO REIMPLEMENT
 // 	auto evaluator = fs0::bfws::create_novelty_evaluator<NoveltyEvaluatorT>(model.getTask(), fs0::bfws::SBFWSConfig::NoveltyEvaluatorType::Adaptive, max_novelty);
 //	auto evaluator = nullptr;
-	bfws::NoveltyFactory<FeatureValueT> factory(model.getTask(), bfws::SBFWSConfig::NoveltyEvaluatorType::Generic, true, max_novelty);
-	return EnginePT(new EngineT(model, 1, max_novelty, std::move(featureset), factory.create_evaluator(max_novelty), stats));
+	// Widths above 2 are handled by the engine itself, with tuple hash sets
+	unsigned prototype_novelty = std::min(max_novelty, 2u);
+	bool ignore_neg_literals = config.getOption<bool>("ignore_neg_literals", true);
+	bfws::NoveltyFactory<FeatureValueT> factory(model.getTask(), bfws::SBFWSConfig::NoveltyEvaluatorType::Generic, true, prototype_novelty);
+	return EnginePT(new EngineT(model, 1, max_novelty, std::move(featureset), factory.create_evaluator(prototype_novelty), stats, ignore_neg_literals));
 }
 
 
@@ -36,6 +36,13 @@ NativeActionDriver<UnsatisfiedGoalAtomsCounter>::configure_heuristic(const Probl
     return new UnsatisfiedGoalAtomsCounter(problem.getGoalConditions(), problem.get_tuple_index());
 }
 
+template <>
+UnaryRelaxedHeuristic*
+NativeActionDriver<UnaryRelaxedHeuristic>::configure_heuristic(const Problem& problem, const Config& config) {
+	auto type = UnaryRelaxedHeuristic::parse_type(config.getOption<std::string>("native.heuristic", "hff"));
+	return new UnaryRelaxedHeuristic(problem, type, config.getOption<bool>("native.incremental", false));
+}
+
 
 template <typename HeuristicT>
 typename NativeActionDriver<HeuristicT>::EnginePT
@@ -73,5 +80,6 @@ NativeActionDriver<HeuristicT>::search(Problem& problem, const Config& config, c
 
 template class NativeActionDriver<gecode::NativeRPG>;
 template class NativeActionDriver<UnsatisfiedGoalAtomsCounter>;
+template class NativeActionDriver<UnaryRelaxedHeuristic>;
 
 } } // namespaces
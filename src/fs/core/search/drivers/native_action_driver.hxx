@@ -13,6 +13,7 @@
 #include <fs/core/search/algorithms/monotonic_search.hxx>
 #include <fs/core/constraints/native/action_handler.hxx>
 #include <fs/core/heuristics/relaxed_plan/native_rpg.hxx>
+#include <fs/core/heuristics/relaxed_plan/unary_relaxed_heuristic.hxx>
 #include <fs/core/heuristics/unsat_goal_atoms.hxx>
 
 namespace fs0 { class GroundStateModel; class SearchStats; }
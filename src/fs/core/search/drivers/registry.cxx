@@ -4,6 +4,7 @@
 // #include <fs/core/search/drivers/gbfs_constrained.hxx>
 #include <fs/core/search/drivers/iterated_width.hxx>
 #include <fs/core/search/drivers/breadth_first_search.hxx>
+#include <fs/core/search/drivers/symbolic_breadth_first_search.hxx>
 #include <fs/core/search/drivers/sbfws/sbfws.hxx>
 // #include <fs/core/search/drivers/unreached_atom_driver.hxx>
 // #include <fs/core/search/drivers/native_driver.hxx>
@@ -39,6 +40,7 @@ EngineRegistry::EngineRegistry() {
 
 	add("native",  new NativeActionDriver<>());
 	add("native_gc",  new NativeActionDriver<UnsatisfiedGoalAtomsCounter>());
+	add("native_unary",  new NativeActionDriver<UnaryRelaxedHeuristic>());
 	
 	add("iw",  new IteratedWidthDriver<GroundStateModel>());
 	add("iw-csp",  new IteratedWidthDriver<CSPLiftedStateModel>());
@@ -46,10 +48,15 @@ EngineRegistry::EngineRegistry() {
 	add("bfws",  new bfws::SBFWSDriver<SimpleStateModel>());
 	add("bfws-csp",  new bfws::SBFWSDriver<CSPLiftedStateModel>());
     add("bfws-sdd",  new bfws::SBFWSDriver<SDDLiftedStateModel>());
+	add("bfws-join",  new bfws::SBFWSDriver<JoinLiftedStateModel>());
+	add("bfws-hybrid",  new bfws::SBFWSDriver<HybridStateModel>());
 	
 	add("bfs",  new BreadthFirstSearchDriver<GroundStateModel>());
 	add("bfs-csp",  new BreadthFirstSearchDriver<CSPLiftedStateModel>());
     add("bfs-sdd",  new BreadthFirstSearchDriver<SDDLiftedStateModel>());
+	add("bfs-join",  new BreadthFirstSearchDriver<JoinLiftedStateModel>());
+	add("bfs-hybrid",  new BreadthFirstSearchDriver<HybridStateModel>());
+	add("bfs-symbolic",  new SymbolicBreadthFirstSearchDriver());
 	
 	add("smart",  new SmartEffectDriver());
 	add("lsmart",  new SmartLiftedDriver());
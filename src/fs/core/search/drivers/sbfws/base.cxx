@@ -77,6 +77,25 @@ NoveltyFactory<FeatureValueT>::create_evaluator(unsigned width) const {
     }
 }
 
+template <typename FeatureValueT>
+typename NoveltyFactory<FeatureValueT>::NoveltyEvaluatorT*
+NoveltyFactory<FeatureValueT>::create_growable_evaluator(unsigned width) const {
+    return new GenericEvaluator(width);
+}
+
+template <typename FeatureValueT>
+std::size_t NoveltyFactory<FeatureValueT>::
+expected_evaluator_size(unsigned width) const {
+    auto ev_type = _chosen_evaluator_t[width];
+    if (ev_type ==  ChosenEvaluatorT::W1Atom) {
+        return W1AtomEvaluator::expected_size(_indexer.num_indexes());
+
+    } else if (ev_type ==  ChosenEvaluatorT::W2Atom) {
+        return W2AtomEvaluator::expected_size(_indexer.num_indexes());
+    }
+    return 0;
+}
+
 template <typename FeatureValueT>
 typename NoveltyFactory<FeatureValueT>::NoveltyEvaluatorT*
 NoveltyFactory<FeatureValueT>::create_compound_evaluator(unsigned max_width) const {
@@ -23,6 +23,17 @@ struct SBFWSNoveltyIndexer {
     std::tuple<unsigned, unsigned> relevant(unsigned unachieved, unsigned relaxed_achieved) const {
         return std::make_tuple(unachieved, relaxed_achieved);
     }
+
+    //! The type of the nodes with the given #g whose #r is only provisional, which is not that of any <#g, #r> pair
+    unsigned provisional(unsigned unachieved) const { return _index(unachieved, PROVISIONAL_R); }
+
+    bool is_provisional(unsigned type) const { return (type & 0xFFFF) == PROVISIONAL_R; }
+
+    //! The #r of the given type
+    unsigned relaxed_achieved(unsigned type) const { return type & 0xFFFF; }
+
+protected:
+    static const unsigned PROVISIONAL_R = 0xFFFF;
 };
 
 //! The NoveltyFactory decides what type of novelty evaluator, how many levels of search
@@ -59,6 +70,14 @@ public:
 
     NoveltyEvaluatorT* create_compound_evaluator(unsigned max_width) const;
 
+    //! Create a width-k evaluator whose tables start empty and grow on demand, whatever the evaluator
+    //! chosen for that width
+    NoveltyEvaluatorT* create_growable_evaluator(unsigned width) const;
+
+    //! Return the expected size in bytes of the width-k evaluators created by the factory, or 0
+    //! if the size is not known in advance, i.e. for generic evaluators, whose tables grow on demand.
+    std::size_t expected_evaluator_size(unsigned width) const;
+
 protected:
     //! Check whether the size of an optimized atom-evaluator for the given width is small enough,
     //! according to some fixed constants, to make it worthy.
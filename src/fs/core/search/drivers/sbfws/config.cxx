@@ -10,11 +10,15 @@ SBFWSConfig::SBFWSConfig(const Config& config) :
     simulation_width(config.getOption<int>("width.simulation", 1)),
     mark_negative_propositions(config.getOption<bool>("simulation.neg_prop", false)),
     using_feature_set(config.getOption<bool>("bfws.using_feature_set", false)),
+    simulation_threads(config.getOption<unsigned>("sim.threads", 0)),
+    simulation_cache_size(config.getOption<unsigned>("sim.r_cache", 0)),
     _global_config(config)
 {
     LPT_INFO("search", "width.search=" << search_width );
     LPT_INFO("search", "width.simulation=" << simulation_width );
     LPT_INFO("search", "bfws.using_feature_set=" << using_feature_set);
+    LPT_INFO("search", "sim.threads=" << simulation_threads);
+    LPT_INFO("search", "sim.r_cache=" << simulation_cache_size);
     auto rs = config.getOption<std::string>("bfws.rs");
     if  (rs == "sim") relevant_set_type = RelevantSetType::Sim;
     else if  (rs == "l0" ) relevant_set_type = RelevantSetType::L0;
@@ -20,6 +20,12 @@ struct SBFWSConfig {
     const bool mark_negative_propositions;
     const bool using_feature_set;
 
+    //! The number of worker threads on which to run simulations asynchronously (0 = run them synchronously)
+    const unsigned simulation_threads;
+
+    //! The maximum number of sets R computed by simulations that are cached for reuse (0 = no caching)
+    const unsigned simulation_cache_size;
+
     enum class NoveltyEvaluatorType {Adaptive, Generic};
     NoveltyEvaluatorType evaluator_t;
 
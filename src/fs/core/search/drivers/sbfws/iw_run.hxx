@@ -1,6 +1,8 @@
 
 #pragma once
 
+#include <deque>
+#include <memory>
 #include <unordered_set>
 
 #include <lapkt/tools/resources_control.hxx>
@@ -27,96 +29,82 @@ template <typename StateT, typename ActionType>
 class IWRunNode {
 public:
     using ActionT = ActionType;
-    using PT = std::shared_ptr<IWRunNode<StateT, ActionT>>;
 
-    //! The state in this node
-    StateT state;
+    //! Nodes are identified by their position in the node arena of the simulation
+    using IdT = uint32_t;
+    static constexpr IdT NONE = std::numeric_limits<IdT>::max();
+
+    //! The state in this node, which is only kept while the node can still be expanded, see IWRun
+    std::unique_ptr<StateT> _state;
+
+    //! The atoms of the state that differ from those of the state of the parent node
+    std::vector<Atom> changeset;
 
     //! The action that led to this node
     typename ActionT::IdType action;
 
-    //! The parent node
-    PT parent;
+    //! The ID of the parent node, or NONE for the seed node
+    IdT parent;
+
+    //! The ID of the node itself
+    IdT _id;
 
     //! Accummulated cost
     unsigned g;
 
-// 	bool satisfies_subgoal; // Whether the node satisfies some subgoal
-
     //! The novelty  of the state
     unsigned char _w;
 
-    //! The indexes of the variables whose atoms form the set 1(s), which contains all atoms in 1(parent(s)) not deleted by the action that led to s, plus those
-    //! atoms in s with novelty 1.
-// 	std::vector<unsigned> _nov1atom_idxs;
-
-    //! Implicit encoding of the atoms that contribute novelty 1 to the state
-// 	boost::dynamic_bitset<> _B_of_s;
 
-    //! Whether the path-novely of the node is one
-// 	bool _path_novelty_is_1;
-
-    std::vector<std::pair<AtomIdx, AtomIdx>> _nov2_pairs;
-
-    //! The generation order, uniquely identifies the node
-    //! NOTE We're assuming we won't generate more than 2^32 ~ 4.2 billion nodes.
-    uint32_t _gen_order;
-
-
-    IWRunNode() = default;
     ~IWRunNode() = default;
-    IWRunNode(const IWRunNode&) = default;
+    IWRunNode(const IWRunNode&) = delete;
     IWRunNode(IWRunNode&&) = delete;
     IWRunNode& operator=(const IWRunNode&) = delete;
     IWRunNode& operator=(IWRunNode&&) = delete;
 
-    //! Constructor with full copying of the state (expensive)
-    IWRunNode(const StateT& s, unsigned long gen_order) : IWRunNode(StateT(s), ActionT::invalid_action_id, nullptr, gen_order) {}
+    //! Constructor for the seed node
+    IWRunNode(const StateT& s, IdT id) : IWRunNode(StateT(s), {}, ActionT::invalid_action_id, NONE, id, 0) {}
 
     //! Constructor with move of the state (cheaper)
-    IWRunNode(StateT&& _state, typename ActionT::IdType _action, PT _parent, uint32_t gen_order) :
-        state(std::move(_state)),
-//		feature_valuation(0),
+    IWRunNode(StateT&& state_, std::vector<Atom>&& changeset_, typename ActionT::IdType _action, IdT parent_, IdT id, unsigned g_) :
+        _state(new StateT(std::move(state_))),
+        changeset(std::move(changeset_)),
         action(_action),
-        parent(_parent),
-        g(parent ? parent->g+1 : 0),
-        _w(std::numeric_limits<unsigned char>::max()),
-// 		_path_novelty_is_1(false),
-// 		_B_of_s(state.numAtoms()),
-        _gen_order(gen_order)
+        parent(parent_),
+        _id(id),
+        g(g_),
+        _w(std::numeric_limits<unsigned char>::max())
     {
-        assert(_gen_order > 0); // Very silly way to detect overflow, in case we ever generate > 4 billion nodes :-)
+        assert(_id != NONE); // Very silly way to detect overflow, in case we ever generate > 4 billion nodes :-)
     }
 
 
-    bool has_parent() const { return parent != nullptr; }
+    bool has_parent() const { return parent != NONE; }
+
+    const StateT& state() const {
+        assert(_state);
+        return *_state;
+    }
+
+    void release_state() { _state.reset(); }
 
     //! Print the node into the given stream
     friend std::ostream& operator<<(std::ostream &os, const IWRunNode<StateT, ActionT>& object) { return object.print(os); }
     std::ostream& print(std::ostream& os) const {
-// 		const Problem& problem = Problem::getInstance();
         os << "{@ = " << this;
-        os << ", #=" << _gen_order ;
-        os << ", s = " << state ;
+        os << ", #=" << _id ;
+        if (_state) os << ", s = " << *_state;
+        else os << ", changes = " << fs0::print::container(changeset);
         os << ", g=" << g ;
-        //os << ", w=" << (_evaluated ? (_w == std::numeric_limits<unsigned char>::max() ? "INF" : std::to_string(_w)) : "?") ;
         os << ", w=" << (_w == std::numeric_limits<unsigned char>::max() ? "INF" : std::to_string(_w));
-
         os << ", act=" << action ;
-// 		if (action < std::numeric_limits<unsigned>::max()) {
-// 			os << ", act=" << *(problem.getGroundActions()[action]) ;
-// 			os << fs0::print::full_action(*(problem.getGroundActions()[action]));
-// 		} else {
-// 			os << ", act=" << "NONE" ;
-// 		}
-
-        os << ", parent = " << (parent ? "#" + std::to_string(parent->_gen_order) : "None");
+        os << ", parent = " << (has_parent() ? "#" + std::to_string(parent) : "None");
         return os;
     }
 
-    bool operator==( const IWRunNode<StateT, ActionT>& o ) const { return state == o.state; }
+    bool operator==( const IWRunNode<StateT, ActionT>& o ) const { return state() == o.state(); }
 
-    std::size_t hash() const { return state.hash(); }
+    std::size_t hash() const { return state().hash(); }
 };
 
 
@@ -139,11 +127,12 @@ public:
     using StateT = typename StateModel::StateT;
 
     using ActionIdT = typename StateModel::ActionType::IdType;
-    using NodePT = std::shared_ptr<NodeT>;
+    using NodeIdT = typename NodeT::IdT;
 
     using FeatureValueT = typename NoveltyEvaluatorT::FeatureValueT;
 
-    using OpenListT = lapkt::SimpleQueue<NodeT>;
+    //! A FIFO queue of node IDs
+    using OpenListT = std::deque<NodeIdT>;
 
 
 protected:
@@ -153,8 +142,14 @@ protected:
     //! The simulation configuration
     IWRunConfig _config;
 
-    //!
-    std::vector<NodePT> _optimal_paths;
+    //! The arena where all the nodes of the simulation that are worth keeping are stored, indexed by their ID.
+    //! A deque ensures that references to nodes are not invalidated as new nodes are added. Nodes only keep
+    //! their full state until they are expanded, except the seed node; the states along a path are rebuilt
+    //! from the seed state and the changesets of the nodes, should they be needed.
+    std::deque<NodeT> _nodes;
+
+    //! _optimal_paths[i] is the ID of the first node that reached subgoal 'i', or NONE
+    std::vector<NodeIdT> _optimal_paths;
 
     //! '_unreached' contains the indexes of all those goal atoms that have yet not been reached.
     std::unordered_set<unsigned> _unreached;
@@ -166,7 +161,7 @@ protected:
     std::unique_ptr<SimulationEvaluatorI<NodeT>> _evaluator;
 
     //! Some node counts
-    uint32_t _generated;
+    uint32_t _generated; // Includes the nodes not kept in the arena
     uint32_t _w1_nodes_expanded;
     uint32_t _w2_nodes_expanded;
     uint32_t _w1_nodes_generated;
@@ -179,13 +174,17 @@ protected:
     //! Whether to print some useful extra information or not
     bool _verbose;
 
+    //! Whether to log anything at all, which is not the case for runs on worker threads
+    bool _logging;
+
 public:
 
     //! Constructor
-    IWRun(const StateModel& model, const FeatureSetT& featureset, NoveltyEvaluatorT* evaluator, IWRunConfig config, BFWSStats& stats, bool verbose) :
+    IWRun(const StateModel& model, const FeatureSetT& featureset, NoveltyEvaluatorT* evaluator, IWRunConfig config, BFWSStats& stats, bool verbose, bool logging = true) :
         _model(model),
         _config(std::move(config)),
-        _optimal_paths(model.num_subgoals()),
+        _nodes(),
+        _optimal_paths(model.num_subgoals(), NodeT::NONE),
         _unreached(),
         _in_seed(),
         _evaluator(),
@@ -196,7 +195,8 @@ public:
         _w2_nodes_generated(0),
         _w_gt2_nodes_generated(0),
         _stats(stats),
-        _verbose(verbose)
+        _verbose(verbose),
+        _logging(logging)
     {
         if (_config._use_achiever_evaluator) {
             const auto& actions = _model.getTask().getGroundActions();
@@ -204,14 +204,18 @@ public:
             operators.reserve(actions.size());
             for (const auto& a:actions) operators.emplace_back(compile_action_to_plan_operator(*a));
 
-            AchieverNoveltyConfiguration ach_config(
-                _config.global.template getOption<unsigned long>("sim.max_table_size", 9999999),
-                _config.global.template getOption<bool>("sim.early_break", false)
-            );
+            AchieverNoveltyConfiguration ach_config(_config.global.template getOption<bool>("sim.early_break", false));
             _evaluator = create_achiever_evaluator<NodeT, FeatureSetT, NoveltyEvaluatorT>(
-                    _model.getTask(), featureset, operators, ach_config
+                    _model.getTask(), featureset, operators, ach_config, _logging
             );
 
+        } else if (_config._max_width > 2) {
+            // No specialized evaluator exists for such widths, hence the seen tuples are kept in hash sets instead
+            std::unique_ptr<NoveltyEvaluatorT> unused(evaluator);
+            using SimEvaluatorT = TupleSimulationEvaluator<NodeT, FeatureSetT>;
+            _evaluator = std::make_unique<SimEvaluatorT>(_model.getTask().get_tuple_index(), featureset, _config._max_width,
+                                                         _config.global.template getOption<bool>("ignore_neg_literals", true));
+
         } else {
             using SimEvaluatorT = SimulationEvaluator<NodeT, FeatureSetT, NoveltyEvaluatorT>;
             _evaluator = std::make_unique<SimEvaluatorT>(featureset, evaluator);
@@ -219,8 +223,8 @@ public:
     }
 
     void reset() {
-        std::vector<NodePT> _(_optimal_paths.size(), nullptr);
-        _optimal_paths.swap(_);
+        std::deque<NodeT>().swap(_nodes);
+        std::fill(_optimal_paths.begin(), _optimal_paths.end(), NodeT::NONE);
         _generated = 1;
         _w1_nodes_expanded = 0;
         _w2_nodes_expanded = 0;
@@ -239,93 +243,56 @@ public:
     IWRun& operator=(IWRun&&) = default;
 
 
-    //! Mark all atoms in the path to some goal. 'seed_nodes' contains all nodes satisfying some subgoal.
-    void mark_atoms_in_path_to_subgoal(const std::vector<NodePT>& seed_nodes, std::vector<bool>& atoms) const {
+    //! Mark the atoms made true along the paths to some subgoal, i.e. those atoms that are true in some node of the
+    //! path but not in its parent. 'seed_nodes' contains all nodes satisfying some subgoal.
+    void mark_atoms_in_path_to_subgoal(const std::vector<NodeIdT>& seed_nodes, std::vector<bool>& atoms) const {
         const AtomIndex& index = _model.getTask().get_tuple_index();
-        std::unordered_set<NodePT> all_visited;
+        std::vector<bool> all_visited(_nodes.size(), false);
         assert(atoms.size() == index.size());
 
-        for (NodePT node:seed_nodes) {
-
-            NodePT root = node;
+        for (NodeIdT id:seed_nodes) {
             // We ignore s0
-            while (node->has_parent()) {
+            for (const NodeT* node = &_nodes[id]; node->has_parent(); node = &_nodes[node->parent]) {
                 // If the node has already been processed, no need to do it again, nor to process the parents,
                 // which will necessarily also have been processed.
-                auto res = all_visited.insert(node);
-                if (!res.second) break;
-
-                const StateT& state = node->state;
-                const StateT& parent_state = node->parent->state;
-                _unused(state);
-
-                for (const auto& p_q:node->_nov2_pairs) {
-                    Atom p = index.to_atom(p_q.first);
-                    Atom q = index.to_atom(p_q.second);
-
-                    assert(state.contains(p));
-                    assert(state.contains(q));
-                    assert(!(parent_state.contains(p) && parent_state.contains(q))); // Otherwise the tuple couldn't be new
-
-
-                    std::vector<AtomIdx> to_mark;
-                    if (parent_state.contains(p)) {
-                        if (int(p.getValue()) != 0) {
-                            atoms[p_q.first] = true; // TODO THIS WON'T GENERALIZE WELL TO FSTRIPS DOMAINS
-// 							std::cout << "ATTENTION : Marking atom " << p << std::endl;
-                        }
-                    }
-                    else if (parent_state.contains(q)) {
-                        if (int(q.getValue()) != 0) {
-                            atoms[p_q.second] = true;
-// 							std::cout << "ATTENTION : Marking atom " << q << std::endl;
-                        }
-                    }
-                    else { // The parent state contains none
-// 						std::cout << "ATTENTION : Would Mark pair " << p << ", " << q << std::endl;
-                        if (int(p.getValue()) != 0) atoms[p_q.first] = true;
-                        if (int(q.getValue()) != 0) atoms[p_q.second] = true;
-                    }
+                if (all_visited[node->_id]) break;
+                all_visited[node->_id] = true;
 
+                for (const Atom& atom:node->changeset) {
+                    if (unsigned(atom.getValue()) == 0) continue; // TODO THIS WON'T GENERALIZE WELL TO FSTRIPS DOMAINS
+                    atoms[index.to_index(atom.getVariable(), atom.getValue())] = true;
                 }
-
-                /*
-                const StateT& state = node->state;
-                for (unsigned var = 0; var < state.numAtoms(); ++var) {
-                    if (state.getValue(var) == 0) continue; // TODO THIS WON'T GENERALIZE WELL TO FSTRIPS DOMAINS
-                    AtomIdx atom = index.to_index(var, state.getValue(var));
-                    atoms[atom] = true;
-                }
-                */
-
-                node = node->parent;
             }
         }
     }
 
-    std::vector<bool> mark_all_atoms_in_path_to_subgoal(const std::vector<NodePT>& seed_nodes) const {
+    std::vector<bool> mark_all_atoms_in_path_to_subgoal(const std::vector<NodeIdT>& seed_nodes) const {
         const AtomIndex& index = _model.getTask().get_tuple_index();
         std::vector<bool> atoms(index.size(), false);
-        std::unordered_set<NodePT> all_visited;
-        assert(atoms.size() == index.size());
+        std::vector<bool> all_visited(_nodes.size(), false);
+        const StateT& seed = _nodes[0].state();
 
-        for (NodePT node:seed_nodes) {
+        std::vector<const NodeT*> path;
+        std::vector<object_id> values(seed.numAtoms());
+        for (NodeIdT id:seed_nodes) {
             // We ignore s0
-            while (node->has_parent()) {
-                // If the node has already been processed, no need to do it again, nor to process the parents,
-                // which will necessarily also have been processed.
-                auto res = all_visited.insert(node);
-                if (!res.second) break;
-
-                const StateT& state = node->state;
-                for (unsigned var = 0; var < state.numAtoms(); ++var) {
-                    object_id val = state.getValue(var);
+            path.clear();
+            for (const NodeT* node = &_nodes[id]; node->has_parent(); node = &_nodes[node->parent]) path.push_back(node);
+
+            // Rebuild the states along the path from the seed state, marking the atoms of those nodes not yet processed
+            for (unsigned var = 0; var < values.size(); ++var) values[var] = seed.getValue(var);
+            for (auto it = path.rbegin(); it != path.rend(); ++it) {
+                const NodeT* node = *it;
+                for (const Atom& atom:node->changeset) values[atom.getVariable()] = atom.getValue();
+                if (all_visited[node->_id]) continue;
+                all_visited[node->_id] = true;
+
+                for (unsigned var = 0; var < values.size(); ++var) {
+                    object_id val = values[var];
                     if (unsigned (val) != 0) {
                         atoms[index.to_index(var, val)] = true;
                     }
                 }
-
-                node = node->parent;
             }
         }
         return atoms;
@@ -347,7 +314,7 @@ public:
             const Atom& atom = index.to_atom(i);
             if (unsigned(atom.getValue())!=0) all[i] = true;
         }
-        LPT_INFO("search", "Simulation - Computed R_All set with " << std::count(all.cbegin(), all.cend(), true) << " atoms");
+        if (_logging) LPT_INFO("search", "Simulation - Computed R_All set with " << std::count(all.cbegin(), all.cend(), true) << " atoms");
         return all;
     }
 
@@ -365,10 +332,8 @@ public:
 
         if (_config._max_width == 1){
             return compute_plain_R1(seed);
-        } else if (_config._max_width == 2){
-            return compute_plain_RG2(seed);
         } else {
-            throw std::runtime_error("Simulation max_width too high");
+            return compute_plain_RG(seed);
         }
     }
 
@@ -376,13 +341,14 @@ public:
         return std::vector<bool>();
     }
 
-    std::vector<bool> compute_plain_RG2(const StateT& seed) {
-        assert(_config._max_width == 2);
+    //! Compute R_G[k] with an IW(k) simulation, for k >= 2
+    std::vector<bool> compute_plain_RG(const StateT& seed) {
+        assert(_config._max_width >= 2);
         auto simt0 = aptk::time_used();
         run(seed, _config._max_width);
         report_simulation_stats(simt0);
 
-        LPT_INFO("search", "Simulation - IW(" << _config._max_width << ") run reached " << _model.num_subgoals() - _unreached.size() << " goals");
+        if (_logging) LPT_INFO("search", "Simulation - IW(" << _config._max_width << ") run reached " << _model.num_subgoals() - _unreached.size() << " goals");
         return extract_R_G(true);
     }
 
@@ -395,7 +361,7 @@ public:
         report_simulation_stats(simt0);
 
         if (_config._goal_directed && _unreached.size() == 0) {
-            LPT_INFO("search", "Simulation - IW(" << _config._max_width << ") reached all subgoals, computing R_G[" << _config._max_width << "]");
+            if (_logging) LPT_INFO("search", "Simulation - IW(" << _config._max_width << ") reached all subgoals, computing R_G[" << _config._max_width << "]");
             return extract_R_G_1();
         }
 
@@ -405,7 +371,7 @@ public:
 
     std::vector<bool> extract_R_1() {
         std::vector<bool> R = _evaluator->reached_atoms();
-        LPT_INFO("search", "Simulation - IW(" << _config._max_width << ") run reached " << _model.num_subgoals() - _unreached.size() << " goals");
+        if (_logging) LPT_INFO("search", "Simulation - IW(" << _config._max_width << ") run reached " << _model.num_subgoals() - _unreached.size() << " goals");
         if (_verbose) {
             unsigned c = std::count(R.begin(), R.end(), true);
             LPT_INFO("search", "Simulation - |R[1]| = " << c);
@@ -420,48 +386,48 @@ public:
 		report_simulation_stats(simt0);
 
         if (_unreached.size() == 0) {
-            std::vector<NodePT> seed_nodes = extract_seed_nodes();
+            std::vector<NodeIdT> seed_nodes = extract_seed_nodes();
             std::vector<bool> R_G = mark_all_atoms_in_path_to_subgoal(seed_nodes);
             unsigned R_G_size = std::count(R_G.begin(), R_G.end(), true);
-            LPT_INFO("cout", "Simulation - IW(1) run reached all goals");
-            LPT_INFO("cout", "Simulation - |R_G'[1]| = " << R_G_size << " (computed from " << seed_nodes.size() << " subgoal-reaching nodes)");
+            if (_logging) LPT_INFO("cout", "Simulation - IW(1) run reached all goals");
+            if (_logging) LPT_INFO("cout", "Simulation - |R_G'[1]| = " << R_G_size << " (computed from " << seed_nodes.size() << " subgoal-reaching nodes)");
             _stats.relevant_atoms(R_G_size);
             return R_G;
         }
 
-        LPT_INFO("cout", "Simulation - IW(1) run did not reach all goals");
+        if (_logging) LPT_INFO("cout", "Simulation - IW(1) run did not reach all goals");
 
         if (_config._max_width == 1) {
-            LPT_INFO("cout", "Simulation - Max. simulation width set to 1, falling back to R=R_all");
+            if (_logging) LPT_INFO("cout", "Simulation - Max. simulation width set to 1, falling back to R=R_all");
             return compute_R_all();
         }
 
         if (_config._gr_actions_cutoff < std::numeric_limits<unsigned>::max()) {
             unsigned num_actions =  _model.getTask().getGroundActions().size();
             if (num_actions > _config._gr_actions_cutoff) { // Too many actions to compute IW(2)
-                LPT_INFO("cout", "Simulation - Number of actions (" << num_actions << " > " << _config._gr_actions_cutoff << ") considered too high to run IW(2).");
+                if (_logging) LPT_INFO("cout", "Simulation - Number of actions (" << num_actions << " > " << _config._gr_actions_cutoff << ") considered too high to run IW(2).");
                 return compute_R_all();
             } else {
-                    LPT_INFO("cout", "Simulation - Number of actions (" << num_actions << " <= " << _config._gr_actions_cutoff << ") considered low enough to run IW(2).");
+                    if (_logging) LPT_INFO("cout", "Simulation - Number of actions (" << num_actions << " <= " << _config._gr_actions_cutoff << ") considered low enough to run IW(2).");
             }
         }
-        LPT_INFO("cout", "Simulation - Throwing IW(2) simulation");
+        if (_logging) LPT_INFO("cout", "Simulation - Throwing IW(2) simulation");
 		reset();
         run(seed, 2);
 		report_simulation_stats(simt0);
 		_stats.reachable_subgoals( _model.num_subgoals() - _unreached.size());
 
         if (_unreached.size() == 0) {
-            std::vector<NodePT> seed_nodes = extract_seed_nodes();
+            std::vector<NodeIdT> seed_nodes = extract_seed_nodes();
             std::vector<bool> R_G = mark_all_atoms_in_path_to_subgoal(seed_nodes);
             unsigned R_G_size = std::count(R_G.begin(), R_G.end(), true);
-            LPT_INFO("cout", "Simulation - IW(2) run reached all goals");
-            LPT_INFO("cout", "Simulation - |R_G'[2]| = " << R_G_size << " (computed from " << seed_nodes.size() << " subgoal-reaching nodes)");
+            if (_logging) LPT_INFO("cout", "Simulation - IW(2) run reached all goals");
+            if (_logging) LPT_INFO("cout", "Simulation - |R_G'[2]| = " << R_G_size << " (computed from " << seed_nodes.size() << " subgoal-reaching nodes)");
             _stats.relevant_atoms(R_G_size);
             return R_G;
         }
 
-        LPT_INFO("cout", "Simulation - IW(2) run did not reach all goals, falling back to R=R_all");
+        if (_logging) LPT_INFO("cout", "Simulation - IW(2) run did not reach all goals, falling back to R=R_all");
         return compute_R_all();
     }
 
@@ -494,7 +460,7 @@ public:
         }
 
 
-        std::vector<NodePT> seed_nodes = extract_seed_nodes();
+        std::vector<NodeIdT> seed_nodes = extract_seed_nodes();
         std::vector<bool> R_G(index.size(), false);
         mark_atoms_in_path_to_subgoal(seed_nodes, R_G);
 
@@ -516,10 +482,10 @@ public:
         return R_G;
     }
 
-    std::vector<NodePT> extract_seed_nodes() {
-        std::vector<NodePT> seed_nodes;
+    std::vector<NodeIdT> extract_seed_nodes() {
+        std::vector<NodeIdT> seed_nodes;
         for (unsigned subgoal_idx = 0; subgoal_idx < _optimal_paths.size(); ++subgoal_idx) {
-            if (!_in_seed[subgoal_idx] && _optimal_paths[subgoal_idx] != nullptr) {
+            if (!_in_seed[subgoal_idx] && _optimal_paths[subgoal_idx] != NodeT::NONE) {
                 seed_nodes.push_back(_optimal_paths[subgoal_idx]);
             }
         }
@@ -527,7 +493,7 @@ public:
     }
 
     std::vector<bool> extract_R_G_1() {
-        std::vector<NodePT> seed_nodes = extract_seed_nodes();
+        std::vector<NodeIdT> seed_nodes = extract_seed_nodes();
         std::vector<bool> R_G = mark_all_atoms_in_path_to_subgoal(seed_nodes);
 
         unsigned R_G_size = std::count(R_G.begin(), R_G.end(), true);
@@ -543,59 +509,78 @@ public:
     bool run(const StateT& seed, unsigned max_width) {
         if (_verbose) LPT_INFO("cout", "Simulation - Starting IW(" << max_width << ") Simulation");
 
-        NodePT root = std::make_shared<NodeT>(seed, _generated++);
+        assert(_nodes.empty());
+        NodeT& root = _nodes.emplace_back(seed, 0);
+        ++_generated;
         mark_seed_subgoals(root);
 
-        auto nov =_evaluator->evaluate(*root);
+        auto nov =_evaluator->evaluate(root, nullptr);
         assert(nov==1);
         update_novelty_counters_on_generation(nov);
 
-// 		LPT_DEBUG("cout", "Simulation - Seed node: " << *root);
+// 		LPT_DEBUG("cout", "Simulation - Seed node: " << root);
         OpenListT open;
 
-        open.insert(root);
+        open.push_back(root._id);
         auto simt0 = aptk::time_used();
 
-//        std::cout << "Novelty of root node: " << _evaluator->evaluate(*root) << std::endl;
-
         // Note that we don't used any closed list / duplicate detection of any kind, but let the novelty engine take care of that
         while (!open.empty()) {
-            NodePT current = open.next();
+            NodeT& current = _nodes[open.front()];
+            open.pop_front();
 
             // Expand the node
-            update_novelty_counters_on_expansion(current->_w);
+            update_novelty_counters_on_expansion(current._w);
+
+            for (const auto& a : _model.applicable_actions(current.state())) {
+                StateT s_a = _model.next(current.state(), a);
+                std::vector<Atom> changeset;
+                for (const Atom& atom:_model.get_last_changeset()) {
+                    VariableIdx var = atom.getVariable();
+                    if (s_a.getValue(var) == atom.getValue() && current.state().getValue(var) != atom.getValue()) changeset.push_back(atom);
+                }
 
-            for (const auto& a : _model.applicable_actions(current->state)) {
-                StateT s_a = _model.next(current->state, a);
-                NodePT successor = std::make_shared<NodeT>(std::move(s_a), a, current, _generated++);
+                // The successor is placed in the arena straight away, and removed from it right after if not worth keeping
+                NodeT& successor = _nodes.emplace_back(std::move(s_a), std::move(changeset), a, current._id, _nodes.size(), current.g + 1);
+                ++_generated;
 
-                successor->_w = _evaluator->evaluate(*successor);
-                update_novelty_counters_on_generation(successor->_w);
+                successor._w = _evaluator->evaluate(successor, &current);
+                update_novelty_counters_on_generation(successor._w);
 
-//                 LPT_INFO("cout", "Simulation - Node generated with w=" << (unsigned) successor->_w << ": "  << std::endl<< *successor << std::endl);
+//                 LPT_INFO("cout", "Simulation - Node generated with w=" << (unsigned) successor._w << ": "  << std::endl<< successor << std::endl);
 
-                if (_model.goal(successor->state)) LPT_INFO("cout", "Simulation - Goal state reached during simulation");
+                if (_logging && _model.goal(successor.state())) LPT_INFO("cout", "Simulation - Goal state reached during simulation");
 
-                if (process_node(successor)) {  // i.e. all subgoals have been reached before reaching the bound
+                bool reaches_subgoal = process_node(successor);
+                if (_unreached.empty()) {  // i.e. all subgoals have been reached before reaching the bound
                     report("All subgoals reached", max_width);
-//                    _evaluator->info();
+                    if (_logging) _evaluator->info();
                     return true;
                 }
 
-                if (successor->_w <= max_width) {
-                    open.insert(successor);
+                if (successor._w <= max_width) {
+                    open.push_back(successor._id);
+                } else if (!reaches_subgoal) {
+                    // The node will never be needed again, neither for expansion nor for the extraction of paths
+                    _nodes.pop_back();
+                } else {
+                    successor.release_state(); // Only kept for the extraction of paths
                 }
 
                 if (_generated % 1000 == 0) {
                     auto rate = _generated*1.0 / (aptk::time_used() - simt0);
-                    LPT_INFO("cout", "IW run: Node generation rate after " << _generated / 1000 << "K generations (nodes/sec.): " << rate);
+                    if (_logging) LPT_INFO("cout", "IW run: Node generation rate after " << _generated / 1000 << "K generations (nodes/sec.): " << rate
+                                        << ". Memory consumption: " << get_current_memory_in_kb() << "kB.");
 //                    _evaluator->info();
                 }
             }
+
+            // The state of the seed is kept to rebuild the states along paths
+            if (current.has_parent()) current.release_state();
         }
 
         report("State space exhausted", max_width);
-        _evaluator->info();
+        if (_logging) _evaluator->info();
         return false;
     }
 
@@ -633,9 +618,10 @@ public:
 
 protected:
 
-    //! Returns true iff all goal atoms have been reached in the IW search
-    bool process_node(NodePT& node) {
-        const StateT& state = node->state;
+    //! Mark the goal atoms first reached by the given node. Returns true iff there is some such atom.
+    bool process_node(const NodeT& node) {
+        const StateT& state = node.state();
+        bool reaches_subgoal = false;
 
         // We iterate through the indexes of all those goal atoms that have not yet been reached in the IW search
         // to check if the current node satisfies any of them - and if it does, we mark it appropriately.
@@ -645,22 +631,22 @@ protected:
             if (_model.goal(state, subgoal_idx)) {
 // 				node->satisfies_subgoal = true;
 // 				_all_paths[subgoal_idx].push_back(node);
-                if (!_optimal_paths[subgoal_idx]) _optimal_paths[subgoal_idx] = node;
+                if (_optimal_paths[subgoal_idx] == NodeT::NONE) _optimal_paths[subgoal_idx] = node._id;
+                reaches_subgoal = true;
                 it = _unreached.erase(it);
             } else {
                 ++it;
             }
         }
-        // As soon as all nodes have been processed, we return true so that we can stop the search
-        return _unreached.empty();
+        return reaches_subgoal;
     }
 
-    void mark_seed_subgoals(const NodePT& node) {
+    void mark_seed_subgoals(const NodeT& node) {
         std::vector<bool> _(_model.num_subgoals(), false);
         _in_seed.swap(_);
         _unreached.clear();
         for (unsigned i = 0; i < _model.num_subgoals(); ++i) {
-            if (_model.goal(node->state, i)) {
+            if (_model.goal(node.state(), i)) {
                 _in_seed[i] = true;
             } else {
                 _unreached.insert(i);
@@ -3,9 +3,17 @@
 #include <fs/core/search/drivers/sbfws/relevant_atoms.hxx>
 #include <fs/core/search/drivers/sbfws/sbfws.hxx>
 #include <fs/core/heuristics/l0.hxx>
+#include <fs/core/problem.hxx>
+#include <fs/core/languages/fstrips/scopes.hxx>
 
 namespace fs0::bfws {
 
+std::vector<VariableIdx> compute_goal_relevant_variables(const Problem& problem) {
+    std::set<VariableIdx> scope;
+    fs::ScopeUtils::computeFullScope(problem.getGoalConditions(), scope);
+    return std::vector<VariableIdx>(scope.begin(), scope.end());
+}
+
 /****** L0-BASED #R COUNTER *****/
 template <typename NodeT>
 L0RelevantAtomsCounter<NodeT>::L0RelevantAtomsCounter(const Problem &problem)
@@ -1,7 +1,12 @@
 
 #pragma once
 
+#include <algorithm>
+#include <chrono>
+#include <unordered_map>
+
 #include <fs/core/search/drivers/sbfws/iw_run.hxx>
+#include <fs/core/search/drivers/sbfws/simulation_pool.hxx>
 
 
 namespace fs0 { class Problem; class L0Heuristic; }
@@ -10,12 +15,25 @@ namespace fs0::bfws { struct SBFWSConfig; class RelevantAtomSet; class BFWSStats
 
 namespace fs0::bfws {
 
+//! Return the (sorted) state variables that are relevant to the goal formula of the given problem
+std::vector<VariableIdx> compute_goal_relevant_variables(const Problem& problem);
+
 
 //! 
 template <typename NodeT>
 class RelevantAtomsCounterI {
 public:
+    virtual ~RelevantAtomsCounterI() = default;
+
     virtual unsigned count(NodeT& node, BFWSStats& stats) const = 0;
+
+    //! Whether the value of #r last returned for the given node is only a provisional fallback,
+    //! because the set R on which it depends is still being computed.
+    virtual bool provisional(const NodeT& node) const { return false; }
+
+    //! To be invoked on a newly-generated node, whose #g has already been computed, with the changeset
+    //! that produced its state from that of its parent, which allows to update #r incrementally.
+    virtual void node_generated(NodeT& node, const std::vector<Atom>& changeset) const {}
 };
 
 
@@ -46,31 +64,95 @@ class SimulationBasedRelevantAtomsCounter : public RelevantAtomsCounterI<NodeT>
 public:
     using FeatureValueT = typename NoveltyEvaluatorT::FeatureValueT;
 
+    //! The outcome of a simulation run on a worker thread
+    struct SimulationResult {
+        std::vector<bool> R;
+        BFWSStats stats;
+    };
+
+    //! The private objects of a worker thread: a deep copy of the problem, whose formulas cache some of their
+    //! interpretations and whose goal-satisfaction manager holds its own CSP, the state model built over it,
+    //! the feature set and the factory of novelty evaluators
+    struct WorkerContext {
+        std::unique_ptr<Problem> problem;
+        std::unique_ptr<ModelT> model;
+        FeatureSetT features;
+        NoveltyFactory<FeatureValueT> factory;
+    };
+
     SimulationBasedRelevantAtomsCounter(const ModelT& model, const SBFWSConfig& config, const FeatureSetT& features)  :
             _model(model),
             _problem(model.getTask()),
             _config(config),
             iwconfig_(config.simulation_width, config._global_config),
             _sim_novelty_factory(_problem, config.evaluator_t, features.uses_extra_features(), config.simulation_width),
-            _featureset(features)
-    {}
+            _featureset(features),
+            _cache(compute_goal_relevant_variables(_problem), config.simulation_cache_size),
+            _pending(),
+            _workers()
+    {
+        if (config.simulation_threads > 0) {
+            _workers = create_workers(config.simulation_threads);
+            if (_workers) {
+                LPT_INFO("cout", "Simulations will be run asynchronously on " << _workers->size() << " worker threads");
+            } else {
+                LPT_INFO("cout", "Asynchronous simulations not supported by the current state model or feature set, running them synchronously");
+            }
+        }
+    }
+
+    //! Create the pool of workers, each with its private context, or return null if that is not possible
+    std::unique_ptr<SimulationWorkerPool<WorkerContext>> create_workers(unsigned num_threads) const {
+        // Extra features might refer to objects of the problem that we cannot copy
+        if (_featureset.uses_extra_features()) return nullptr;
+
+        std::vector<std::unique_ptr<WorkerContext>> contexts;
+        for (unsigned i = 0; i < num_threads; ++i) {
+            auto problem = std::make_unique<Problem>(_problem);
+            auto model = clone_model_for_worker(_model, *problem);
+            if (!model) return nullptr;
+            NoveltyFactory<FeatureValueT> factory(*problem, _config.evaluator_t, false, _config.simulation_width);
+            contexts.push_back(std::unique_ptr<WorkerContext>(new WorkerContext{std::move(problem), std::move(model), _featureset, std::move(factory)}));
+        }
+        return SimulationWorkerPool<WorkerContext>::create(std::move(contexts));
+    }
     ~SimulationBasedRelevantAtomsCounter() = default;
 
 
     unsigned count(NodeT& node, BFWSStats& stats) const override {
-        return compute_R(node, stats).num_reached();
+        const RelevantAtomSet* R = compute_R(node, stats);
+        return R ? R->num_reached() : 0; // Fall back to #r=0 until R is available
+    }
+
+    bool provisional(const NodeT& node) const override {
+        return _workers && node._relevant_atoms == nullptr;
+    }
+
+    void node_generated(NodeT& node, const std::vector<Atom>& changeset) const override {
+        if (node._relevant_atoms != nullptr || computation_of_R_necessary(node)) return;
+
+        // If the set R of the parent is not yet available, it will be computed lazily later on
+        const RelevantAtomSet* parent_R = node.parent->_relevant_atoms;
+        if (parent_R) derive_R(node, *parent_R, &changeset);
     }
 
     std::vector<bool> throw_simulation(const State& state, BFWSStats& stats, bool verbose) const {
+        return throw_simulation(_model, _featureset, _sim_novelty_factory, state, stats, verbose, true);
+    }
+
+    //! Throw a simulation with the given model, feature set and novelty factory, which must be private to the
+    //! calling thread. Simulations run on worker threads do not log anything, since the logger is not thread-safe.
+    std::vector<bool> throw_simulation(const ModelT& model, const FeatureSetT& featureset, const NoveltyFactory<FeatureValueT>& factory,
+                                       const State& state, BFWSStats& stats, bool verbose, bool logging) const {
         // Throw a simulation from the node, and compute a set R of relevant atoms from there.
-        auto evaluator = _sim_novelty_factory.create_compound_evaluator(_config.simulation_width);
+        auto evaluator = factory.create_compound_evaluator(_config.simulation_width);
         if (_config.simulation_width==2) { stats.sim_table_created(1); stats.sim_table_created(2); }
         else  { assert(_config.simulation_width); stats.sim_table_created(1); }
 
 
         using IWNodeT = IWRunNode<State, typename ModelT::ActionType>;
         using IWRunT = IWRun<IWNodeT, ModelT, NoveltyEvaluatorT, FeatureSetT>;
-        IWRunT simulator(_model, _featureset, evaluator, iwconfig_, stats, verbose);
+        IWRunT simulator(model, featureset, evaluator, iwconfig_, stats, verbose, logging);
         return simulator.compute_R(state);
     }
 
@@ -79,51 +161,121 @@ public:
     //! the counter #r(node) can be obtained. This implements a lazy version which
     //! can recursively compute the parent RelevantAtomSet.
     //! Additionally, this caches the set within the node for future reference.
-    const RelevantAtomSet& compute_R(NodeT& node, BFWSStats& stats) const {
+    //! When simulations are run asynchronously, returns null while the simulation that
+    //! the set depends on has not yet finished.
+    const RelevantAtomSet* compute_R(NodeT& node, BFWSStats& stats) const {
 
         // If the R(s) has been previously computed and is cached, we return it straight away
-        if (node._relevant_atoms != nullptr) return *node._relevant_atoms;
+        if (node._relevant_atoms != nullptr) return node._relevant_atoms;
 
 
         // Otherwise, we compute it anew
         if (computation_of_R_necessary(node)) {
-            bool verbose = !node.has_parent(); // Print info only on the s0 simulation
-            auto R = throw_simulation(node.state, stats, verbose);
-            node._helper = new AtomsetHelper(_problem.get_tuple_index(), R);
-            node._relevant_atoms = new RelevantAtomSet(*node._helper);
-
-            //! MRJ: over states
-             node._relevant_atoms->init(node.state);
-            //! Over feature sets
-//			node._relevant_atoms->init(_featureset.evaluate(node.state));
-
-            if (!node.has_parent()) { // Log some info, but only for the seed state
-                LPT_DEBUG("cout", "R(s_0)  (#=" << node._relevant_atoms->getHelper()._num_relevant << "): " << std::endl << *(node._relevant_atoms));
+            if (_cache.enabled() && fetch_cached_R(node, stats)) {
+                // The set R has been reused from a previous simulation from an equivalent seed
+            } else if (_workers) {
+                if (!collect_or_launch_simulation(node, stats)) return nullptr;
+            } else {
+                bool verbose = !node.has_parent(); // Print info only on the s0 simulation
+                install_R(node, throw_simulation(node.state, stats, verbose));
             }
         }
 
 
         else {
             // Copy the set R from the parent and update the set of relevant nodes with those that have been reached.
-            node._relevant_atoms = new RelevantAtomSet(compute_R(*node.parent, stats)); // This might trigger a recursive computation
+            const RelevantAtomSet* parent_R = compute_R(*node.parent, stats); // This might trigger a recursive computation
+            if (!parent_R) return nullptr;
+            derive_R(node, *parent_R, nullptr);
+        }
 
-            if (node.decreases_unachieved_subgoals()) {
-                //! MRJ:
-                //! Over states
-                node._relevant_atoms->init(node.state); // THIS IS ABSOLUTELY KEY E.G. IN BARMAN
-                //! MRJ:  Over feature sets
+        return node._relevant_atoms;
+    }
+
+    //! Derive the set R of the given node from that of its parent, which is shared until modified. If the changeset
+    //! of the node is given, only the atoms in it are checked, otherwise the node and parent states are compared.
+    void derive_R(NodeT& node, const RelevantAtomSet& parent_R, const std::vector<Atom>* changeset) const {
+        node._relevant_atoms = new RelevantAtomSet(parent_R);
+
+        if (node.decreases_unachieved_subgoals()) {
+            //! MRJ:
+            //! Over states
+            node._relevant_atoms->init(node.state); // THIS IS ABSOLUTELY KEY E.G. IN BARMAN
+            //! MRJ:  Over feature sets
 //				node._relevant_atoms->init(_featureset.evaluate(node.state));
-            } else {
-                //! MRJ: Over states
-                //! node._relevant_atoms->update(node.state, nullptr);
-                //! Old, deprecated use
-                 node._relevant_atoms->update(node.state, &(node.parent->state));
-                //! MRJ: Over feature sets
+        } else {
+            //! MRJ: Over states
+            //! node._relevant_atoms->update(node.state, nullptr);
+            if (changeset) node._relevant_atoms->update(*changeset);
+            else node._relevant_atoms->update(node.state, &(node.parent->state));
+            //! MRJ: Over feature sets
 //				node._relevant_atoms->update(_featureset.evaluate(node.state));
-            }
+        }
+    }
+
+    //! Install the set R computed by a simulation thrown from the given (seed) node
+    void install_R(NodeT& node, const std::vector<bool>& R) const {
+        auto helper = std::make_shared<const AtomsetHelper>(_problem.get_tuple_index(), R);
+        if (_cache.enabled()) _cache.insert(_cache.make_key(node.state, node.unachieved_subgoals), helper);
+        install_helper(node, helper);
+    }
+
+    //! Install the set R of a cached simulation from an equivalent seed, if there is any. Returns true iff that was the case.
+    //! Note that the check is done only once per seed node, as, on a miss, a simulation will be run.
+    bool fetch_cached_R(NodeT& node, BFWSStats& stats) const {
+        if (_workers && _pending.find(&node) != _pending.end()) return false; // Already missed, simulation ongoing
+
+        auto helper = _cache.find(_cache.make_key(node.state, node.unachieved_subgoals));
+        if (!helper) {
+            stats.r_cache_miss();
+            return false;
+        }
+        stats.r_cache_hit();
+        install_helper(node, helper);
+        return true;
+    }
+
+    void install_helper(NodeT& node, const std::shared_ptr<const AtomsetHelper>& helper) const {
+        node._helper = helper;
+        node._relevant_atoms = new RelevantAtomSet(*node._helper);
+
+        //! MRJ: over states
+         node._relevant_atoms->init(node.state);
+        //! Over feature sets
+//			node._relevant_atoms->init(_featureset.evaluate(node.state));
+
+        if (!node.has_parent()) { // Log some info, but only for the seed state
+            LPT_DEBUG("cout", "R(s_0)  (#=" << node._relevant_atoms->getHelper()._num_relevant << "): " << std::endl << *(node._relevant_atoms));
+        }
+    }
+
+    //! Launch a simulation from the given seed node on some worker thread, if that was not done yet,
+    //! and install its result if it has already finished. Returns true iff the result was installed.
+    bool collect_or_launch_simulation(NodeT& node, BFWSStats& stats) const {
+        auto it = _pending.find(&node);
+        if (it == _pending.end()) {
+            std::function<SimulationResult (WorkerContext&)> task =
+                [this, state=node.state.detached_copy()](WorkerContext& context) {
+                    // Axioms and formulas are evaluated through the private copy of the problem of the worker,
+                    // hence the seed cannot keep the derived atoms computed by the search thread
+                    Problem::bindThreadInstance(context.problem.get());
+                    SimulationResult result;
+                    result.R = throw_simulation(*context.model, context.features, context.factory, state, result.stats, false, false);
+                    return result;
+                };
+            _pending.emplace(&node, _workers->template submit<SimulationResult>(std::move(task)));
+            return false;
         }
 
-        return *node._relevant_atoms;
+        if (it->second.wait_for(std::chrono::seconds(0)) != std::future_status::ready) return false;
+        SimulationResult result = it->second.get();
+        _pending.erase(it);
+        stats.add_simulation_stats(result.stats);
+        if (!node.has_parent()) { // Log some info, but only for the s0 simulation
+            LPT_INFO("cout", "Simulation - Asynchronous simulation from s0 finished, |R| = " << std::count(result.R.begin(), result.R.end(), true));
+        }
+        install_R(node, result.R);
+        return true;
     }
 
     inline bool computation_of_R_necessary(const NodeT& node) const {
@@ -143,6 +295,17 @@ protected:
     const NoveltyFactory<FeatureValueT> _sim_novelty_factory;
 
     const FeatureSetT& _featureset;
+
+    //! The sets R computed by previous simulations, indexed by the goal-relevant projection of their seed state
+    mutable AtomsetHelperCache _cache;
+
+    //! The asynchronous simulations whose result has not been installed yet, indexed by their seed node.
+    //! Raw pointers are fine, since the search keeps all created nodes alive in its open / closed lists.
+    mutable std::unordered_map<NodeT*, std::future<SimulationResult>> _pending;
+
+    //! The worker threads that run the simulations, if running them asynchronously.
+    //! Declared last, so that the workers are joined before any other member they use is destroyed.
+    std::unique_ptr<SimulationWorkerPool<WorkerContext>> _workers;
 };
 
 
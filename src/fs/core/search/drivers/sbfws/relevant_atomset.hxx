@@ -1,8 +1,14 @@
 
 #pragma once
 
+#include <memory>
+
+#include <boost/functional/hash.hpp>
+
 #include <lapkt/tools/logging.hxx>
 #include <fs/core/utils/atom_index.hxx>
+#include <fs/core/utils/cow_bitset.hxx>
+#include <fs/core/utils/lru_cache.hxx>
 #include <fs/core/state.hxx>
 
 
@@ -30,11 +36,13 @@ public:
 
 //! A RelevantAtomSet contains information about which of the atoms of a problem are relevant for a certain
 //! goal, and, among those, which have already been reached and which others have not.
+//! Copies of a set share the blocks of reached atoms that none of them has modified, so that a set copied
+//! from that of the parent node and then updated with the changeset of a node takes little memory.
 class RelevantAtomSet {
 public:
     //! A RelevantAtomSet is always constructed with all atoms being marked as IRRELEVANT
     explicit RelevantAtomSet(const AtomsetHelper& helper) :
-        _helper(helper), _num_reached(0), _bool_reached(helper.size(), false) //, _updated(false)
+        _helper(helper), _num_reached(0), _bool_reached(helper.size()) //, _updated(false)
     {}
 
     ~RelevantAtomSet() = default;
@@ -47,10 +55,10 @@ public:
     unsigned num_reached() const { return _num_reached; }
 
     void init(const State& state) {
-        _bool_reached = std::vector<bool>(_helper.size(), false);
+        _bool_reached.reset();
         _num_reached = 0;
         update(state);
-        assert(_num_reached == std::count(_bool_reached.begin(), _bool_reached.end(), true));
+        assert(_num_reached == _bool_reached.count());
         _num_reached = 0;
     }
 
@@ -63,14 +71,17 @@ public:
 
             if (!_helper._atomidx.is_indexed(var, val)) continue;
 
-            AtomIdx atom = _helper._atomidx.to_index(var, val);
-            if (!_helper._relevant[atom]) continue; // we're not concerned about this atom
+            mark_reached(_helper._atomidx.to_index(var, val));
+        }
+    }
 
-            std::vector<bool>::reference ref = _bool_reached[atom];
-            if (!ref) {
-                ++_num_reached;
-                ref = true;
-            }
+    //! Update those atoms that have been reached by the application of the given changeset on the state of the parent.
+    //! Atoms in the changeset that were already true in the parent state are already marked as reached, as all atoms
+    //! true in a state are (except for irrelevant ones).
+    void update(const std::vector<Atom>& changeset) {
+        for (const Atom& atom:changeset) {
+            if (!_helper._atomidx.is_indexed(atom.getVariable(), atom.getValue())) continue;
+            mark_reached(_helper._atomidx.to_index(atom));
         }
     }
 
@@ -87,7 +98,7 @@ public:
             const Atom& atom = atomidx.to_atom(i);
             if (!_helper._relevant[i]) continue;
 
-            std::string mark = (_bool_reached[i]) ? "*" : "";
+            std::string mark = (_bool_reached.test(i)) ? "*" : "";
             os << atom << mark << ", ";
         }
         os << "}";
@@ -98,6 +109,11 @@ public:
     const AtomsetHelper& getHelper() const { return _helper; }
 
 protected:
+    void mark_reached(AtomIdx atom) {
+        if (!_helper._relevant[atom]) return; // we're not concerned about this atom
+        if (_bool_reached.test_and_set(atom)) ++_num_reached;
+    }
+
     //! A reference to the global atom index
     const AtomsetHelper& _helper;
 
@@ -106,7 +122,59 @@ protected:
 
     //! _bool_reached[i] iff atom with index 'i' has been reached at some point
     //! since the count of reached subgoals was last increased.
-    std::vector<bool> _bool_reached;
+    CowBitset<> _bool_reached;
+};
+
+
+//! A bounded cache of the atomset helpers (i.e. of the sets R) computed by simulations, indexed by
+//! the projection of the simulation seed state over the goal-relevant state variables, plus its #g.
+//! When full, the least recently used entry is evicted.
+class AtomsetHelperCache {
+public:
+    using HelperPT = std::shared_ptr<const AtomsetHelper>;
+
+    struct Key {
+        unsigned unachieved;
+        std::vector<object_id> values;
+
+        bool operator==(const Key& other) const { return unachieved == other.unachieved && values == other.values; }
+    };
+
+    struct KeyHasher {
+        std::size_t operator()(const Key& key) const {
+            std::size_t seed = key.unachieved;
+            for (const auto& value:key.values) boost::hash_combine(seed, value);
+            return seed;
+        }
+    };
+
+    //! 'variables' are the goal-relevant state variables; a cache with zero capacity is disabled
+    AtomsetHelperCache(std::vector<VariableIdx> variables, unsigned capacity) :
+        _variables(std::move(variables)), _entries(capacity)
+    {}
+
+    bool enabled() const { return _entries.enabled(); }
+
+    Key make_key(const State& state, unsigned unachieved) const {
+        Key key{unachieved, {}};
+        key.values.reserve(_variables.size());
+        for (VariableIdx var:_variables) key.values.push_back(state.getValue(var));
+        return key;
+    }
+
+    //! Return the helper stored under the given key, or null if there is none
+    HelperPT find(const Key& key) {
+        const HelperPT* helper = _entries.find(key);
+        return helper ? *helper : nullptr;
+    }
+
+    void insert(const Key& key, const HelperPT& helper) { _entries.insert(key, helper); }
+
+protected:
+    //! The state variables on which seed states are projected
+    const std::vector<VariableIdx> _variables;
+
+    LRUCache<Key, HelperPT, KeyHasher> _entries;
 };
 
 
@@ -36,6 +36,18 @@ SBFWSDriver<SDDLiftedStateModel>::search(Problem& problem, const Config& config,
     return do_search(drivers::GroundingSetup::sdd_lifted_model(problem), config, options, start_time);
 }
 
+template <>
+ExitCode
+SBFWSDriver<JoinLiftedStateModel>::search(Problem& problem, const Config& config, const drivers::EngineOptions& options, float start_time) {
+    return do_search(drivers::GroundingSetup::join_lifted_model(problem), config, options, start_time);
+}
+
+template <>
+ExitCode
+SBFWSDriver<HybridStateModel>::search(Problem& problem, const Config& config, const drivers::EngineOptions& options, float start_time) {
+    return do_search(drivers::GroundingSetup::hybrid_model(problem), config, options, start_time);
+}
+
 template <typename StateModelT>
 ExitCode
 SBFWSDriver<StateModelT>::do_search(const StateModelT& model, const Config& config, const drivers::EngineOptions& options, float start_time) {
@@ -63,9 +63,12 @@ public:
     //! The numeric value of the novelty w_{#g,#r}
     unsigned short w_g_r;
 
-    //! A reference atomset helper wrt which the sets R of descendent nodes with same #g are computed
-    //! Use a raw pointer to optimize performance, as the number of generated nodes will typically be huge
-    AtomsetHelper* _helper;
+    //! The <#g, #r> type of the node, which determines the novelty tables against which it is evaluated
+    unsigned _type;
+
+    //! A reference atomset helper wrt which the sets R of descendent nodes with same #g are computed.
+    //! Only set on simulation seeds, and possibly shared with other seeds through the cache of sets R
+    std::shared_ptr<const AtomsetHelper> _helper;
 
     //! The number of atoms in the last relaxed plan computed in the way to the current state that have been
     //! made true along the path (#r)
@@ -83,6 +86,7 @@ public:
         state(std::move(_state)), action(action_), parent(parent_), g(parent ? parent->g+1 : 0),
         unachieved_subgoals(std::numeric_limits<unsigned>::max()),
         _gen_order(gen_order),
+        _type(0),
         _helper(nullptr),
         _relevant_atoms(nullptr)
 // 		_nov1atom_idxs()
@@ -90,7 +94,7 @@ public:
         assert(_gen_order > 0); // Very silly way to detect overflow, in case we ever generate > 4 billion nodes :-)
     }
 
-    ~SBFWSNode() { delete _helper; delete _relevant_atoms; }
+    ~SBFWSNode() { delete _relevant_atoms; }
     SBFWSNode(const SBFWSNode&) = delete;
     SBFWSNode(SBFWSNode&&) = delete;
     SBFWSNode& operator=(const SBFWSNode&) = delete;
@@ -135,10 +139,30 @@ public:
 template <typename StateModelT, typename NoveltyIndexerT, typename FeatureSetT, typename NoveltyEvaluatorT, typename NodeT>
 class SBFWSHeuristic {
 public:
-    using NoveltyEvaluatorMapT = std::unordered_map<long, NoveltyEvaluatorT*>;
     using ActionT = typename StateModelT::ActionType;
     using FeatureValueT = typename NoveltyEvaluatorT::FeatureValueT;
 
+    //! The novelty tables of a single <#g, #r> type, plus the bookkeeping necessary to reclaim them
+    //! once no open node can be evaluated against them anymore.
+    struct TypeTables {
+        //! The #g value of the type
+        unsigned unachieved;
+
+        //! The number of nodes of the type that are currently in the open list (or being expanded)
+        unsigned open;
+
+        //! evaluators[k] is the width-k novelty table of the type, or null if it has not yet been needed.
+        std::vector<NoveltyEvaluatorT*> evaluators;
+
+        //! The (estimated) size in bytes of the tables above
+        std::size_t bytes;
+
+        //! Whether these are the throwaway tables of the nodes with some #g whose #r is only provisional,
+        //! which are dropped as soon as none of those nodes remains open
+        bool provisional;
+    };
+    using NoveltyEvaluatorMapT = std::unordered_map<unsigned, TypeTables>;
+
 
 protected:
     const StateModelT& _model;
@@ -149,9 +173,26 @@ protected:
 
     const NoveltyFactory<FeatureValueT> _search_novelty_factory;
 
-    //! The novelty evaluators for the different <#g, #r> values
-    //! The i-th position of the vector will actually contain the evaluator for novelty i+1
-    std::vector<NoveltyEvaluatorMapT> _wgr_novelty_evaluators;
+    //! The novelty tables for the different <#g, #r> values, lazily created the first time a node of the
+    //! corresponding type is evaluated, and (optionally) reclaimed once the type becomes dead.
+    NoveltyEvaluatorMapT _wgr_novelty_evaluators;
+
+    //! '_reclaimed_types[g][r]' iff the tables of type <g, r> have been reclaimed. A type with #g above the
+    //! minimum can still be re-entered by some node generated later on, in which case its novelty is evaluated
+    //! against fresh tables, i.e. the novelty information of the type is lost. We keep track of these types
+    //! to report such re-entries, with one bit per type.
+    std::vector<std::vector<bool>> _reclaimed_types;
+
+    //! Whether to reclaim the tables of those types with #g above the current minimum all of whose nodes
+    //! have already been expanded
+    bool _reclaim_tables;
+
+    //! Whether the width-k tables, k > 1, of types with #g above the current minimum start empty and grow
+    //! on demand, rather than being flat tables allocated at their full size, as such types tend to have few nodes
+    bool _growable_tables;
+
+    //! The minimum #g reached so far
+    unsigned _min_unachieved;
 
     //! A counter to count the number of unsatisfied goals
     UnsatisfiedGoalAtomsCounter _unsat_goal_atoms_heuristic;
@@ -171,7 +212,10 @@ public:
         _problem(model.getTask()),
         _featureset(features),
         _search_novelty_factory(_problem, config.evaluator_t, _featureset.uses_extra_features(), config.search_width),
-        _wgr_novelty_evaluators(3), // We'll only care about novelties 1 and, at most, 2.
+        _wgr_novelty_evaluators(),
+        _reclaim_tables(config._global_config.getOption<bool>("bfws.reclaim_tables", false)),
+        _growable_tables(config._global_config.getOption<bool>("bfws.growable_tables", false)),
+        _min_unachieved(std::numeric_limits<unsigned>::max()),
         _unsat_goal_atoms_heuristic(_problem.getGoalConditions(), _problem.get_tuple_index()),
         _stats(stats),
         _sbfwsconfig(config),
@@ -180,7 +224,7 @@ public:
     }
 
     ~SBFWSHeuristic() {
-        for (auto& elem:_wgr_novelty_evaluators) for (auto& p:elem) delete p.second;
+        for (auto& elem:_wgr_novelty_evaluators) for (auto* evaluator:elem.second.evaluators) delete evaluator;
     };
 
 
@@ -188,22 +232,32 @@ public:
         return _r_counter->count(node, _stats);
     }
 
+    //! Whether the type of the node was computed with a fallback #r, because the simulation
+    //! that determines its set R was still running on some worker thread
+    bool has_provisional_type(const NodeT& node) const {
+        return _r_counter->provisional(node);
+    }
+
     unsigned compute_node_complex_type(NodeT& node) {
 // 		LPT_INFO("types", "Type=" << compute_node_complex_type(node.unachieved_subgoals, get_hash_r(node)) << " for node: " << std::endl << node)
 // 		LPT_INFO("hash_r", "#r=" << get_hash_r(node) << " for node: " << std::endl << node)
-        return compute_node_complex_type(node.unachieved_subgoals, get_hash_r(node));
+        unsigned relaxed_achieved = get_hash_r(node);
+        // Nodes with a provisional #r get tables of their own, so that they do not pollute those of the actual type <#g, 0>
+        if (has_provisional_type(node)) return _indexer.provisional(node.unachieved_subgoals);
+        return compute_node_complex_type(node.unachieved_subgoals, relaxed_achieved);
     }
 
-    unsigned evaluate_wgr1(NodeT& node) {
-        unsigned type = compute_node_complex_type(node);
-        unsigned ptype = node.has_parent() ? compute_node_complex_type(*(node.parent)) : 0;
-        return evaluate_novelty(node, _wgr_novelty_evaluators, 1, type, ptype);
+    //! Note that the type of the node (and of its parent) is expected to have been computed beforehand.
+    //! The novelty can only be computed incrementally from that of the parent while the parent is open, since
+    //! the tables of its type, against which it was evaluated, might have been reclaimed afterwards.
+    unsigned evaluate_wgr1(NodeT& node, bool incremental) {
+        unsigned ptype = node.has_parent() ? node.parent->_type : 0;
+        return evaluate_novelty(node, 1, node._type, ptype, incremental);
     }
 
-    unsigned evaluate_wgr2(NodeT& node) {
-        unsigned type = compute_node_complex_type(node);
-        unsigned ptype = node.has_parent() ? compute_node_complex_type(*(node.parent)) : 0;
-        return evaluate_novelty(node, _wgr_novelty_evaluators, 2, type, ptype);
+    unsigned evaluate_wgr2(NodeT& node, bool incremental) {
+        unsigned ptype = node.has_parent() ? node.parent->_type : 0;
+        return evaluate_novelty(node, 2, node._type, ptype, incremental);
     }
 
 
@@ -224,21 +278,26 @@ public:
         return ind;
     }
 
-
-    NoveltyEvaluatorT* fetch_evaluator(NoveltyEvaluatorMapT& evaluator_map,  unsigned k, unsigned type) {
-        auto it = evaluator_map.find(type);
-        if (it == evaluator_map.end()) {
-            auto inserted = evaluator_map.insert(std::make_pair(type, _search_novelty_factory.create_evaluator(k)));
-            _stats.search_table_created(k);
-            it = inserted.first;
+    //! Return the width-k novelty table of the type of the given node, creating it if necessary
+    NoveltyEvaluatorT* fetch_evaluator(const NodeT& node, unsigned k) {
+        TypeTables& tables = fetch_type_tables(node);
+        if (k >= tables.evaluators.size()) tables.evaluators.resize(k+1, nullptr);
+
+        NoveltyEvaluatorT*& evaluator = tables.evaluators[k];
+        if (!evaluator) {
+            bool growable = _growable_tables && k > 1 && tables.unachieved > _min_unachieved;
+            evaluator = growable ? _search_novelty_factory.create_growable_evaluator(k) : _search_novelty_factory.create_evaluator(k);
+            std::size_t bytes = growable ? 0 : _search_novelty_factory.expected_evaluator_size(k);
+            tables.bytes += bytes;
+            _stats.search_table_created(k, bytes);
         }
-        return it->second;
+        return evaluator;
     }
 
-    unsigned evaluate_novelty(const NodeT& node, std::vector<NoveltyEvaluatorMapT>& evaluator_map, unsigned k, unsigned type, unsigned parent_type) {
-        NoveltyEvaluatorT* evaluator = fetch_evaluator(evaluator_map[k], k, type);
+    unsigned evaluate_novelty(const NodeT& node, unsigned k, unsigned type, unsigned parent_type, bool incremental) {
+        NoveltyEvaluatorT* evaluator = fetch_evaluator(node, k);
 
-        if (node.has_parent() && type == parent_type) {
+        if (incremental && node.has_parent() && type == parent_type) {
             // Important: the novel-based computation works only when the parent has the same novelty type and thus goes against the same novelty tables!!!
             return evaluator->evaluate(_featureset.evaluate(node.state), _featureset.evaluate(node.parent->state), k);
         }
@@ -246,11 +305,109 @@ public:
         return evaluator->evaluate(_featureset.evaluate(node.state), k);
     }
 
+    //! To be invoked on a newly-generated node, once its #g is known, with the changeset that produced its state
+    void node_generated(NodeT& node, const std::vector<Atom>& changeset) {
+        _r_counter->node_generated(node, changeset);
+    }
+
+    //! To be invoked whenever a node is inserted in the open list
+    void node_opened(const NodeT& node) {
+        ++fetch_type_tables(node).open;
+    }
+
+    //! To be invoked once a node has been fully expanded. If this was the last open node of its type,
+    //! and the type has a #g above the minimum #g reached so far, its tables can be reclaimed.
+    void node_expanded(const NodeT& node, unsigned min_unachieved) {
+        auto it = _wgr_novelty_evaluators.find(node._type);
+        assert(it != _wgr_novelty_evaluators.end() && it->second.open > 0);
+        --(it->second.open);
+        if (is_dead(it->second, min_unachieved)) reclaim(it);
+    }
+
+    //! To be invoked whenever an open node is moved from the given previous type into its current type
+    void node_retyped(const NodeT& node, unsigned previous_type, unsigned min_unachieved) {
+        auto it = _wgr_novelty_evaluators.find(previous_type);
+        assert(it != _wgr_novelty_evaluators.end() && it->second.open > 0);
+        --(it->second.open);
+        if (is_dead(it->second, min_unachieved)) reclaim(it);
+        node_opened(node);
+    }
+
+    //! To be invoked whenever a new minimum #g is reached. Reclaim the tables of all types that are dead
+    //! wrt the new minimum, i.e. types with higher #g and no open node
+    void reclaim_tables(unsigned min_unachieved) {
+        _min_unachieved = min_unachieved;
+        if (!_reclaim_tables) return;
+        for (auto it = _wgr_novelty_evaluators.begin(); it != _wgr_novelty_evaluators.end(); ) {
+            if (is_dead(it->second, min_unachieved)) it = reclaim(it);
+            else ++it;
+        }
+    }
+
     unsigned compute_unachieved(const State& state) {
         return _unsat_goal_atoms_heuristic.evaluate(state);
     }
 
+    //! Compute #g for the given node, incrementally from that of its parent if the changeset that
+    //! produced the node from its parent is given
+    unsigned compute_unachieved(const NodeT& node, const std::vector<Atom>* changeset) {
+        if (!changeset || !node.has_parent()) return compute_unachieved(node.state);
+        return _unsat_goal_atoms_heuristic.evaluate(node.state, node.parent->state, node.parent->unachieved_subgoals, *changeset);
+    }
+
+    //! Whether a state with the given #g is a goal state. Only valid when the goal is a conjunction of atoms.
+    bool is_goal(unsigned unachieved) const {
+        assert(_unsat_goal_atoms_heuristic.is_atomic());
+        return unachieved == 0;
+    }
+
+    //! Whether the goal is a conjunction of atoms, in which case #g alone tells whether a state is a goal
+    bool has_atomic_goal() const { return _unsat_goal_atoms_heuristic.is_atomic(); }
+
 protected:
+    TypeTables& fetch_type_tables(const NodeT& node) {
+        auto it = _wgr_novelty_evaluators.find(node._type);
+        if (it == _wgr_novelty_evaluators.end()) {
+            it = _wgr_novelty_evaluators.insert(std::make_pair(node._type, TypeTables{node.unachieved_subgoals, 0, {}, 0, _indexer.is_provisional(node._type)})).first;
+            if (was_reclaimed(node.unachieved_subgoals, _indexer.relaxed_achieved(node._type))) {
+                _reclaimed_types[node.unachieved_subgoals][_indexer.relaxed_achieved(node._type)] = false;
+                LPT_DEBUG("search", "Re-entering reclaimed novelty type " << node._type << ", novelty of the type is reset");
+                _stats.search_type_reentered();
+            }
+        }
+        return it->second;
+    }
+
+    //! Whether the tables of the given type can be dropped: throwaway tables as soon as no node of the type is open,
+    //! and the tables of actual types only if reclaiming is enabled and their #g is above the given minimum
+    bool is_dead(const TypeTables& tables, unsigned min_unachieved) const {
+        if (tables.open > 0) return false;
+        return tables.provisional || (_reclaim_tables && tables.unachieved > min_unachieved);
+    }
+
+    typename NoveltyEvaluatorMapT::iterator reclaim(typename NoveltyEvaluatorMapT::iterator it) {
+        const TypeTables& tables = it->second;
+        unsigned num_tables = 0;
+        for (auto* evaluator:tables.evaluators) {
+            if (evaluator) ++num_tables;
+            delete evaluator;
+        }
+        if (!tables.provisional) {
+            _stats.search_tables_reclaimed(num_tables, tables.bytes);
+            unsigned relaxed_achieved = _indexer.relaxed_achieved(it->first);
+            if (tables.unachieved >= _reclaimed_types.size()) _reclaimed_types.resize(tables.unachieved + 1);
+            std::vector<bool>& reclaimed = _reclaimed_types[tables.unachieved];
+            if (relaxed_achieved >= reclaimed.size()) reclaimed.resize(relaxed_achieved + 1, false);
+            reclaimed[relaxed_achieved] = true;
+        }
+        return _wgr_novelty_evaluators.erase(it);
+    }
+
+    bool was_reclaimed(unsigned unachieved, unsigned relaxed_achieved) const {
+        return unachieved < _reclaimed_types.size() && relaxed_achieved < _reclaimed_types[unachieved].size()
+               && _reclaimed_types[unachieved][relaxed_achieved];
+    }
+
 #ifdef DEBUG
     // Just for sanity check purposes
     std::map<unsigned, std::tuple<unsigned,unsigned>> __novelty_idx_values;
@@ -414,9 +571,14 @@ public:
 
         while (!_open.empty() && !_solution) {
             auto node = _open.next();
+            if (rekey(node)) continue;
             process_node(node);
         }
 
+        if (_monotonicity_csp_manager) {
+            _stats.set_monot_paths(_monotonicity_csp_manager->native_nodes(), _monotonicity_csp_manager->gecode_nodes());
+        }
+
         return extract_plan(_solution, plan);
     }
 
@@ -426,32 +588,28 @@ protected:
     //! When opening a node, we compute #g and evaluate whether the given node has <#g>-novelty 1 or not;
     //! if that is the case, we insert it into a special queue.
     //! Returns true iff the newly-created node is a solution
-    bool create_node(const NodePT& node) {
+    //! The changeset that produced the state of the node from that of its parent is expected for all nodes but the root
+    bool create_node(const NodePT& node, const std::vector<Atom>* changeset = nullptr) {
+        // Compute #g upfront, which for conjunctive goals also tells whether the node is a goal
+        node->unachieved_subgoals = _heuristic.compute_unachieved(*node, changeset);
+
         if (is_goal(node)) {
             LPT_INFO("search", "Goal node was found");
             _solution = node;
             return true;
         }
 
-        // Compute #g upfront
-        node->unachieved_subgoals = _heuristic.compute_unachieved(node->state);
-
         // Print some stats if a new low in number of unreached subgoals has been reached
         if (node->unachieved_subgoals < _min_subgoals_to_reach) {
             _min_subgoals_to_reach = node->unachieved_subgoals;
             LPT_INFO("search", "Min. # unreached subgoals: " << _min_subgoals_to_reach << "/" << _model.num_subgoals());
+            _heuristic.reclaim_tables(_min_subgoals_to_reach);
         }
 
-        node->w_g_r = 999;
-        unsigned nov = _heuristic.evaluate_wgr1(*node);
-        if (nov == 1) {
-            node->w_g_r = 1;
+        if (changeset) _heuristic.node_generated(*node, *changeset);
 
-        } else if (_novelty_levels == 3) {
-            if (_heuristic.evaluate_wgr2(*node) == 2) {
-                node->w_g_r = 2;
-            }
-        }
+        node->_type = _heuristic.compute_node_complex_type(*node);
+        evaluate_novelty(node, true);
 
         if (node->w_g_r == 1) _stats.wgr1_node();
         else if (node->w_g_r == 2) _stats.wgr2_node();
@@ -459,17 +617,54 @@ protected:
 
 
         _open.insert(node);
-
+        _heuristic.node_opened(*node);
 
         if (node->decreases_unachieved_subgoals()) _stats.generation_g_decrease();
 
         return false;
     }
 
+    //! Compute the novelty w_{#g,#r} of the node, whose type is expected to have been computed beforehand,
+    //! incrementally from its parent if the node is being generated
+    void evaluate_novelty(const NodePT& node, bool generated) {
+        node->w_g_r = 999;
+        unsigned nov = _heuristic.evaluate_wgr1(*node, generated);
+        if (nov == 1) {
+            node->w_g_r = 1;
+
+        } else if (_novelty_levels == 3) {
+            if (_heuristic.evaluate_wgr2(*node, generated) == 2) {
+                node->w_g_r = 2;
+            }
+        }
+    }
+
+    //! A node that was queued with a provisional type, because the simulation that determines its #r
+    //! was still running, is re-keyed when popped from the open list if the simulation has finished meanwhile,
+    //! i.e. its novelty is evaluated against the tables of its actual type for the first time.
+    //! Returns true iff the node has been re-inserted into the open list under a different type.
+    //! Nodes whose simulation has not finished yet are expanded speculatively with their provisional type.
+    bool rekey(const NodePT& node) {
+        if (!_heuristic.has_provisional_type(*node)) return false;
+
+        unsigned type = _heuristic.compute_node_complex_type(*node);
+        if (_heuristic.has_provisional_type(*node) || type == node->_type) return false;
+
+        unsigned previous_type = node->_type;
+        node->_type = type;
+        _heuristic.node_retyped(*node, previous_type, _min_subgoals_to_reach);
+        evaluate_novelty(node, false);
+        _open.insert(node);
+        _stats.rekeyed_node();
+        return true;
+    }
+
     //! Process the node.
     void process_node(const NodePT& node) {
         _closed.put(node);
         expand_node(node);
+        // Only once the node is fully expanded, so that its children of the same type can still reuse the tables
+        _heuristic.node_expanded(*node, _min_subgoals_to_reach);
     }
 
     float node_generation_rate() {
@@ -520,7 +715,7 @@ protected:
                 }
             }
 
-            if (create_node(successor)) {
+            if (create_node(successor, &_model.get_last_changeset())) {
                 break;
             }
 
@@ -535,7 +730,9 @@ protected:
         return _open.contains(node);
     }
 
+    //! Expects the #g value of the node to have been computed beforehand
     inline bool is_goal(const NodePT& node) const {
+        if (_heuristic.has_atomic_goal()) return _heuristic.is_goal(node->unachieved_subgoals);
         return _model.goal(node->state);
     }
 
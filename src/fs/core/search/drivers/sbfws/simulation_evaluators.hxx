@@ -1,6 +1,7 @@
 
 #pragma once
 
+#include <algorithm>
 #include <utility>
 #include <utility>
 #include <vector>
@@ -13,6 +14,8 @@
 #include <fs/core/actions/actions.hxx>
 #include <fs/core/languages/fstrips/terms.hxx>
 #include <fs/core/problem_info.hxx>
+#include <fs/core/search/novelty/tuple_novelty.hxx>
+#include <fs/core/utils/sparse_bitset.hxx>
 
 
 namespace fs0::bfws {
@@ -22,7 +25,8 @@ namespace fs0::bfws {
 template<typename NodeT>
 class SimulationEvaluatorI {
 public:
-    virtual unsigned evaluate(NodeT& node) = 0;
+    //! Evaluate the novelty of the given node, whose parent node is given (null for the seed node)
+    virtual unsigned evaluate(NodeT& node, const NodeT* parent) = 0;
 
     virtual void reset() = 0;
 
@@ -47,12 +51,12 @@ public:
 
     ~SimulationEvaluator() = default;
 
-    unsigned evaluate(NodeT& node) override {
-        if (node.parent) {
+    unsigned evaluate(NodeT& node, const NodeT* parent) override {
+        if (parent) {
             // Important: the novel-based computation works only when the parent has the same novelty type and thus goes against the same novelty tables!!!
-            node._w = _evaluator->evaluate(_features.evaluate(node.state), _features.evaluate(node.parent->state));
+            node._w = _evaluator->evaluate(_features.evaluate(node.state()), _features.evaluate(parent->state()));
         } else {
-            node._w = _evaluator->evaluate(_features.evaluate(node.state));
+            node._w = _evaluator->evaluate(_features.evaluate(node.state()));
         }
 
         return node._w;
@@ -70,15 +74,81 @@ public:
 };
 
 
+//! A simulation evaluator for arbitrary widths, which keeps the seen tuples of each width in a hash set
+template<typename NodeT, typename FeatureSetT>
+class TupleSimulationEvaluator : public SimulationEvaluatorI<NodeT> {
+protected:
+    const AtomIndex& _atom_idx;
+
+    //! The set of features used to compute the novelty
+    const FeatureSetT& _features;
+
+    TupleNoveltyEvaluator _evaluator;
+
+    //! _reached[i] iff the atom with index 'i' has been seen in some evaluated state
+    std::vector<bool> _reached;
+
+public:
+    TupleSimulationEvaluator(const AtomIndex& atom_idx, const FeatureSetT& features, unsigned max_width, bool ignore_neg_literals) :
+            _atom_idx(atom_idx),
+            _features(features),
+            _evaluator(max_width, ignore_neg_literals),
+            _reached(atom_idx.size(), false)
+    {}
+
+    unsigned evaluate(NodeT& node, const NodeT* parent) override {
+        const auto& valuation = _features.evaluate(node.state());
+        if (parent) {
+            const auto& parent_valuation = _features.evaluate(parent->state());
+            node._w = _evaluator.evaluate(valuation, &parent_valuation);
+        } else {
+            node._w = _evaluator.evaluate(valuation);
+        }
+        mark_reached(node, parent);
+        return node._w;
+    }
+
+    std::vector<bool> reached_atoms() const override {
+        return _reached;
+    }
+
+    void reset() override {
+        _evaluator.reset();
+        _reached = std::vector<bool>(_atom_idx.size(), false);
+    }
+
+    void info() const override {
+        for (unsigned k = 1; k <= _evaluator.max_width(); ++k) {
+            const auto& table = _evaluator.table(k);
+            LPT_INFO("cout", "Simulation - Width-" << k << " tuple table: " << table.size() << " tuples, "
+                        << table.bytes() / 1024 << " KB, " << table.collisions() << " fingerprint collisions");
+        }
+    }
+
+protected:
+    //! Mark the atoms of the node's state that are new wrt its parent
+    void mark_reached(const NodeT& node, const NodeT* parent) {
+        if (parent) {
+            for (const Atom& atom:node.changeset) {
+                if (_atom_idx.is_indexed(atom.getVariable(), atom.getValue())) _reached[_atom_idx.to_index(atom)] = true;
+            }
+            return;
+        }
+
+        const State& state = node.state();
+        for (VariableIdx var = 0, n = state.numAtoms(); var < n; ++var) {
+            object_id value = state.getValue(var);
+            if (_atom_idx.is_indexed(var, value)) _reached[_atom_idx.to_index(var, value)] = true;
+        }
+    }
+};
+
+
 struct AchieverNoveltyConfiguration {
-    AchieverNoveltyConfiguration(
-            unsigned long max_table_size,
-            bool break_on_first_novel) :
-        max_table_size_(max_table_size),
+    explicit AchieverNoveltyConfiguration(bool break_on_first_novel) :
         break_on_first_novel_(break_on_first_novel)
     {}
 
-    unsigned long max_table_size_;
     bool break_on_first_novel_;
 };
 
@@ -135,9 +205,23 @@ public:
         max_precondition_size_(max_precondition_size),
         nvars_(nvars),
         reached_(n_, false),
-        seen_(delta_table_size(), false),
-        r_tables_(r_table_size(), false)
+        seen_(),
+        r_tables_(),
+        precondition_index_(nvars),
+        base_node_(nullptr),
+        base_values_(nvars),
+        unsatisfied_(operators_.size(), 0),
+        base_factors_(nvars, 0),
+        factors_(nvars, 0),
+        touched_(),
+        changed_factors_()
     {
+        for (unsigned op = 0, n = operators_.size(); op < n; ++op) {
+            for (const auto& pre:operators_[op].precondition_) {
+                precondition_index_[pre.first].emplace_back(op, pre.second);
+            }
+        }
+
 //        std::unordered_set<unsigned> idxs;
 //        for (unsigned q = 0; q < n_; ++q) {
 //            for (unsigned p = 0; p < n_; ++p) {
@@ -158,31 +242,75 @@ public:
 //        throw std::runtime_error("NICE");
     }
 
+    //! The size of the index spaces of the (sparse) tables
     std::size_t r_table_size() const {
-        return n_*n_-1;
+        return std::size_t(n_)*n_;
     }
 
     std::size_t delta_table_size() const {
-        return n_*n_*(max_precondition_size_+1+1);
+        return std::size_t(n_)*n_*(max_precondition_size_+1+1);
     }
 
-    //! Return the "achiever satisfaction factor" #q(s) for the given state s and atom q,
+    //! Return the "achiever satisfaction factor" #q(s) for the current state s and atom q,
     //! which is the min k such that there is a ground action that achieves q and has
-    //! k unsatisfied preconditions in state s
-    unsigned compute_achiever_satisfaction_factor(const State& state, unsigned var) const {
-        unsigned min_unach_precs = std::numeric_limits<unsigned>::max();
-        for (const auto& actionidx:achievers_[var]) {
-            unsigned unachieved = 0;
-            for (const auto& pre:operators_[actionidx].precondition_) {
-                if (state.getValue(pre.first) != pre.second) {
-                    unachieved++;
+    //! k unsatisfied preconditions in state s. Requires a previous call to prepare_factors on the node of s.
+    unsigned achiever_satisfaction_factor(unsigned var) const {
+        return factors_[var];
+    }
+
+    //! Compute the achiever satisfaction factors of all atoms on the state of the given node.
+    //! The factors of a node are derived from those of its parent, which are in turn derived from those of the
+    //! previously expanded node when its first child is evaluated, see compute_base_factors. Only the variables in the effects of the action that produced the node can differ
+    //! from the parent: the counters of unsatisfied preconditions are updated only for the operators with some
+    //! precondition on one of these variables, and the factors are recomputed only for the atoms achieved by
+    //! one of these operators.
+    void prepare_factors(const NodeT& node, const NodeT* parent) {
+        // Undo the changes made to the factors of the base node for the previously evaluated state
+        for (unsigned q:changed_factors_) factors_[q] = base_factors_[q];
+        changed_factors_.clear();
+
+        if (!parent) {
+            compute_base_factors(node);
+            return;
+        }
+        compute_base_factors(*parent);
+
+        const State& state = node.state();
+        const State& base = parent->state();
+        const auto& effects = operators_[get_action_id(node.action)].effects_;
+        touched_.clear();
+        for (auto it = effects.begin(); it != effects.end(); ++it) {
+            VariableIdx var = it->first;
+            object_id before = base.getValue(var), after = state.getValue(var);
+            if (before == after) continue;
+
+            // Several (conditional) effects might affect the same variable
+            auto same_var = [var](const std::pair<VariableIdx, object_id>& eff) { return eff.first == var; };
+            if (std::any_of(effects.begin(), it, same_var)) continue;
+
+            for (const auto& pre:precondition_index_[var]) {
+                if (before == pre.second) {
+                    ++unsatisfied_[pre.first];
+                    touched_.emplace_back(pre.first, true);
+                } else if (after == pre.second) {
+                    --unsatisfied_[pre.first];
+                    touched_.emplace_back(pre.first, false);
                 }
             }
-            min_unach_precs = std::min(min_unach_precs, unachieved);
         }
-//        std::cout << "k=" << min_unach_precs << "; " << state << std::endl;
 
-        return min_unach_precs;
+        for (const auto& touched:touched_) {
+            for (unsigned q:op_adds_[touched.first]) {
+                factors_[q] = min_unsatisfied_preconditions(q);
+                changed_factors_.push_back(q);
+            }
+        }
+
+        // Restore the counters of the parent, from which the rest of its children will be evaluated
+        for (const auto& touched:touched_) {
+            if (touched.second) --unsatisfied_[touched.first];
+            else ++unsatisfied_[touched.first];
+        }
     }
 
     std::vector<bool> reached_atoms() const override {
@@ -190,15 +318,20 @@ public:
     }
 
     void reset() override {
-//        seen_.swap(std::vector<bool>(delta_table_size(), false));
-//        reached_.swap(std::vector<bool>(nvars_, false));
-        reached_.clear();
+        reached_ = std::vector<bool>(n_, false);
+        base_node_ = nullptr;
+        changed_factors_.clear();
         seen_.clear();
         r_tables_.clear();
     }
 
-    unsigned evaluate(NodeT& node) override {
-        const State& state = node.state;
+    void info() const override {
+        LPT_INFO("cout", "Simulation - Achiever tables: " << seen_.num_blocks() << " + " << r_tables_.num_blocks()
+                    << " allocated blocks, " << (seen_.bytes() + r_tables_.bytes()) / 1024 << " KB");
+    }
+
+    unsigned evaluate(NodeT& node, const NodeT* parent) override {
+        const State& state = node.state();
 
         const auto& valuation = get_valuation(this->_featureset.evaluate(state));
         assert(state.numAtoms() == nvars_);
@@ -233,6 +366,8 @@ public:
 
         if (is_novel) return 1;
 
+        prepare_factors(node, parent);
+
         // Check <q, delta(q)> contexts
         for (unsigned q = 0; q < nvars_; ++q) {
             auto qval = make_object(valuation[q]);
@@ -245,7 +380,7 @@ public:
                 k = max_precondition_size_+1;
 
             } else {
-                k = this->compute_achiever_satisfaction_factor(state, q);
+                k = achiever_satisfaction_factor(q);
 //            if (k == std::numeric_limits<unsigned>::max()) continue;  // Atom q has no possible achiever.
                 if (k == std::numeric_limits<unsigned>::max()) k = 0;
             }
@@ -279,15 +414,9 @@ public:
 
         reached_[pidx] = true;
 
-        unsigned atom_index = _combine_indexes(k, qidx, pidx, this->atom_idx_.size());
-        assert(atom_index < seen_.size());
-        auto&& ref = seen_[atom_index];
-        if (!ref) { // The tuple is new
-            ref = true;
-            return true;
-        }
-
-        return false;
+        std::size_t atom_index = _combine_indexes(k, qidx, pidx, this->atom_idx_.size());
+        assert(atom_index < delta_table_size());
+        return seen_.test_and_set(atom_index); // i.e. whether the tuple is new
     }
 
     bool process_p_for_context_r(const std::vector<bool>& valuation, VariableIdx p, unsigned num_atoms_true) {
@@ -298,18 +427,79 @@ public:
         reached_[pidx] = true;
 
         auto rindex = _combine_rcontext_indexes(pidx, num_atoms_true, n_);
-        assert(rindex < r_tables_.size());
-        auto&& ref = r_tables_[rindex];
-        if (!ref) { // The tuple is new
-            ref = true;
-            return true;
+        assert(rindex < r_table_size());
+        return r_tables_.test_and_set(rindex); // i.e. whether the tuple is new
+    }
+
+
+protected:
+    //! Set the counters of unsatisfied preconditions of all operators, along with the achiever satisfaction factors
+    //! of all atoms, to those on the state of the given node, unless they are already. They are computed from scratch
+    //! for the first node only, and otherwise updated from those of the previous base node: when the two nodes are
+    //! parent and child, or siblings, only the variables in their changesets can differ.
+    void compute_base_factors(const NodeT& node) {
+        if (base_node_ == &node) return;
+        const NodeT* previous = base_node_;
+        base_node_ = &node;
+
+        const State& state = node.state();
+        if (!previous) {
+            for (unsigned var = 0; var < nvars_; ++var) base_values_[var] = state.getValue(var);
+            for (unsigned op = 0, n = operators_.size(); op < n; ++op) {
+                unsigned unsatisfied = 0;
+                for (const auto& pre:operators_[op].precondition_) {
+                    if (state.getValue(pre.first) != pre.second) ++unsatisfied;
+                }
+                unsatisfied_[op] = unsatisfied;
+            }
+
+            for (unsigned q = 0; q < nvars_; ++q) base_factors_[q] = min_unsatisfied_preconditions(q);
+            factors_ = base_factors_;
+            return;
         }
 
-        return false;
+        touched_.clear();
+        if (node.parent == previous->_id) {
+            for (const Atom& atom:node.changeset) update_base_value(state, atom.getVariable());
+        } else if (node.has_parent() && node.parent == previous->parent) {
+            for (const Atom& atom:previous->changeset) update_base_value(state, atom.getVariable());
+            for (const Atom& atom:node.changeset) update_base_value(state, atom.getVariable());
+        } else {
+            for (unsigned var = 0; var < nvars_; ++var) update_base_value(state, var);
+        }
+
+        for (const auto& touched:touched_) {
+            for (unsigned q:op_adds_[touched.first]) {
+                base_factors_[q] = factors_[q] = min_unsatisfied_preconditions(q);
+            }
+        }
     }
 
+    //! Update the counters of the operators with some precondition on the given variable to its value in the given state
+    void update_base_value(const State& state, VariableIdx var) {
+        object_id before = base_values_[var], after = state.getValue(var);
+        if (before == after) return;
+        base_values_[var] = after;
+
+        for (const auto& pre:precondition_index_[var]) {
+            if (before == pre.second) {
+                ++unsatisfied_[pre.first];
+                touched_.emplace_back(pre.first, true);
+            } else if (after == pre.second) {
+                --unsatisfied_[pre.first];
+                touched_.emplace_back(pre.first, false);
+            }
+        }
+    }
+
+    unsigned min_unsatisfied_preconditions(unsigned var) const {
+        unsigned min_unach_precs = std::numeric_limits<unsigned>::max();
+        for (const auto& actionidx:achievers_[var]) {
+            min_unach_precs = std::min(min_unach_precs, unsatisfied_[actionidx]);
+        }
+        return min_unach_precs;
+    }
 
-protected:
     const AtomIndex& atom_idx_;
 
     unsigned n_;
@@ -322,12 +512,38 @@ protected:
 
     std::vector<std::vector<unsigned>> achievers_;
 
-    const AchieverNoveltyConfiguration& config_;
+    const AchieverNoveltyConfiguration config_;
     unsigned max_precondition_size_;
     unsigned nvars_;
     std::vector<bool> reached_;
-    std::vector<bool> seen_;
-    std::vector<bool> r_tables_;
+
+    //! The tables of seen <k, q, p> and <#true, p> tuples, which are sparse, since only a tiny
+    //! fraction of their (quadratic) index space is ever touched
+    SparseBitset<> seen_;
+    SparseBitset<> r_tables_;
+
+    //! precondition_index_[var] contains all pairs <o, v> such that operator o has precondition var=v
+    std::vector<std::vector<std::pair<unsigned, object_id>>> precondition_index_;
+
+    //! The node to whose state the counters and base factors below correspond (usually, the node being expanded)
+    const NodeT* base_node_;
+
+    //! The values of all state variables in the state of the base node
+    std::vector<object_id> base_values_;
+
+    //! unsatisfied_[o] is the number of unsatisfied preconditions of operator o in the state of the base node
+    std::vector<unsigned> unsatisfied_;
+
+    //! The achiever satisfaction factors of all atoms in the state of the base node, and in the state being evaluated
+    std::vector<unsigned> base_factors_;
+    std::vector<unsigned> factors_;
+
+    //! The operators whose counters have been increased (true) or decreased (false) for the state being evaluated,
+    //! or for the state of the base node, when it changes
+    std::vector<std::pair<unsigned, bool>> touched_;
+
+    //! The atoms whose factors in the state being evaluated differ (possibly) from those in the state of the base node
+    std::vector<unsigned> changed_factors_;
 };
 
 //! Factory method: create an specialized achiever-evaluator based on the potential
@@ -341,7 +557,8 @@ std::unique_ptr<BitvectorAchieverNoveltyEvaluator<NodeT, FeatureSetT, NoveltyEva
 create_achiever_evaluator(const Problem& problem,
         const FeatureSetT& features,
         const std::vector<SASPlusOperator>& operators,
-        const AchieverNoveltyConfiguration& config) {
+        const AchieverNoveltyConfiguration& config,
+        bool logging = true) {
 
     const auto& atom_idx = problem.get_tuple_index();
     unsigned nvars = ProblemInfo::getInstance().getNumVariables();
@@ -365,12 +582,14 @@ create_achiever_evaluator(const Problem& problem,
         }
     }
 
-    unsigned long expected_table_entries = nvars*nvars*(max_precondition_size+1);
+    unsigned long expected_table_entries = (unsigned long) nvars*nvars*(max_precondition_size+1);
     unsigned long expected_delta_table_size_in_kb = expected_table_entries / (8 * 1024); // size in kilobytes
 
-    LPT_INFO("cout", "Max. precondition size: " << max_precondition_size);
-    LPT_INFO("cout", "Num. state variables: " << nvars);
-    LPT_INFO("cout", "Expected table size: " << expected_delta_table_size_in_kb << "KB (entries: " << expected_table_entries << ", max. size: " << config.max_table_size_ <<")");
+    if (logging) {
+        LPT_INFO("cout", "Max. precondition size: " << max_precondition_size);
+        LPT_INFO("cout", "Num. state variables: " << nvars);
+        LPT_INFO("cout", "Dense table size would be: " << expected_delta_table_size_in_kb << "KB (entries: " << expected_table_entries << "); allocating sparse tables on demand");
+    }
 
     using ET = BitvectorAchieverNoveltyEvaluator<NodeT, FeatureSetT, NoveltyEvaluatorT>;
     return std::make_unique<ET>(atom_idx, features, operators, op_adds, achievers, max_precondition_size, nvars, config);
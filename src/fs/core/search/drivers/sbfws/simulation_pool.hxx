@@ -0,0 +1,115 @@
+
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <fs/core/models/simple_state_model.hxx>
+#include <fs/core/problem.hxx>
+
+
+namespace fs0::bfws {
+
+//! Return an independent copy of the given model, built over the given (private) copy of its problem,
+//! that can be safely used from a worker thread, or null if the model type does not support it. Models
+//! cannot be shared among threads, since they hold mutable caches (e.g. the last changeset), and lifted
+//! models also share their CSPs / SDD managers among copies.
+template <typename ModelT>
+std::unique_ptr<ModelT> clone_model_for_worker(const ModelT& model, const Problem& problem) { return nullptr; }
+
+template <>
+inline std::unique_ptr<SimpleStateModel> clone_model_for_worker(const SimpleStateModel& model, const Problem& problem) {
+    return std::make_unique<SimpleStateModel>(SimpleStateModel::build(problem));
+}
+
+
+//! A fixed-size pool of worker threads that run IW simulations off the search thread.
+//! Each worker owns a private context, which is handed to the tasks it runs, and which must hold a private
+//! copy of every object that the tasks might mutate, even if only through lazily-computed caches.
+//! Tasks must not access any other object shared with the search thread, except for the ProblemInfo
+//! and Config singletons, which are immutable once the problem has been loaded.
+template <typename ContextT>
+class SimulationWorkerPool {
+public:
+    using TaskT = std::function<void (ContextT&)>;
+
+    //! Factory method. Returns null if no context is given
+    static std::unique_ptr<SimulationWorkerPool<ContextT>> create(std::vector<std::unique_ptr<ContextT>>&& contexts) {
+        if (contexts.empty()) return nullptr;
+        return std::unique_ptr<SimulationWorkerPool<ContextT>>(new SimulationWorkerPool<ContextT>(std::move(contexts)));
+    }
+
+    ~SimulationWorkerPool() {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _stop = true;
+            _tasks.clear(); // Tasks not yet started are simply discarded
+        }
+        _cv.notify_all();
+        for (auto& worker:_workers) worker.join();
+    }
+
+    SimulationWorkerPool(const SimulationWorkerPool&) = delete;
+    SimulationWorkerPool(SimulationWorkerPool&&) = delete;
+    SimulationWorkerPool& operator=(const SimulationWorkerPool&) = delete;
+    SimulationWorkerPool& operator=(SimulationWorkerPool&&) = delete;
+
+    //! Enqueue the given task, to be run by the first available worker, and return a future to its result
+    template <typename ResultT>
+    std::future<ResultT> submit(std::function<ResultT (ContextT&)> task) {
+        auto packaged = std::make_shared<std::packaged_task<ResultT (ContextT&)>>(std::move(task));
+        std::future<ResultT> result = packaged->get_future();
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _tasks.emplace_back([packaged](ContextT& context) { (*packaged)(context); });
+        }
+        _cv.notify_one();
+        return result;
+    }
+
+    unsigned size() const { return _workers.size(); }
+
+protected:
+    explicit SimulationWorkerPool(std::vector<std::unique_ptr<ContextT>>&& contexts) :
+        _contexts(std::move(contexts)), _stop(false)
+    {
+        for (const auto& context:_contexts) {
+            _workers.emplace_back([this, &context]() { work(*context); });
+        }
+    }
+
+    void work(ContextT& context) {
+        while (true) {
+            TaskT task;
+            {
+                std::unique_lock<std::mutex> lock(_mutex);
+                _cv.wait(lock, [this]() { return _stop || !_tasks.empty(); });
+                if (_stop) return;
+                task = std::move(_tasks.front());
+                _tasks.pop_front();
+            }
+            task(context);
+        }
+    }
+
+    //! _contexts[i] is the private context of the i-th worker
+    std::vector<std::unique_ptr<ContextT>> _contexts;
+
+    std::vector<std::thread> _workers;
+
+    std::deque<TaskT> _tasks;
+
+    std::mutex _mutex;
+
+    std::condition_variable _cv;
+
+    bool _stop;
+};
+
+} // namespaces
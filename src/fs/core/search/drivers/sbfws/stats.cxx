@@ -7,16 +7,44 @@
 
 namespace fs0::bfws {
 
-BFWSStats::BFWSStats() : _expanded(0), _generated(0), _evaluated(0),
+BFWSStats::BFWSStats() : _expanded(0), _generated(0), _evaluated(0), _simulations(0),
     _initial_reachable_subgoals(std::numeric_limits<unsigned>::max()),
     _max_reachable_subgoals(0),
     _sum_reachable_subgoals(0),
     _initial_relevant_atoms(std::numeric_limits<unsigned>::max()),
     _max_relevant_atoms(0),
     _sum_relevant_atoms(0),
+    _r_type(0),
+    _monot_pruned(0),
+    _monot_native(0),
+    _monot_gecode(0),
+    _rekeyed_nodes(0),
+    _reused_simulation_nodes(0),
+    _r_cache_hits(0),
+    _r_cache_misses(0),
+    _sim_expanded_nodes(0),
+    _sim_generated_nodes(0),
+    _sim_time(0),
     _initial_search_time(-1)
 {}
 
+void BFWSStats::add_simulation_stats(const BFWSStats& other) {
+    _simulations += other._simulations;
+    _sim_expanded_nodes += other._sim_expanded_nodes;
+    _sim_generated_nodes += other._sim_generated_nodes;
+    _sim_time += other._sim_time;
+    _max_reachable_subgoals = std::max(_max_reachable_subgoals, other._max_reachable_subgoals);
+    _sum_reachable_subgoals += other._sum_reachable_subgoals;
+    _max_relevant_atoms = std::max(_max_relevant_atoms, other._max_relevant_atoms);
+    _sum_relevant_atoms += other._sum_relevant_atoms;
+    if (other._r_type) _r_type = other._r_type;
+    if (_initial_reachable_subgoals == std::numeric_limits<unsigned>::max()) _initial_reachable_subgoals = other._initial_reachable_subgoals;
+    if (_initial_relevant_atoms == std::numeric_limits<unsigned>::max()) _initial_relevant_atoms = other._initial_relevant_atoms;
+
+    if (other._sim_wtables.size() > _sim_wtables.size()) _sim_wtables.resize(other._sim_wtables.size());
+    for (unsigned k = 0; k < other._sim_wtables.size(); ++k) _sim_wtables[k] += other._sim_wtables[k];
+}
+
 std::string
 BFWSStats::_if_computed(unsigned val) {
     return val < std::numeric_limits<unsigned>::max() ?  std::to_string(val) : "N/A";
@@ -60,6 +88,9 @@ std::vector<BFWSStats::DataPointT> BFWSStats::dump() const {
         std::make_tuple("sim_avg_reached_subgoals", "Avg. number of subgoals reached during simulations", _avg(_sum_reachable_subgoals, _simulations)),
 
         std::make_tuple("reused_simulation_nodes", "Simulation nodes reused in the search", std::to_string(_reused_simulation_nodes)),
+        std::make_tuple("r_cache_hits", "Simulations avoided by reusing a cached set R", std::to_string(_r_cache_hits)),
+        std::make_tuple("r_cache_misses", "Simulations run after a miss in the cache of sets R", std::to_string(_r_cache_misses)),
+        std::make_tuple("rekeyed_nodes", "Open nodes re-keyed once their (provisional) #r became available", std::to_string(_rekeyed_nodes)),
 
         std::make_tuple("r_type", "Type of R set", std::to_string(_r_type)),
 
@@ -70,7 +101,16 @@ std::vector<BFWSStats::DataPointT> BFWSStats::dump() const {
         std::make_tuple("sim_relevant_atoms_max", "|R|_max", std::to_string(_max_relevant_atoms)),
         std::make_tuple("sim_relevant_atoms_avg", "|R|_avg", _avg(_sum_relevant_atoms, _simulations)),
 
-        std::make_tuple("_nodes_pruned_monotonicity", "Nodes pruned by monotonicity constraints", std::to_string(_monot_pruned))
+        std::make_tuple("_nodes_pruned_monotonicity", "Nodes pruned by monotonicity constraints", std::to_string(_monot_pruned)),
+        std::make_tuple("monotonicity_native", "Nodes with monotonicity CSP propagated natively", std::to_string(_monot_native)),
+        std::make_tuple("monotonicity_gecode", "Nodes with monotonicity CSP propagated by Gecode", std::to_string(_monot_gecode)),
+
+        std::make_tuple("search_live_tables", "Search novelty tables alive at the end of the search", std::to_string(_search_live_tables)),
+        std::make_tuple("search_peak_live_tables", "Max. # search novelty tables alive at any moment", std::to_string(_search_peak_live_tables)),
+        std::make_tuple("search_reclaimed_tables", "Search novelty tables reclaimed", std::to_string(_search_reclaimed_tables)),
+        std::make_tuple("search_reentered_types", "Reclaimed <#g,#r> types later re-entered (novelty reset)", std::to_string(_search_reentered_types)),
+        std::make_tuple("search_live_tables_kb", "Est. size of search novelty tables alive at the end of the search (KB)", std::to_string(_search_live_bytes / 1024)),
+        std::make_tuple("search_peak_live_tables_kb", "Max. est. size of search novelty tables alive at any moment (KB)", std::to_string(_search_peak_live_bytes / 1024))
     };
 
     for (unsigned k = 1; k < _sim_wtables.size(); ++k) {
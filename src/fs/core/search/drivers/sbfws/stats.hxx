@@ -1,6 +1,7 @@
 
 #pragma once
 
+#include <cassert>
 #include <tuple>
 #include <vector>
 
@@ -25,22 +26,47 @@ public:
 
     void simulation() { ++_simulations; }
     void simulation_node_reused() { ++_reused_simulation_nodes; }
+    void r_cache_hit() { ++_r_cache_hits; }
+    void r_cache_miss() { ++_r_cache_misses; }
     void sim_add_expanded_nodes(unsigned number) { _sim_expanded_nodes += number; }
     void sim_add_generated_nodes(unsigned number) { _sim_generated_nodes += number; }
     void sim_add_time(float time) { _sim_time += time; }
 
     void monot_pruned() { ++_monot_pruned; }
+    void set_monot_paths(unsigned long native, unsigned long gecode) { _monot_native = native; _monot_gecode = gecode; }
+
+    void rekeyed_node() { ++_rekeyed_nodes; }
+
+    //! Add up the simulation-related statistics collected in the given object, e.g. by a simulation
+    //! run on a worker thread, to the stats of this object.
+    void add_simulation_stats(const BFWSStats& other);
 
     void sim_table_created(unsigned k) {
         if (k >= _sim_wtables.size()) _sim_wtables.resize(k+1);
         ++_sim_wtables[k];
     }
 
-    void search_table_created(unsigned k) {
+    void search_table_created(unsigned k, std::size_t bytes) {
         if (k >= _search_wtables.size()) _search_wtables.resize(k+1);
         ++_search_wtables[k];
+        ++_search_live_tables;
+        _search_live_bytes += bytes;
+        _search_peak_live_tables = std::max(_search_peak_live_tables, _search_live_tables);
+        _search_peak_live_bytes = std::max(_search_peak_live_bytes, _search_live_bytes);
     }
 
+    void search_tables_reclaimed(unsigned num_tables, std::size_t bytes) {
+        assert(_search_live_tables >= num_tables && _search_live_bytes >= bytes);
+        _search_live_tables -= num_tables;
+        _search_live_bytes -= bytes;
+        _search_reclaimed_tables += num_tables;
+    }
+
+    void search_type_reentered() { ++_search_reentered_types; }
+
+    unsigned long search_live_tables() const { return _search_live_tables; }
+    std::size_t search_live_bytes() const { return _search_live_bytes; }
+
     void expansion_g_decrease() { ++_num_expanded_g_decrease; }
     void generation_g_decrease() { ++_num_generated_g_decrease; }
 
@@ -121,8 +147,14 @@ protected:
     unsigned long _num_generated_g_decrease; // The number of nodes with a decrease in #g that are expanded
 
     unsigned long _monot_pruned;
+    unsigned long _monot_native; // The number of nodes whose monotonicity CSP was propagated natively
+    unsigned long _monot_gecode; // The number of nodes whose monotonicity CSP was propagated with Gecode
+
+    unsigned long _rekeyed_nodes; // The number of open nodes re-keyed after their provisional #r became final
 
     unsigned _reused_simulation_nodes;
+    unsigned long _r_cache_hits; // The number of simulations avoided by reusing a cached set R
+    unsigned long _r_cache_misses;
 
     unsigned long _sim_expanded_nodes;
     unsigned long _sim_generated_nodes;
@@ -131,6 +163,16 @@ protected:
     //! _sim_wtables[w] contains the number of width-w novelty tables created during simulation
     std::vector<unsigned> _sim_wtables;
     std::vector<unsigned> _search_wtables;
+
+    //! The number of search novelty tables currently alive, and their (estimated) size in bytes.
+    //! Note that only tables with a size known in advance contribute to the byte count.
+    unsigned long _search_live_tables = 0;
+    unsigned long _search_peak_live_tables = 0;
+    unsigned long _search_reclaimed_tables = 0;
+    unsigned long _search_reentered_types = 0;
+    std::size_t _search_live_bytes = 0;
+    std::size_t _search_peak_live_bytes = 0;
+
     float   _initial_reward = 0.0f;
     float   _max_reward = -std::numeric_limits<float>::max();
 
@@ -21,6 +21,25 @@ GroundingSetup::sdd_lifted_model(Problem& problem) {
     return SDDLiftedStateModel::build(problem);
 }
 
+JoinLiftedStateModel
+GroundingSetup::join_lifted_model(Problem& problem) {
+	// We don't ground any action
+	problem.setPartiallyGroundedActions(ActionGrounder::fully_lifted(problem.getActionData(), ProblemInfo::getInstance()));
+	return JoinLiftedStateModel::build(problem, ProblemInfo::getInstance());
+}
+
+HybridStateModel
+GroundingSetup::hybrid_model(Problem& problem) {
+	const ProblemInfo& info = ProblemInfo::getInstance();
+	const auto& action_data = problem.getActionData();
+	std::vector<const GroundAction*> grounded;
+	std::vector<bool> ground = HybridStateModel::select_ground_schemas(action_data, info, grounded);
+
+	problem.setGroundActions(std::move(grounded));
+	problem.setPartiallyGroundedActions(ActionGrounder::fully_lifted(action_data, info));
+	return HybridStateModel::build(problem, info, ground);
+}
+
 
 GroundStateModel
 GroundingSetup::fully_ground_model(Problem& problem) {
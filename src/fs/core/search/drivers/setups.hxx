@@ -3,6 +3,8 @@
 
 #include <fs/core/models/csp_lifted_state_model.hxx>
 #include <fs/core/models/sdd_lifted_state_model.hxx>
+#include <fs/core/models/join_lifted_state_model.hxx>
+#include <fs/core/models/hybrid_state_model.hxx>
 #include <fs/core/models/ground_state_model.hxx>
 #include <fs/core/models/simple_state_model.hxx>
 
@@ -19,6 +21,12 @@ public:
 	static CSPLiftedStateModel csp_lifted_model(Problem& problem);
 
     static SDDLiftedStateModel sdd_lifted_model(Problem& problem);
+
+	//! A lifted model whose applicable actions are computed natively through joins
+	static JoinLiftedStateModel join_lifted_model(Problem& problem);
+
+	//! A model that grounds the action schemas with few groundings and keeps the rest lifted
+	static HybridStateModel hybrid_model(Problem& problem);
 	
 	//! A simple model with all grounded actions
 	static GroundStateModel fully_ground_model(Problem& problem);
@@ -0,0 +1,19 @@
+
+#include <fs/core/search/drivers/symbolic_breadth_first_search.hxx>
+
+#include <fs/core/problem_info.hxx>
+#include <fs/core/search/algorithms/symbolic_breadth_first_search.hxx>
+#include <fs/core/search/utils.hxx>
+#include <fs/core/search/drivers/setups.hxx>
+
+
+namespace fs0::drivers {
+
+ExitCode
+SymbolicBreadthFirstSearchDriver::search(Problem& problem, const Config& config, const EngineOptions& options, float start_time) {
+	auto model = GroundingSetup::sdd_lifted_model(problem);
+	SymbolicBreadthFirstSearch engine(model, ProblemInfo::getInstance());
+	return Utils::SearchExecution<SDDLiftedStateModel>(model).do_search(engine, options, start_time, _stats);
+}
+
+} // namespaces
@@ -0,0 +1,21 @@
+
+#pragma once
+
+#include <fs/core/search/drivers/registry.hxx>
+#include <fs/core/search/stats.hxx>
+
+
+namespace fs0 { class Config; }
+
+namespace fs0::drivers {
+
+//! A creator for the symbolic Breadth-First Search engine, which works on the SDDs of the action schemas
+class SymbolicBreadthFirstSearchDriver : public Driver {
+public:
+	ExitCode search(Problem& problem, const Config& config, const EngineOptions& options, float start_time) override;
+
+protected:
+	SearchStats _stats;
+};
+
+} // namespaces
@@ -0,0 +1,134 @@
+
+#include <algorithm>
+#include <cassert>
+#include <stdexcept>
+
+#include <fs/core/search/novelty/tuple_novelty.hxx>
+
+namespace fs0::bfws {
+
+TupleFingerprintSet::TupleFingerprintSet(unsigned width) :
+	_width(width), _fingerprints(1024, 0), _ids(1024, EMPTY), _tuples(), _size(0), _collisions(0)
+{
+	assert(width > 0);
+}
+
+uint64_t TupleFingerprintSet::fingerprint(const AtomT* tuple, unsigned width) {
+	// A simple 64-bit mixing in the style of splitmix64
+	uint64_t h = 0x9E3779B97F4A7C15ULL * width;
+	for (unsigned i = 0; i < width; ++i) {
+		h ^= tuple[i] + 0x9E3779B97F4A7C15ULL + (h << 6) + (h >> 2);
+		h = (h ^ (h >> 30)) * 0xBF58476D1CE4E5B9ULL;
+		h = (h ^ (h >> 27)) * 0x94D049BB133111EBULL;
+		h ^= (h >> 31);
+	}
+	return h;
+}
+
+bool TupleFingerprintSet::equal(uint32_t id, const AtomT* tuple) const {
+	return std::equal(tuple, tuple + _width, _tuples.begin() + std::size_t(id)*_width);
+}
+
+bool TupleFingerprintSet::insert(const AtomT* tuple) {
+	uint64_t fp = fingerprint(tuple, _width);
+	std::size_t mask = _ids.size() - 1;
+
+	std::size_t slot = fp & mask;
+	for (; _ids[slot] != EMPTY; slot = (slot + 1) & mask) {
+		if (_fingerprints[slot] != fp) continue;
+		if (equal(_ids[slot], tuple)) return false;
+		++_collisions; // Same fingerprint, different tuple: keep probing
+	}
+
+	if (_size == EMPTY) throw std::runtime_error("TupleFingerprintSet: too many tuples");
+
+	_fingerprints[slot] = fp;
+	_ids[slot] = _size++;
+	_tuples.insert(_tuples.end(), tuple, tuple + _width);
+
+	if (2 * _size > _ids.size()) grow(); // Keep the load factor at most 0.5
+	return true;
+}
+
+void TupleFingerprintSet::grow() {
+	std::vector<uint64_t> fingerprints(2 * _fingerprints.size(), 0);
+	std::vector<uint32_t> ids(2 * _ids.size(), EMPTY);
+	std::size_t mask = ids.size() - 1;
+
+	for (std::size_t i = 0; i < _ids.size(); ++i) {
+		if (_ids[i] == EMPTY) continue;
+		std::size_t slot = _fingerprints[i] & mask;
+		while (ids[slot] != EMPTY) slot = (slot + 1) & mask;
+		fingerprints[slot] = _fingerprints[i];
+		ids[slot] = _ids[i];
+	}
+	_fingerprints.swap(fingerprints);
+	_ids.swap(ids);
+}
+
+std::size_t TupleFingerprintSet::bytes() const {
+	return _fingerprints.capacity() * sizeof(uint64_t) + _ids.capacity() * sizeof(uint32_t) + _tuples.capacity() * sizeof(AtomT);
+}
+
+void TupleFingerprintSet::clear() {
+	std::fill(_ids.begin(), _ids.end(), EMPTY);
+	_tuples.clear();
+	_size = 0;
+	_collisions = 0;
+}
+
+
+TupleNoveltyEvaluator::TupleNoveltyEvaluator(unsigned max_width, bool ignore_neg_literals) :
+	_tables(), _ignore_neg_literals(ignore_neg_literals), _atoms(), _num_new(0), _positions(), _tuple()
+{
+	for (unsigned k = 1; k <= max_width; ++k) _tables.emplace_back(k);
+}
+
+unsigned TupleNoveltyEvaluator::evaluate_atoms() {
+	unsigned novelty = std::numeric_limits<unsigned>::max();
+
+	// All tables need to be updated, not only up to the first width with a new tuple
+	for (unsigned k = max_width(); k >= 1; --k) {
+		if (insert_tuples(k)) novelty = k;
+	}
+	return novelty;
+}
+
+bool TupleNoveltyEvaluator::insert_tuples(unsigned k) {
+	unsigned n = _atoms.size();
+	if (_num_new == 0 || n < k) return false;
+
+	TupleFingerprintSet& table = _tables[k-1];
+	bool novel = false;
+
+	// Enumerate all combinations of k positions p_1 < ... < p_k with p_1 < _num_new, in lexicographic order
+	_positions.resize(k);
+	_tuple.resize(k);
+	for (unsigned i = 0; i < k; ++i) _positions[i] = i;
+
+	while (_positions[0] < _num_new) {
+		for (unsigned i = 0; i < k; ++i) _tuple[i] = _atoms[_positions[i]];
+		std::sort(_tuple.begin(), _tuple.end());
+		if (table.insert(_tuple.data())) novel = true;
+
+		// Advance to the next combination
+		int i = k - 1;
+		while (i >= 0 && _positions[i] == n - k + i) --i;
+		if (i < 0) break;
+		++_positions[i];
+		for (unsigned j = i + 1; j < k; ++j) _positions[j] = _positions[j-1] + 1;
+	}
+	return novel;
+}
+
+void TupleNoveltyEvaluator::reset() {
+	for (auto& table:_tables) table.clear();
+}
+
+std::size_t TupleNoveltyEvaluator::bytes() const {
+	std::size_t total = 0;
+	for (const auto& table:_tables) total += table.bytes();
+	return total;
+}
+
+} // namespaces
@@ -0,0 +1,123 @@
+
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+namespace fs0::bfws {
+
+//! A set of k-tuples of novelty atoms, where each atom is a <feature, value> pair encoded in a 64-bit word.
+//! Rather than allocating a table that is indexed by all possible k-tuples, which is unfeasible for k >= 3,
+//! the set keeps an open-addressing table with the 64-bit fingerprints of the tuples actually seen, plus
+//! an exact copy of each tuple in an append-only buffer, against which a tuple is verified whenever its
+//! fingerprint coincides with that of some tuple already in the set. Each tuple thus takes k words of the
+//! buffer plus its slots in the table: memory is only saved wrt a table indexed by all k-tuples.
+class TupleFingerprintSet {
+public:
+	using AtomT = uint64_t;
+
+	explicit TupleFingerprintSet(unsigned width);
+
+	//! Insert the given tuple, expected to be sorted, and return true iff it was not already in the set
+	bool insert(const AtomT* tuple);
+
+	unsigned width() const { return _width; }
+
+	std::size_t size() const { return _size; }
+
+	//! The number of times that two different tuples have been found to share the same fingerprint
+	unsigned long collisions() const { return _collisions; }
+
+	//! The (approximate) number of bytes used by the set
+	std::size_t bytes() const;
+
+	void clear();
+
+protected:
+	static constexpr uint32_t EMPTY = std::numeric_limits<uint32_t>::max();
+
+	static uint64_t fingerprint(const AtomT* tuple, unsigned width);
+
+	//! Whether the tuple with the given identifier in the buffer is equal to the given tuple
+	bool equal(uint32_t id, const AtomT* tuple) const;
+
+	void grow();
+
+	const unsigned _width;
+
+	//! _fingerprints[i] is the fingerprint of the tuple with identifier _ids[i], unless _ids[i] == EMPTY
+	std::vector<uint64_t> _fingerprints;
+	std::vector<uint32_t> _ids;
+
+	//! The tuple with identifier i is stored in positions [i*k, (i+1)*k) of the buffer
+	std::vector<AtomT> _tuples;
+
+	std::size_t _size;
+
+	unsigned long _collisions;
+};
+
+
+//! A novelty evaluator of arbitrary width k, backed by one TupleFingerprintSet per width 1..k.
+//! Meant for widths k >= 3, for which no specialized atom evaluator exists.
+class TupleNoveltyEvaluator {
+public:
+	using AtomT = TupleFingerprintSet::AtomT;
+
+	TupleNoveltyEvaluator(unsigned max_width, bool ignore_neg_literals);
+
+	//! Return the novelty of the given feature valuation, i.e. the minimum k such that the valuation contains
+	//! some k-tuple not seen before, or std::numeric_limits<unsigned>::max() if there is no such k <= max_width.
+	//! If the valuation of the parent state is given, only tuples with some atom not in the parent are considered,
+	//! since all others have already been considered when evaluating the parent.
+	template <typename ValuationT>
+	unsigned evaluate(const ValuationT& valuation, const ValuationT* parent = nullptr) {
+		using FeatureValueT = typename ValuationT::value_type;
+		_atoms.clear();
+		_num_new = 0;
+
+		// New atoms are placed first, so that a tuple contains some new atom iff its first atom is new
+		for (unsigned i = 0, sz = valuation.size(); i < sz; ++i) {
+			const auto& value = valuation[i];
+			if (std::is_same<FeatureValueT, bool>::value && _ignore_neg_literals && !value) continue;
+
+			AtomT atom = (AtomT(i) << 32) | uint32_t(int(value));
+			_atoms.push_back(atom);
+			if (!parent || (*parent)[i] != value) {
+				std::swap(_atoms[_num_new++], _atoms.back());
+			}
+		}
+		return evaluate_atoms();
+	}
+
+	unsigned max_width() const { return _tables.size(); }
+
+	void reset();
+
+	//! The table of width-k tuples, for k in [1..max_width]
+	const TupleFingerprintSet& table(unsigned k) const { return _tables.at(k-1); }
+
+	std::size_t bytes() const;
+
+protected:
+	unsigned evaluate_atoms();
+
+	//! Insert all k-tuples in the current atoms with a new first atom, returning true iff some was not seen before
+	bool insert_tuples(unsigned k);
+
+	std::vector<TupleFingerprintSet> _tables;
+
+	bool _ignore_neg_literals;
+
+	//! The atoms of the valuation under evaluation; the first _num_new of them are new wrt the parent
+	std::vector<AtomT> _atoms;
+	unsigned _num_new;
+
+	//! Some buffers to enumerate tuples
+	std::vector<unsigned> _positions;
+	std::vector<AtomT> _tuple;
+};
+
+} // namespaces
@@ -4,6 +4,7 @@
 #include <fs/core/state.hxx>
 #include <fs/core/problem_info.hxx>
 #include <fs/core/atom.hxx>
+#include <fs/core/derived_atoms.hxx>
 
 
 namespace fs0 {
@@ -76,7 +77,8 @@ State::State(const StateAtomIndexer& index, const std::vector<Atom>& atoms) :
 	_indexer(index),
 	_bool_values(index.num_bool(), false),
 	_int_values(index.num_int(), object_id::INVALID),
-    _hash(0)
+    _hash(0),
+	_derived(nullptr)
 {
 	// Note that those facts not explicitly set in the initial state will be initialized to 0, i.e. "false", which is convenient to us.
 	for (const Atom& atom:atoms) { // Insert all the elements of the vector
@@ -85,6 +87,36 @@ State::State(const StateAtomIndexer& index, const std::vector<Atom>& atoms) :
 	updateHash();
 }
 
+State::State(const State& other) :
+	_indexer(other._indexer),
+	_bool_values(other._bool_values),
+	_int_values(other._int_values),
+	_hash(other._hash),
+	_derived(other._derived.load(std::memory_order_acquire))
+{
+	if (DerivedAtomTable* derived = _derived.load(std::memory_order_relaxed)) intrusive_ptr_add_ref(derived);
+}
+
+State::State(State&& other) :
+	_indexer(other._indexer),
+	_bool_values(std::move(other._bool_values)),
+	_int_values(std::move(other._int_values)),
+	_hash(other._hash),
+	_derived(other._derived.exchange(nullptr, std::memory_order_acq_rel))
+{}
+
+State::~State() { release_derived(); }
+
+State State::detached_copy() const {
+	State copy(*this);
+	copy.release_derived();
+	return copy;
+}
+
+void State::release_derived() {
+	if (DerivedAtomTable* derived = _derived.exchange(nullptr, std::memory_order_acq_rel)) intrusive_ptr_release(derived);
+}
+
 State::State(const State& state, const std::vector<Atom>& atoms) :
 	State(state) {
     update(atoms);
@@ -113,6 +145,10 @@ void State::update(const std::vector<Atom>& atoms) {
 	for (const Atom& fact:atoms) {
 		set(fact);
 	}
+	if (DerivedAtomTable* derived = _derived.load(std::memory_order_acquire)) {
+		_derived.store(AxiomEvaluator::successor(*derived, atoms).detach(), std::memory_order_release);
+		intrusive_ptr_release(derived);
+	}
 	updateHash(); // Important to update the hash value after all the changes have been applied!
 }
 
@@ -2,6 +2,9 @@
 #pragma once
 
 #include <fs/core/fs_types.hxx>
+
+#include <atomic>
+#include <memory>
 // #include <fs/core/utils/bitsets.hxx>
 
 
@@ -12,6 +15,8 @@ class Atom;
 class StateAtomIndexer;
 class ProblemInfo;
 class State;
+class DerivedAtomTable;
+class AxiomEvaluator;
 
 class StateAtomIndexer {
 public:
@@ -52,6 +57,7 @@ public:
 
 class State {
 	friend class StateAtomIndexer;
+	friend class AxiomEvaluator;
 public:
 	// using BitsetT = boost::dynamic_bitset<>;
 	using BitsetT = std::vector<bool>;
@@ -65,13 +71,18 @@ protected:
 
 	std::size_t _hash;
 
+	//! The values of the derived atoms in the state, computed lazily by the axiom evaluator,
+	//! and possibly shared with other states that only differ in variables irrelevant to the axioms.
+	//! The state holds a reference to the table, which is installed atomically by the evaluator.
+	mutable std::atomic<DerivedAtomTable*> _derived;
+
 	//! Construct a state specifying the values of all state variables
 	//! Note that it is not necessarily the case that numAtoms == atoms.size(); since the initial values of
 	//! some (Boolean) state variables is often left unspecified and understood to be false.
 	State(const StateAtomIndexer& index, const std::vector<Atom>& atoms);
 
 public:
-	~State() = default;
+	~State();
 
 	//! Factory method
 	static State* create(const StateAtomIndexer& index, unsigned numAtoms, const std::vector<Atom>& atoms);
@@ -81,9 +92,13 @@ public:
 	//! state plus the new atoms. Note that we do not check that there are no contradictory atoms.
 	State(const State& state, const std::vector<Atom>& atoms);
 
-	//! Default copy constructors and assignment operators
-	State(const State&) = default;
-	State(State&&) = default;
+	//! Copy constructors share the table of derived atoms of the original state
+	State(const State& other);
+	State(State&& other);
+
+	//! Return a copy of the state that does not share its table of derived atoms, e.g. to evaluate the
+	//! axioms of the copy with the evaluator of a different copy of the problem
+	State detached_copy() const;
 	State& operator=(const State&) = delete;
 	State& operator=(State&&) = delete;
 
@@ -109,6 +124,7 @@ public:
 	template <typename T>
 	void __set( const VariableIdx& var, const T& v ) {
 		set( Atom( var, make_object(v)) );
+		release_derived();
 	}
 
 	void updateHash() { _hash = computeHash(); }
@@ -117,6 +133,9 @@ public:
 protected:
 	void set(const Atom& atom);
 
+	//! Drop the reference to the table of derived atoms, if any
+	void release_derived();
+
 
 	std::size_t computeHash() const;
 
@@ -0,0 +1,61 @@
+
+#pragma once
+
+#include <bitset>
+#include <memory>
+#include <vector>
+
+namespace fs0 {
+
+//! A fixed-size bitset split into blocks of BlockBits bits that are shared among copies of the bitset
+//! and copied only when written to (copy-on-write). Copying the bitset thus takes time and memory proportional
+//! to the number of blocks, not of bits, and each write allocates at most one new block.
+//! Blocks where no bit has ever been set are not allocated at all.
+//! Note that the bitset is not thread-safe: a bitset and its copies must be used from a single thread.
+template <std::size_t BlockBits = 1024>
+class CowBitset {
+public:
+	using BlockT = std::bitset<BlockBits>;
+
+	explicit CowBitset(std::size_t size) :
+		_size(size), _blocks((size + BlockBits - 1) / BlockBits)
+	{}
+
+	std::size_t size() const { return _size; }
+
+	bool test(std::size_t i) const {
+		const auto& block = _blocks[i / BlockBits];
+		return block && block->test(i % BlockBits);
+	}
+
+	//! Set the i-th bit, and return true iff it was previously unset
+	bool test_and_set(std::size_t i) {
+		auto& block = _blocks[i / BlockBits];
+		if (block && block->test(i % BlockBits)) return false;
+
+		if (!block) block = std::make_shared<BlockT>();
+		else if (block.use_count() > 1) block = std::make_shared<BlockT>(*block); // The block is shared, copy it before writing
+		block->set(i % BlockBits);
+		return true;
+	}
+
+	//! Unset all bits
+	void reset() {
+		for (auto& block:_blocks) block.reset();
+	}
+
+	//! The number of set bits
+	std::size_t count() const {
+		std::size_t total = 0;
+		for (const auto& block:_blocks) if (block) total += block->count();
+		return total;
+	}
+
+protected:
+	std::size_t _size;
+
+	//! A null block stands for a block with all bits unset
+	std::vector<std::shared_ptr<BlockT>> _blocks;
+};
+
+} // namespaces
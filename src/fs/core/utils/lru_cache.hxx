@@ -0,0 +1,62 @@
+
+#pragma once
+
+#include <list>
+#include <unordered_map>
+
+namespace fs0 {
+
+//! A bounded key-value cache that, when full, evicts the least recently used entry.
+//! A cache with zero capacity is disabled and stores nothing.
+template <typename KeyT, typename ValueT, typename HashT = std::hash<KeyT>>
+class LRUCache {
+public:
+	explicit LRUCache(std::size_t capacity) :
+		_capacity(capacity), _entries(), _index(), _hits(0), _misses(0)
+	{}
+
+	bool enabled() const { return _capacity > 0; }
+
+	//! Return a pointer to the value stored under the given key, or null if there is none.
+	//! The pointer is valid until the next insertion.
+	const ValueT* find(const KeyT& key) {
+		auto it = _index.find(key);
+		if (it == _index.end()) {
+			++_misses;
+			return nullptr;
+		}
+		++_hits;
+		_entries.splice(_entries.begin(), _entries, it->second); // Mark the entry as the most recently used
+		return &(it->second->second);
+	}
+
+	void insert(const KeyT& key, ValueT value) {
+		if (!enabled() || _index.find(key) != _index.end()) return;
+		if (_entries.size() == _capacity) {
+			_index.erase(_entries.back().first);
+			_entries.pop_back();
+		}
+		_entries.emplace_front(key, std::move(value));
+		_index.emplace(key, _entries.begin());
+	}
+
+	std::size_t size() const { return _entries.size(); }
+
+	unsigned long hits() const { return _hits; }
+	unsigned long misses() const { return _misses; }
+
+protected:
+	using EntryListT = std::list<std::pair<KeyT, ValueT>>;
+
+	const std::size_t _capacity;
+
+	//! The cached entries, from most to least recently used
+	EntryListT _entries;
+
+	std::unordered_map<KeyT, typename EntryListT::iterator, HashT> _index;
+
+	unsigned long _hits;
+	unsigned long _misses;
+};
+
+} // namespaces
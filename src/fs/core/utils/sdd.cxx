@@ -13,12 +13,24 @@
 
 #include <sdd/sddapi.hxx>
 
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
 #include <boost/filesystem.hpp>   // includes all needed Boost.Filesystem declarations
 #include <boost/algorithm/string.hpp>
 #include <boost/format.hpp>
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <iomanip>
 #include <iostream>
 #include <memory>
+#include <sstream>
+#include <thread>
 #include <fs/core/utils/config.hxx>
 
 namespace fsys = boost::filesystem;
@@ -36,114 +48,353 @@ SDDModel::value_t truth_value(SddNode* node) {
     return sdd_node_literal(node) < 0 ? SDDModel::value_t::False : SDDModel::value_t::True;
 }
 
-//! Loads from disk all SDDs in the given directory (one per action schema)
-std::vector<std::shared_ptr<ActionSchemaSDD>>
-load_sdds_from_disk(const std::vector<const PartiallyGroundedAction*>& schemas, const std::string& dir) {
+namespace {
+
+using RelevantVarsT = std::vector<std::pair<VariableIdx, unsigned>>;
+using ParamBindingsT = std::vector<std::vector<std::pair<object_id, unsigned>>>;
+
+//! The binary variant of the atoms and bindings bookkeeping files of a schema is a sequence of 32-bit words:
+//!   - A header with the magic number, the format version, the number of state variables and of objects of the problem,
+//!     the sizes and hashes of the text files it was created from, the number R of relevant atoms and the number P of
+//!     parameters.
+//!   - R pairs (state variable, SDD variable).
+//!   - P numbers with the count of possible bindings of each parameter.
+//!   - For each parameter, and for each of its bindings, a triple (object type, object value, SDD variable).
+//! The file is written by the planner itself when the text files are parsed and option 'sdd.write_bookkeeping' is set,
+//! and used as long as the problem and the text files are the same as when it was written. Since the state variables
+//! and objects are already resolved, it can be mapped into memory and read without any parsing.
+const uint32_t BOOKKEEPING_MAGIC = 0x4253444Fu;
+const uint32_t BOOKKEEPING_VERSION = 2;
+const std::size_t BOOKKEEPING_HEADER_SIZE = 10;
+
+void parse_atoms_file(const fsys::path& path, RelevantVarsT& relevant) {
     const ProblemInfo& info = ProblemInfo::getInstance();
-    const Config& config = Config::instance();
-
-    std::vector<std::shared_ptr<ActionSchemaSDD>> sdds;
+    std::ifstream is(path.string());
+    if (is.fail()) {
+        throw std::runtime_error("Could not open filename '" + path.filename().string() + "'");
+    }
+    std::string line;
+    while (std::getline(is, line)) {
+        // each line is of the form "holding,c:5"
+        std::vector<std::string> strings;
+        boost::split(strings, line, boost::is_any_of(":"));
+        assert(strings.size() == 2);
+        auto sdd_varid = boost::lexical_cast<unsigned>(strings[1]);
+
+        boost::split(strings, strings[0], boost::is_any_of(","));
+        assert(!strings.empty()); // We'll have at least the id of the symbol
+        auto symbol_id = info.getSymbolId(strings[0]);
+
+        std::vector<object_id> constant_values;
+        // Iterate but skipping first one
+        for (std::size_t i = 1; i < strings.size(); ++i) constant_values.emplace_back(info.get_object_id(strings[i]));
+        VariableIdx varid = info.resolveStateVariable(symbol_id, constant_values);
+
+        relevant.emplace_back(varid, sdd_varid);
+    }
+}
 
-    fsys::path path(dir);
-    if (!fsys::exists(path)) throw std::runtime_error("Non-existing base SDD directory: " + dir);
+void parse_bindings_file(const fsys::path& path, ParamBindingsT& bindings) {
+    const ProblemInfo& info = ProblemInfo::getInstance();
+    std::ifstream is(path.string());
+    if (is.fail()) {
+        throw std::runtime_error("Could not open filename '" + path.filename().string() + "'");
+    }
 
-    for (const auto& schema:schemas) {
-        // Each action schema has a number of filenames starting with the name of the schema
-        const std::string& schema_name = schema->getName();
-        std::string mng_fname = str(format("%1%.manager.sdd") % schema_name);
-        std::string vtree_fname = str(format("%1%.vtree.sdd") % schema_name);
-        std::string atoms_fname = str(format("%1%.atoms.data") % schema_name);
-        std::string bindings_fname = str(format("%1%.bindings.data") % schema_name);
-
-        // Load vtree and manager
-        LPT_DEBUG("cout", "Loading SDD and bookkeeping info corresponding to action \"" << schema_name << "\"");
-        LPT_DEBUG("cout", "Mem. usage: " << get_current_memory_in_kb() << "kB. (peak: " << get_peak_memory_in_kb() << " kB.)");
-        fsys::path vtree_path = dir / fsys::path(vtree_fname);
-        Vtree* vtree = sdd_vtree_read(vtree_path.string().c_str());
-        SddManager* manager = sdd_manager_new(vtree);
-
-        fsys::path manager_path = dir / fsys::path(mng_fname);
-        SddNode* node = sdd_read(manager_path.string().c_str(), manager);
-        LPT_DEBUG("cout", "Done. SDD Size: " << sdd_size(node));
-
-        if (sdd_node_is_false(node)) {
-            std::cout << "Action " << schema_name << " has no applicable binding and will be ignored." << std::endl;
-            continue;
+    std::string line;
+    while (std::getline(is, line)) {
+        // i-th line is of the form "b:1,d:2,a:3,c:4" and corresponds to the bindings of parameter i of the schema
+        std::vector<std::string> strings;
+        boost::split(strings, line, boost::is_any_of(","));
+
+        std::vector<std::pair<object_id, unsigned>> param_bindings;
+        for (const auto& str:strings) {
+            std::vector<std::string> substrings;
+            boost::split(substrings, str, boost::is_any_of(":"));
+            assert(substrings.size() == 2);
+            const object_id& oid = info.get_object_id(substrings[0]);
+            param_bindings.emplace_back(oid, boost::lexical_cast<unsigned>(substrings[1]));
         }
 
-        // Load bookkeeping info for the schema
-        std::vector<std::pair<VariableIdx, unsigned>> relevant;
+        bindings.push_back(std::move(param_bindings));
+    }
+}
 
-        fsys::path atoms_path = dir / fsys::path(atoms_fname);
-        std::ifstream is(atoms_path.string());
-        if (is.fail()) {
-            throw std::runtime_error("Could not open filename '" + atoms_fname + "'");
+//! A read-only memory mapping of a whole file, unmapped on destruction
+class MappedFile {
+public:
+    explicit MappedFile(const std::string& filename) : data_(nullptr), size_(0) {
+        int fd = ::open(filename.c_str(), O_RDONLY);
+        if (fd < 0) return;
+        struct stat st;
+        if (::fstat(fd, &st) == 0 && st.st_size > 0) {
+            void* data = ::mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (data != MAP_FAILED) {
+                data_ = data;
+                size_ = st.st_size;
+            }
         }
-        std::string line;
-        while (std::getline(is, line)) {
-            // each line is of the form "holding,c:5"
-            std::vector<std::string> strings;
-            boost::split(strings, line, boost::is_any_of(":"));
-            assert(strings.size() == 2);
-            auto sdd_varid = boost::lexical_cast<unsigned>(strings[1]);
-
-            boost::split(strings, strings[0], boost::is_any_of(","));
-            assert(!strings.empty()); // We'll have at least the id of the symbol
-            auto symbol_id = info.getSymbolId(strings[0]);
-
-            std::vector<object_id> constant_values;
-            // Iterate but skipping first one
-            for (std::size_t i = 1; i < strings.size(); ++i) constant_values.emplace_back(info.get_object_id(strings[i]));
-            VariableIdx varid = info.resolveStateVariable(symbol_id, constant_values);
-
-            relevant.emplace_back(varid, sdd_varid);
+        ::close(fd);
+    }
+    ~MappedFile() { if (data_) ::munmap(data_, size_); }
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const uint32_t* words() const { return static_cast<const uint32_t*>(data_); }
+    std::size_t num_words() const { return size_ / sizeof(uint32_t); }
+
+    const unsigned char* bytes() const { return static_cast<const unsigned char*>(data_); }
+    std::size_t size() const { return size_; }
+
+protected:
+    void* data_;
+    std::size_t size_;
+};
+
+//! The part of the header of the binary bookkeeping file that identifies the problem and the text files it was created from
+std::vector<uint32_t> bookkeeping_signature(const std::vector<fsys::path>& sources) {
+    const ProblemInfo& info = ProblemInfo::getInstance();
+    std::vector<uint32_t> signature{info.getNumVariables(), info.num_objects()};
+    for (const auto& source:sources) {
+        // A 32-bit FNV-1a hash of the contents of the file. Empty or unreadable files all hash to the same value.
+        MappedFile file(source.string());
+        uint32_t hash = 2166136261u;
+        for (std::size_t i = 0; i < file.size(); ++i) hash = (hash ^ file.bytes()[i]) * 16777619u;
+        signature.push_back((uint32_t) file.size());
+        signature.push_back(hash);
+    }
+    return signature;
+}
+
+//! Read the binary bookkeeping file, returning false if it does not exist, is not valid, or was not created
+//! for the problem and text files with the given signature
+bool read_binary_bookkeeping(const fsys::path& path, const std::vector<uint32_t>& signature, RelevantVarsT& relevant, ParamBindingsT& bindings) {
+    MappedFile file(path.string());
+    const uint32_t* words = file.words();
+    std::size_t size = file.num_words();
+    if (!words || size < BOOKKEEPING_HEADER_SIZE || words[0] != BOOKKEEPING_MAGIC || words[1] != BOOKKEEPING_VERSION) return false;
+    assert(signature.size() + 4 == BOOKKEEPING_HEADER_SIZE);
+    if (!std::equal(signature.begin(), signature.end(), words + 2)) return false;
+
+    std::size_t nrelevant = words[BOOKKEEPING_HEADER_SIZE-2], nparams = words[BOOKKEEPING_HEADER_SIZE-1];
+    std::size_t pos = BOOKKEEPING_HEADER_SIZE;
+    if (size < pos + 2*nrelevant + nparams) return false;
+
+    relevant.reserve(nrelevant);
+    for (std::size_t i = 0; i < nrelevant; ++i, pos += 2) relevant.emplace_back(words[pos], words[pos+1]);
+
+    const uint32_t* counts = words + pos;
+    pos += nparams;
+
+    bindings.resize(nparams);
+    for (std::size_t p = 0; p < nparams; ++p) {
+        if (size < pos + 3*std::size_t(counts[p])) return false;
+        bindings[p].reserve(counts[p]);
+        for (std::size_t i = 0; i < counts[p]; ++i, pos += 3) {
+            bindings[p].emplace_back(make_object(static_cast<type_id>(words[pos]), words[pos+1]), words[pos+2]);
         }
+    }
+    return pos == size;
+}
 
-        std::vector<std::vector<std::pair<object_id, unsigned>>> bindings;
-        is = std::ifstream((dir / fsys::path(bindings_fname)).string());
-        if (is.fail()) {
-            throw std::runtime_error("Could not open filename '" + bindings_fname + "'");
+//! Write the binary bookkeeping file, returning false if it could not be written
+bool write_binary_bookkeeping(const fsys::path& path, const std::vector<uint32_t>& signature, const RelevantVarsT& relevant, const ParamBindingsT& bindings) {
+    std::vector<uint32_t> words{BOOKKEEPING_MAGIC, BOOKKEEPING_VERSION};
+    words.insert(words.end(), signature.begin(), signature.end());
+    words.push_back((uint32_t) relevant.size());
+    words.push_back((uint32_t) bindings.size());
+    for (const auto& elem:relevant) {
+        words.push_back(elem.first);
+        words.push_back(elem.second);
+    }
+    for (const auto& param_bindings:bindings) words.push_back(param_bindings.size());
+    for (const auto& param_bindings:bindings) {
+        for (const auto& elem:param_bindings) {
+            words.push_back(static_cast<uint32_t>(elem.first.type()));
+            words.push_back(elem.first.value());
+            words.push_back(elem.second);
         }
+    }
 
-        while (std::getline(is, line)) {
-            // i-th line is of the form "b:1,d:2,a:3,c:4" and corresponds to the bindings of parameter i of the schema
-            std::vector<std::string> strings;
-            boost::split(strings, line, boost::is_any_of(","));
-
-            std::vector<std::pair<object_id, unsigned>> param_bindings;
-            for (const auto& str:strings) {
-                std::vector<std::string> substrings;
-                boost::split(substrings, str, boost::is_any_of(":"));
-                assert(substrings.size() == 2);
-                const object_id& oid = info.get_object_id(substrings[0]);
-                param_bindings.emplace_back(oid, boost::lexical_cast<unsigned>(substrings[1]));
-            }
+    // Write to a temporary file first, so that concurrent planner runs never read a partially-written file
+    fsys::path tmp_path = path;
+    tmp_path += str(format(".%1%.tmp") % ::getpid());
+    std::ofstream os(tmp_path.string(), std::ios::binary);
+    os.write(reinterpret_cast<const char*>(words.data()), words.size() * sizeof(uint32_t));
+    os.close();
+
+    boost::system::error_code ec;
+    if (os.fail()) {
+        fsys::remove(tmp_path, ec);
+        return false;
+    }
+    fsys::rename(tmp_path, path, ec);
+    if (ec) {
+        fsys::remove(tmp_path, ec);
+        return false;
+    }
+    return true;
+}
+
+//! Return true iff the given file exists and is at least as recent as all the given files, which must exist too.
+//! This is only a cheap pre-check; the signature stored in the file is what guarantees that it is valid.
+bool is_up_to_date(const fsys::path& path, const std::vector<fsys::path>& sources) {
+    boost::system::error_code ec;
+    std::time_t t = fsys::last_write_time(path, ec);
+    if (ec) return false;
+    for (const auto& source:sources) {
+        std::time_t ts = fsys::last_write_time(source, ec);
+        if (ec || ts > t) return false;
+    }
+    return true;
+}
+
+struct SchemaLoadResult {
+    //! Null if the schema has no applicable binding
+    std::shared_ptr<ActionSchemaSDD> sdd;
+    std::size_t size = 0;
+    bool binary_bookkeeping = false;
+    double time = 0;
+    //! The messages to be logged about the schema, which is done on the main thread
+    std::string log;
+};
+
+//! Load the SDD and bookkeeping info of a single schema. Each schema has its own SDD manager,
+//! hence different schemas can be loaded concurrently.
+SchemaLoadResult load_schema_sdd(const PartiallyGroundedAction& schema, const fsys::path& dir, unsigned cache_size, unsigned minimization_time, bool write_bookkeeping) {
+    auto t0 = std::chrono::steady_clock::now();
+    SchemaLoadResult result;
+
+    // Each action schema has a number of filenames starting with the name of the schema
+    const std::string& schema_name = schema.getName();
+    fsys::path vtree_path = dir / fsys::path(str(format("%1%.vtree.sdd") % schema_name));
+    fsys::path manager_path = dir / fsys::path(str(format("%1%.manager.sdd") % schema_name));
+    fsys::path atoms_path = dir / fsys::path(str(format("%1%.atoms.data") % schema_name));
+    fsys::path bindings_path = dir / fsys::path(str(format("%1%.bindings.data") % schema_name));
+    fsys::path binary_path = dir / fsys::path(str(format("%1%.bookkeeping.bin") % schema_name));
+
+    // Load vtree and manager
+    Vtree* vtree = sdd_vtree_read(vtree_path.string().c_str());
+    SddManager* manager = sdd_manager_new(vtree);
+    SddNode* node = sdd_read(manager_path.string().c_str(), manager);
+
+    if (sdd_node_is_false(node)) {
+        sdd_vtree_free(vtree);
+        sdd_manager_free(manager);
+        return result;
+    }
 
-            bindings.push_back(std::move(param_bindings));
+    // Load bookkeeping info for the schema
+    RelevantVarsT relevant;
+    ParamBindingsT bindings;
+    std::vector<fsys::path> sources{atoms_path, bindings_path};
+    auto signature = bookkeeping_signature(sources);
+    if (is_up_to_date(binary_path, sources) && read_binary_bookkeeping(binary_path, signature, relevant, bindings)) {
+        result.binary_bookkeeping = true;
+    } else {
+        relevant.clear();
+        bindings.clear();
+        parse_atoms_file(atoms_path, relevant);
+        parse_bindings_file(bindings_path, bindings);
+        if (write_bookkeeping && !write_binary_bookkeeping(binary_path, signature, relevant, bindings)) {
+            result.log += "Could not write binary SDD bookkeeping file " + binary_path.string() + "\n";
         }
+    }
+
+    if (minimization_time > 0) {
+        std::ostringstream log;
+        ActionSchemaSDD::minimize_sdd(manager, node, minimization_time, log);
+        result.log += log.str();
+        // For debugging purposes:
+        // std::cout << "Printing SDD to " << str(format("/home/gfrances/tmp/vtrees/%1%.sdd.dot") % schema_name) << std::endl;
+        // sdd_save_as_dot(str(format("/home/gfrances/tmp/vtrees/%1%.sdd.dot") % schema_name).c_str(), node);
+        // sdd_vtree_save_as_dot(str(format("/home/gfrances/tmp/vtrees/%1%.vtree.dot") % schema_name).c_str(), sdd_manager_vtree(manager));
+    }
 
-        auto minimization_time = config.getOption<unsigned>("sdd.minimization_time", 10);
-        if (minimization_time > 0) {
-            ActionSchemaSDD::minimize_sdd(manager, node, minimization_time);
-            // For debugging purposes:
-            // std::cout << "Printing SDD to " << str(format("/home/gfrances/tmp/vtrees/%1%.sdd.dot") % schema_name) << std::endl;
-            // sdd_save_as_dot(str(format("/home/gfrances/tmp/vtrees/%1%.sdd.dot") % schema_name).c_str(), node);
-            // sdd_vtree_save_as_dot(str(format("/home/gfrances/tmp/vtrees/%1%.vtree.dot") % schema_name).c_str(), sdd_manager_vtree(manager));
+    result.size = sdd_size(node);
+    result.sdd = std::make_shared<ActionSchemaSDD>(schema, std::move(relevant), std::move(bindings), manager, vtree, node, cache_size);
+    result.time = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    return result;
+}
+
+} // anonymous namespace
+
+//! Loads from disk all SDDs in the given directory (one per action schema)
+std::vector<std::shared_ptr<ActionSchemaSDD>>
+load_sdds_from_disk(const std::vector<const PartiallyGroundedAction*>& schemas, const std::string& dir) {
+    const Config& config = Config::instance();
+    auto cache_size = config.getOption<unsigned>("sdd.cache_size", 0);
+    auto minimization_time = config.getOption<unsigned>("sdd.minimization_time", 10);
+    auto write_bookkeeping = config.getOption<bool>("sdd.write_bookkeeping", false);
+
+    fsys::path path(dir);
+    if (!fsys::exists(path)) throw std::runtime_error("Non-existing base SDD directory: " + dir);
+
+    unsigned nthreads = config.getOption<unsigned>("sdd.load_threads", 1);
+    if (nthreads == 0) nthreads = std::max(1u, std::thread::hardware_concurrency());
+    nthreads = std::max(1u, std::min<unsigned>(nthreads, schemas.size()));
+
+    LPT_INFO("cout", "Loading SDDs of " << schemas.size() << " action schemas using " << nthreads << " threads");
+    LPT_DEBUG("cout", "Mem. usage: " << get_current_memory_in_kb() << "kB. (peak: " << get_peak_memory_in_kb() << " kB.)");
+    auto t0 = std::chrono::steady_clock::now();
+
+    // Schemas are dispatched to the worker threads one at a time, as their loading times can be very different
+    std::vector<SchemaLoadResult> results(schemas.size());
+    std::vector<std::exception_ptr> errors(nthreads);
+    std::atomic<unsigned> next_schema(0);
+
+    auto worker = [&](unsigned w) {
+        try {
+            for (unsigned i = next_schema++; i < schemas.size(); i = next_schema++) {
+                results[i] = load_schema_sdd(*schemas[i], path, cache_size, minimization_time, write_bookkeeping);
+            }
+        } catch (...) {
+            errors[w] = std::current_exception();
+            next_schema = schemas.size(); // Stop the other workers as soon as possible
         }
+    };
 
-        sdds.push_back(std::make_shared<ActionSchemaSDD>(*schema, relevant, bindings, manager, vtree, node));
+    if (nthreads == 1) {
+        worker(0);
+    } else {
+        std::vector<std::thread> threads;
+        for (unsigned w = 0; w < nthreads; ++w) threads.emplace_back(worker, w);
+        for (auto& thread:threads) thread.join();
     }
 
+    for (const auto& error:errors) {
+        if (error) std::rethrow_exception(error);
+    }
+
+    std::vector<std::shared_ptr<ActionSchemaSDD>> sdds;
+    for (unsigned i = 0; i < schemas.size(); ++i) {
+        const auto& result = results[i];
+        const std::string& schema_name = schemas[i]->getName();
+
+        std::istringstream log(result.log);
+        for (std::string line; std::getline(log, line);) LPT_INFO("cout", line);
+        if (!result.sdd) {
+            std::cout << "Action " << schema_name << " has no applicable binding and will be ignored." << std::endl;
+            continue;
+        }
+
+        LPT_INFO("cout", "Loaded SDD of action schema \"" << schema_name << "\" (" << result.size << " nodes"
+                         << (result.binary_bookkeeping ? ", binary bookkeeping" : "") << ") in "
+                         << std::fixed << std::setprecision(2) << result.time << " sec.");
+        sdds.push_back(result.sdd);
+    }
 
+    double total_time = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    LPT_INFO("cout", "SDD loading time: " << std::fixed << std::setprecision(2) << total_time << " sec.");
     LPT_DEBUG("cout", "Mem. usage: " << get_current_memory_in_kb() << "kB. (peak: " << get_peak_memory_in_kb() << " kB.)");
 
     return sdds;
 }
 
-std::size_t ActionSchemaSDD::minimize_sdd(SddManager* manager, SddNode* node, unsigned time_limit) {
+std::size_t ActionSchemaSDD::minimize_sdd(SddManager* manager, SddNode* node, unsigned time_limit, std::ostream& log) {
     auto t0 = aptk::time_used();
     std::size_t sz0 = sdd_size(node);
-    LPT_INFO("cout", "Minimizing SDD with " << sz0 << " nodes for up to " << time_limit << " sec.");
+    log << "Minimizing SDD with " << sz0 << " nodes for up to " << time_limit << " sec." << std::endl;
 
     sdd_ref(node, manager);
 
@@ -154,8 +405,8 @@ std::size_t ActionSchemaSDD::minimize_sdd(SddManager* manager, SddNode* node, un
 
     double total_time = aptk::time_used() - t0;
     std::size_t sz1 = sdd_size(node);
-    LPT_INFO("cout", "SDD minimization: " << sz0 << " -> " << sz1 << " nodes (" << std::fixed << std::setprecision(2) << (sz0-sz1) * 100 / sz1
-                      << "% reduction). Actual minimization time: " << total_time << " sec.");
+    log << "SDD minimization: " << sz0 << " -> " << sz1 << " nodes (" << std::fixed << std::setprecision(2) << (sz0-sz1) * 100 / sz1
+        << "% reduction). Actual minimization time: " << total_time << " sec." << std::endl;
 
     // Minimization internally already triggers garbage collection (documented, and I've also tested it)
     sdd_deref(node, manager);
@@ -166,12 +417,14 @@ std::size_t ActionSchemaSDD::minimize_sdd(SddManager* manager, SddNode* node, un
 ActionSchemaSDD::ActionSchemaSDD(const PartiallyGroundedAction& schema,
         std::vector<std::pair<VariableIdx, unsigned>> relevant,
         std::vector<std::vector<std::pair<object_id, unsigned>>> bindings,
-        SddManager *manager, Vtree *vtree, SddNode *sddnode)
-        : schema_(schema), sddmanager_(manager), vtree_(vtree), sddnode_(sddnode), relevant_(std::move(relevant)), bindings_(std::move(bindings))
+        SddManager *manager, Vtree *vtree, SddNode *sddnode, unsigned cache_size)
+        : schema_(schema), sddmanager_(manager), vtree_(vtree), sddnode_(sddnode), relevant_(std::move(relevant)), bindings_(std::move(bindings)),
+          cache_(cache_size)
 {
 }
 
 ActionSchemaSDD::~ActionSchemaSDD() {
+    report_cache_stats();
     // Note that we cannot simply `delete` the SDD objects here, as their implementation is hidden
     sdd_vtree_free(vtree_);
     sdd_manager_free(sddmanager_); // This should free memory from all nodes
@@ -225,6 +478,12 @@ unsigned ActionSchemaSDD::var_count() const {
 
 std::vector<object_id> ActionSchemaSDD::get_binding_from_model(const SDDModel &model) {
     std::vector<object_id> values;
+    get_binding_from_model(model, values);
+    return values;
+}
+
+void ActionSchemaSDD::get_binding_from_model(const SDDModel &model, std::vector<object_id>& values) {
+    values.clear();
     values.reserve(bindings_.size());
 
     for (const auto& paramdata:bindings_) {
@@ -238,10 +497,49 @@ std::vector<object_id> ActionSchemaSDD::get_binding_from_model(const SDDModel &m
     }
 
     assert(values.size() == bindings_.size());
-    return values;
 }
 
 
+ActionSchemaSDD::ProjectionT ActionSchemaSDD::project(const State& state) const {
+    ProjectionT projection((relevant_.size() + 63) / 64, 0);
+    for (std::size_t i = 0, n = relevant_.size(); i < n; ++i) {
+        if (state.getValue(relevant_[i].first)) projection[i / 64] |= (uint64_t(1) << (i % 64));
+    }
+    return projection;
+}
+
+std::shared_ptr<const ActionSchemaSDD::BindingListT> ActionSchemaSDD::find_cached_bindings(const State& state) {
+    if (!cache_.enabled()) return nullptr;
+    const auto* cached = cache_.find(project(state));
+    return cached ? *cached : nullptr;
+}
+
+std::shared_ptr<const ActionSchemaSDD::BindingListT> ActionSchemaSDD::cache_bindings(const State& state, BindingListT&& bindings) {
+    auto shared = std::make_shared<const BindingListT>(std::move(bindings));
+    if (cache_.enabled()) cache_.insert(project(state), shared);
+    return shared;
+}
+
+std::shared_ptr<const ActionSchemaSDD::BindingListT> ActionSchemaSDD::compute_bindings(const State& state) {
+    if (auto cached = find_cached_bindings(state)) return cached;
+
+    BindingListT bindings;
+    DFSModelEnumerator enumerator;
+    enumerator.reset(manager(), node(), collect_state_literals(state));
+    while (enumerator.next()) {
+        bindings.push_back(get_binding_from_model(enumerator.model()));
+    }
+    return cache_bindings(state, std::move(bindings));
+}
+
+void ActionSchemaSDD::report_cache_stats() const {
+    unsigned long lookups = cache_.hits() + cache_.misses();
+    if (lookups == 0) return;
+    LPT_INFO("cout", "SDD bindings cache for schema \"" << schema_.getName() << "\": " << cache_.hits() << " hits / " << lookups
+                     << " lookups (" << std::fixed << std::setprecision(2) << cache_.hits() * 100.0 / lookups << "%), "
+                     << cache_.size() << " entries");
+}
+
 void ActionSchemaSDD::report_sdd_stats() const {
     printf("Live / dead sdd nodes: %zu / %zu\n", sdd_manager_live_size(sddmanager_), sdd_manager_dead_size(sddmanager_));
 }
@@ -290,168 +588,182 @@ SDDModel SDDModel::merge_disjoint_models(const SDDModel& left, const SDDModel& r
     return SDDModel(std::move(res));
 }
 
-DFSModelEnumerator::DFSModelEnumerator(SddManager* manager, SddNode* root, SDDModel&& fixed)
-        : sddmanager_(manager), root_(root), nvars_(sdd_manager_var_count(manager)), fixed_(std::move(fixed)), state_() {
-    state_.reserve(nvars_);
-    assert(fixed_.size() == nvars_ + 1); // vars are 1-indexed
-    // auto vtree = sdd_node_is_true(root) ? sdd_manager_vtree(sddmanager_) : sdd_vtree_of(root);
-    // state_.emplace_back(case_t::case0, (std::vector<SddNode*>){root}, vtree);
-}
-
-/*
-SDDModel DFSModelEnumerator::next() {
-
-    std::vector<SDDModel::value_t> values;
-
-    while (!state_.empty()) {
-        const auto& [subcase, nodes, vtree] = state_.back();
-        assert(vtree);
+DFSModelEnumerator::DFSModelEnumerator()
+        : sddmanager_(nullptr), root_(nullptr), nvars_(0), fixed_(0), model_(0), status_(status_t::Exhausted), cursors_(), element_slots_()
+{}
 
-//        auto vtree_left = sdd_vtree_left(vtree);
-//        auto vtree_right = sdd_vtree_right(vtree);
-
-        if (subcase == case_t::case0) { // Starting the ME algorithm
-            assert(nodes.size() == 1);
-            const auto& node = nodes[0];
+void DFSModelEnumerator::reset(SddManager* manager, SddNode* root, SDDModel&& fixed) {
+    sddmanager_ = manager;
+    root_ = root;
+    nvars_ = sdd_manager_var_count(manager);
+    fixed_ = std::move(fixed);
+    assert(fixed_.size() == nvars_ + 1); // vars are 1-indexed
+    model_.reset(nvars_ + 1);
 
-            if (sdd_node_is_false(node)) throw std::runtime_error("False SDD has no models");
+    // Clearing the buffers keeps their capacity for subsequent enumerations
+    cursors_.clear();
+    element_slots_.clear();
+    status_ = sdd_node_is_false(root) ? status_t::Exhausted : status_t::Fresh;
+}
 
+bool DFSModelEnumerator::next() {
+    if (status_ == status_t::Exhausted) return false;
 
-        }
+    bool found;
+    if (status_ == status_t::Fresh) {
+        auto vtree = sdd_node_is_true(root_) ? sdd_manager_vtree(sddmanager_) : sdd_vtree_of(root_);
+        found = first(make_cursor(root_, vtree));
+    } else {
+        found = next(0); // The cursor of the root node is always the first one
     }
 
-    // SDDModel(std::move(values))
-    // We reached the end of the stack, all models have been explored, return the empty model to signal so
-    return SDDModel(0);
+    status_ = found ? status_t::Active : status_t::Exhausted;
+    return found;
 }
-*/
-
-/*
-SDDModel DFSModelEnumerator::next() {
-    if (sdd_node_is_false(root_)) throw std::runtime_error("False SDD has no models");
-    auto vtree = sdd_node_is_true(root_) ? sdd_manager_vtree(sddmanager_) : sdd_vtree_of(root_);
 
-    std::vector<SDDModel::value_t> values;
-    next_(root_, vtree, values);
-    return SDDModel(std::move(values));
+bool DFSModelEnumerator::node_is_false_in_fixed(SddNode* node) const {
+    if (!sdd_node_is_literal(node)) return false;
+    const auto var = varid(sdd_node_literal(node));
+    return fixed_[var] != SDDModel::value_t::Undefined && fixed_[var] != truth_value(node);
 }
 
+unsigned DFSModelEnumerator::make_cursor(SddNode* node, Vtree* vtree) {
+    // Note that building the children cursors might reallocate the cursor buffer, hence we refer to cursors by index
+    unsigned idx = cursors_.size();
+    cursors_.push_back({cursor_t::kind_t::Leaf, node, vtree, 0, 0, 0});
 
+    if (sdd_vtree_is_leaf(vtree)) {
+        cursors_[idx].left = sdd_vtree_var(vtree);
+        assert (cursors_[idx].left > 0 && cursors_[idx].left <= nvars_);  // Variables in the SDD library range from 1 to numvars
+        return idx;
+    }
 
-void DFSModelEnumerator::next_(SddNode* node, Vtree* vtree, std::vector<SDDModel::value_t>& current) {
     auto vtree_left = sdd_vtree_left(vtree);
     auto vtree_right = sdd_vtree_right(vtree);
 
-    if (sdd_vtree_is_leaf(vtree)) {
-        unsigned var = sdd_vtree_var(vtree);
-        assert (var > 0 && var <= nvars_);  // Variables in the SDD library range from 1 to numvars
-
-        if (sdd_node_is_true(node)) {
-            const auto& fixed_val = fixed_[var];
-            if (fixed_val != SDDModel::value_t::Undefined) {
-                return {register_model(var, fixed_val)};
-
-            } else {
-                return {register_model(var, SDDModel::value_t::True),
-                        register_model(var, SDDModel::value_t::False)};
-            }
+    if (sdd_node_is_true(node)) {
+        make_product(idx, node, node, vtree_left, vtree_right);
 
-        } else if (sdd_node_is_literal(node)) {
-            const auto& fixed_val = fixed_[var];
-            if (fixed_val != SDDModel::value_t::Undefined) {
-                return {register_model(var, fixed_val)};
+    } else if (sdd_vtree_of(node) == vtree) {
+        assert(sdd_node_is_decision(node)); // Required by the documentation of `sdd_node_elements`
+        // The cursors of the (prime, sub) elements are created only once the enumeration reaches them
+        cursors_[idx].kind = cursor_t::kind_t::Decision;
+        cursors_[idx].left = element_slots_.size();
+        element_slots_.resize(element_slots_.size() + sdd_node_size(node), NO_CURSOR);
 
-            } else {
-                SDDModel::value_t value = truth_value(node);
-                //            assert(fixed[var] == SDDModel::value_t::Undefined || fixed[var] == value); // Just in case
-                return {register_model(var, value)};
-            }
+    } else {  // fill in gap in vtree
+        auto truenode = sdd_manager_true(sddmanager_);
+        if (sdd_vtree_is_sub(sdd_vtree_of(node), vtree_left)) {
+            make_product(idx, node, truenode, vtree_left, vtree_right);
+        } else {
+            make_product(idx, truenode, node, vtree_left, vtree_right);
         }
+    }
+    return idx;
+}
 
-    } else {
-        if (sdd_node_is_true(node)) {
-            return model_cross_product(node, node, vtree_left, vtree_right);
-
-        } else if (sdd_vtree_of(node) == vtree) {
-            next_or_node(node, vtree)
-
-
-            assert(sdd_node_is_decision(node)); // Required by the documentation of `sdd_node_elements`
+void DFSModelEnumerator::make_product(unsigned idx, SddNode* leftnode, SddNode* rightnode, Vtree* leftvt, Vtree* rightvt) {
+    unsigned left = make_cursor(leftnode, leftvt);
+    unsigned right = make_cursor(rightnode, rightvt);
+    auto& cursor = cursors_[idx];
+    cursor.kind = cursor_t::kind_t::Product;
+    cursor.left = left;
+    cursor.right = right;
+}
 
-            // nodes is a C-style array of nodes containing (flat) pairs of (prime, sub), as described in the docs
-            SddNode** nodes = sdd_node_elements(node);
+bool DFSModelEnumerator::first(unsigned idx) {
+    auto& cursor = cursors_[idx];
+    cursor.pos = 0;
 
-            auto nsize = 2*sdd_node_size(node);
-            for (unsigned i=0; i < nsize; i += 2) {
-                SddNode* prime = nodes[i];
-                SddNode* sub = nodes[i+1];
+    switch (cursor.kind) {
+        case cursor_t::kind_t::Leaf:
+            return assign_leaf(idx);
 
-                if (sdd_node_is_false(sub)) continue;
+        case cursor_t::kind_t::Product: {
+            // The variables of both sides are disjoint, hence if the right side has no model, neither has the product
+            unsigned right = cursor.right;
+            return first(cursor.left) && first(right);
+        }
 
-                if (node_is_false_in_fixed(sub) || node_is_false_in_fixed(prime)) continue;
+        case cursor_t::kind_t::Decision:
+            return first_element_from(idx);
+    }
+    return false;
+}
 
-                // For debugging purposes:
-//                if (sdd_node_is_literal(prime) && sdd_node_literal(prime) == -7 &&
-//                    sdd_node_is_literal(sub) && sdd_node_literal(sub) == -8) {
-//                    std::cout << "Breakpoint" << std::endl;
-//                }
+bool DFSModelEnumerator::next(unsigned idx) {
+    auto& cursor = cursors_[idx];
 
+    switch (cursor.kind) {
+        case cursor_t::kind_t::Leaf:
+            ++cursor.pos;
+            return assign_leaf(idx);
 
-                model_cross_product(prime, sub, vtree_left, vtree_right, result);
-            }
+        case cursor_t::kind_t::Product: {
+            unsigned left = cursor.left, right = cursor.right;
+            if (next(right)) return true;
+            return next(left) && first(right);
+        }
 
-            return result;
+        case cursor_t::kind_t::Decision: {
+            if (next(element_slots_[cursor.left + cursor.pos])) return true;
+            ++cursors_[idx].pos;
+            return first_element_from(idx);
+        }
+    }
+    return false;
+}
 
+bool DFSModelEnumerator::assign_leaf(unsigned idx) {
+    const auto& cursor = cursors_[idx];
+    unsigned var = cursor.left;
+    const auto& fixed_val = fixed_[var];
 
-        } else {  // fill in gap in vtree
-            auto truenode = sdd_manager_true(sddmanager_);
+    SDDModel::value_t value = SDDModel::value_t::Undefined;
+    if (sdd_node_is_true(cursor.node)) {
+        if (fixed_val != SDDModel::value_t::Undefined) value = (cursor.pos == 0) ? fixed_val : SDDModel::value_t::Undefined;
+        else if (cursor.pos == 0) value = SDDModel::value_t::True;
+        else if (cursor.pos == 1) value = SDDModel::value_t::False;
 
-            // if Vtree.is_sub(node.vtree(), vtree.left()): [Python]
-            if (sdd_vtree_is_sub(sdd_vtree_of(node), vtree_left)) {
-                return model_cross_product(node, truenode, vtree_left, vtree_right);
-            } else {
-                return model_cross_product(truenode, node, vtree_left, vtree_right);
-            }
-        }
+    } else if (sdd_node_is_literal(cursor.node) && cursor.pos == 0) {
+        value = truth_value(cursor.node);
+        if (fixed_val != SDDModel::value_t::Undefined && fixed_val != value) value = SDDModel::value_t::Undefined;
     }
 
-    return {};
+    if (value == SDDModel::value_t::Undefined) return false;
+    model_[var] = value;
+    return true;
 }
 
-void DFSModelEnumerator::next_or_node(SddNode* node, Vtree* vtree,
-        unsigned i,
-        std::vector<SDDModel::value_t>& current) {
-
-    assert(sdd_node_is_decision(node)); // Required by the documentation of `sdd_node_elements`
+bool DFSModelEnumerator::first_element_from(unsigned idx) {
+    SddNode* node = cursors_[idx].node;
+    Vtree* vtree = cursors_[idx].vtree;
 
-    // nodes is a C-style array of nodes containing (flat) pairs of (prime, sub), as described in the docs
-    SddNode** nodes = sdd_node_elements(node);
+    // elements is a C-style array of nodes containing (flat) pairs of (prime, sub), as described in the docs
+    SddNode** elements = sdd_node_elements(node);
+    unsigned nelements = sdd_node_size(node);
 
-    auto nsize = 2*sdd_node_size(node);
-    for (unsigned i=0; i < nsize; i += 2) {
-        SddNode* prime = nodes[i];
-        SddNode* sub = nodes[i+1];
+    for (unsigned i = cursors_[idx].pos; i < nelements; ++i) {
+        cursors_[idx].pos = i;
+        SddNode* prime = elements[2*i];
+        SddNode* sub = elements[2*i+1];
 
         if (sdd_node_is_false(sub)) continue;
-
         if (node_is_false_in_fixed(sub) || node_is_false_in_fixed(prime)) continue;
 
-        // For debugging purposes:
-//                if (sdd_node_is_literal(prime) && sdd_node_literal(prime) == -7 &&
-//                    sdd_node_is_literal(sub) && sdd_node_literal(sub) == -8) {
-//                    std::cout << "Breakpoint" << std::endl;
-//                }
-
+        unsigned slot = cursors_[idx].left + i;
+        if (element_slots_[slot] == NO_CURSOR) {
+            unsigned element = cursors_.size();
+            cursors_.push_back({cursor_t::kind_t::Product, nullptr, nullptr, 0, 0, 0});
+            make_product(element, prime, sub, sdd_vtree_left(vtree), sdd_vtree_right(vtree));
+            element_slots_[slot] = element;
+        }
 
-        model_cross_product(prime, sub, vtree_left, vtree_right, result);
+        if (first(element_slots_[slot])) return true;
     }
-
-    return result;
-
+    return false;
 }
 
-*/
-
 const RecursiveModelEnumerator::resultset_t&
 RecursiveModelEnumerator::models_with_cache(SddNode* node, Vtree* vtree) {
     computed_nodes_++;
@@ -1,11 +1,16 @@
 
 #pragma once
 
+#include <limits>
+#include <memory>
+#include <ostream>
 #include <string>
 #include <unordered_map>
+#include <boost/functional/hash.hpp>
 #include <boost/serialization/vector.hpp>
 
 #include <fs/core/fs_types.hxx>
+#include <fs/core/utils/lru_cache.hxx>
 
 // Forward-declare the basic SddNode, Vtree and SDDManager typedefs from the SDD API
 struct sdd_node_t; typedef struct sdd_node_t SddNode;
@@ -41,6 +46,9 @@ public:
     inline value_t& operator[] (std::size_t i) { assert(i < values_.size()); return values_[i]; }
     inline std::size_t size() const { return values_.size(); }
 
+    //! Set all values of the model to undefined, reusing its storage
+    void reset(unsigned nvars) { values_.assign(nvars, value_t::Undefined); }
+
     static SDDModel merge_disjoint_models(const SDDModel& left, const SDDModel& right);
 
 protected:
@@ -49,10 +57,14 @@ protected:
 
 class ActionSchemaSDD {
 public:
+    //! A list of bindings of the schema parameters
+    using BindingListT = std::vector<std::vector<object_id>>;
+
     ActionSchemaSDD(const PartiallyGroundedAction& schema,
             std::vector<std::pair<VariableIdx, unsigned>> relevant,
             std::vector<std::vector<std::pair<object_id, unsigned>>> bindings,
-            SddManager* manager, Vtree* vtree, SddNode* sddnode);
+            SddManager* manager, Vtree* vtree, SddNode* sddnode,
+            unsigned cache_size = 0);
     ~ActionSchemaSDD();
 
     SddNode* conjoin_with(const State& state) const;
@@ -66,13 +78,40 @@ public:
 
     const PartiallyGroundedAction& get_schema() const { return schema_; }
 
+    const std::vector<std::pair<VariableIdx, unsigned>>& get_relevant_atoms() const { return relevant_; }
+
+    const std::vector<std::vector<std::pair<object_id, unsigned>>>& get_parameter_bindings() const { return bindings_; }
+
     std::vector<object_id> get_binding_from_model(const SDDModel& model);
 
+    //! Same as above, but writing the binding into 'values', whose storage is reused
+    void get_binding_from_model(const SDDModel& model, std::vector<object_id>& values);
+
+    //! The bindings of the applicable groundings of the schema in a state depend only on the values of the relevant
+    //! variables of the schema. They are thus cached, indexed by the projection of the state on these variables, so that
+    //! the SDD models need to be enumerated only once per projection.
+    //! Return the cached bindings for the given state, or null if there are none.
+    std::shared_ptr<const BindingListT> find_cached_bindings(const State& state);
+
+    //! Cache the bindings of all (and only) the applicable groundings of the schema in the given state.
+    //! Return them, whether caching is enabled or not.
+    std::shared_ptr<const BindingListT> cache_bindings(const State& state, BindingListT&& bindings);
+
+    //! Compute the bindings of all applicable groundings of the schema in the given state, using the cache if possible
+    std::shared_ptr<const BindingListT> compute_bindings(const State& state);
+
+    bool caches_bindings() const { return cache_.enabled(); }
+
     void report_sdd_stats() const;
 
+    //! Report the hit rate of the cache of applicable bindings
+    void report_cache_stats() const;
+
     void collect_sdd_garbage(SddNode* node = nullptr) const;
 
-    static size_t minimize_sdd(SddManager* manager, SddNode* node, unsigned int time_limit);
+    //! Minimize the given SDD for up to the given time. Progress is reported on the given stream rather than
+    //! through the (not thread-safe) logger, since SDDs of different schemas are minimized on different threads.
+    static size_t minimize_sdd(SddManager* manager, SddNode* node, unsigned int time_limit, std::ostream& log);
 
 
 protected:
@@ -93,6 +132,17 @@ protected:
 
     //! 'bindings_[i]' contains the object_id corresponding
     std::vector<std::vector<std::pair<object_id, unsigned>>> bindings_;
+
+    //! The projection of a state over the relevant variables, one bit per variable
+    using ProjectionT = std::vector<uint64_t>;
+    struct ProjectionHasher {
+        std::size_t operator()(const ProjectionT& projection) const { return boost::hash_range(projection.begin(), projection.end()); }
+    };
+
+    ProjectionT project(const State& state) const;
+
+    //! The applicable bindings computed for the most recently seen state projections
+    LRUCache<ProjectionT, std::shared_ptr<const BindingListT>, ProjectionHasher> cache_;
 };
 
 
@@ -136,34 +186,69 @@ protected:
     bool node_is_false_in_fixed(SddNode* node);
 };
 
+//! A lazy, depth-first enumerator of the models of an SDD node that are compatible with a set of fixed values.
+//! Unlike the RecursiveModelEnumerator, models are produced one at a time, so that the enumeration can be stopped
+//! early without paying for the remaining models. The enumeration is driven by a tree of cursors, one per SDD node
+//! and vtree pair that the DFS reaches, which is kept in buffers that are reused across subsequent enumerations.
 class DFSModelEnumerator {
 public:
-    DFSModelEnumerator(SddManager* manager, SddNode* root, SDDModel&& fixed);
+    DFSModelEnumerator();
+
+    //! Start the enumeration of the models of the given node, discarding any ongoing enumeration
+    void reset(SddManager* manager, SddNode* root, SDDModel&& fixed);
 
-    std::vector<SDDModel> models(SddNode* node, Vtree* vtree=nullptr);
+    //! Advance to the next model, returning false if all models have already been enumerated
+    bool next();
 
-    SDDModel next();
+    //! The current model; only valid after a call to next() that returned true
+    const SDDModel& model() const { return model_; }
 
     unsigned nvars() const { return nvars_; }
 
 protected:
+    //! A cursor over the models of an SDD node, normalized for a given vtree. Leaf cursors range over the values of
+    //! a single variable (given by 'left'); product cursors over the cross product of the models of two children
+    //! cursors 'left' and 'right'; and decision cursors over the disjoint models of the node elements, whose cursors
+    //! are stored in 'element_slots_' starting at position 'left'.
+    struct cursor_t {
+        enum class kind_t : uint8_t {Leaf, Product, Decision};
+        kind_t kind;
+        SddNode* node;
+        Vtree* vtree;
+        unsigned left;
+        unsigned right;
+        //! The value (leaf cursors) or element (decision cursors) currently being enumerated
+        unsigned pos;
+    };
+
+    enum class status_t : uint8_t {Fresh, Active, Exhausted};
+
+    static constexpr unsigned NO_CURSOR = std::numeric_limits<unsigned>::max();
+
     SddManager* sddmanager_;
     SddNode* root_;
     unsigned nvars_;
-    const SDDModel fixed_;
+    SDDModel fixed_;
 
-    bool node_is_false_in_fixed(SddNode* node);
+    //! The model being built, which each cursor updates with the values of the variables in its vtree
+    SDDModel model_;
 
-    void next_(SddNode* node, Vtree* vtree, std::vector<SDDModel::value_t>& current);
+    status_t status_;
 
+    std::vector<cursor_t> cursors_;
+    std::vector<unsigned> element_slots_;
 
-    enum class case_t {
-        case0
-    };
+    bool node_is_false_in_fixed(SddNode* node) const;
+
+    unsigned make_cursor(SddNode* node, Vtree* vtree);
+    void make_product(unsigned idx, SddNode* leftnode, SddNode* rightnode, Vtree* leftvt, Vtree* rightvt);
+
+    //! Move the given cursor to its first (resp. next) model, returning false if there is none
+    bool first(unsigned idx);
+    bool next(unsigned idx);
 
-    using decision_t = std::tuple<case_t, std::vector<SddNode*>, Vtree*>;
-    using state_t = std::vector<decision_t>;
-    state_t state_;
+    bool assign_leaf(unsigned idx);
+    bool first_element_from(unsigned idx);
 };
 
 
@@ -0,0 +1,44 @@
+
+#pragma once
+
+#include <bitset>
+#include <unordered_map>
+
+namespace fs0 {
+
+//! A bitset over a potentially huge index space, of which only a small fraction of bits is ever set.
+//! Bits are stored in blocks of BlockBits contiguous bits, each of which is allocated only when
+//! one of its bits is first set, so that untouched regions of the index space take no memory.
+template <std::size_t BlockBits = 256>
+class SparseBitset {
+public:
+	using BlockT = std::bitset<BlockBits>;
+
+	bool test(std::size_t i) const {
+		auto it = _blocks.find(i / BlockBits);
+		return it != _blocks.end() && it->second.test(i % BlockBits);
+	}
+
+	//! Set the i-th bit, and return true iff it was previously unset
+	bool test_and_set(std::size_t i) {
+		auto ref = _blocks[i / BlockBits][i % BlockBits];
+		if (ref) return false;
+		ref = true;
+		return true;
+	}
+
+	void clear() { _blocks.clear(); }
+
+	std::size_t num_blocks() const { return _blocks.size(); }
+
+	//! An estimate of the memory used by the bitset, in bytes
+	std::size_t bytes() const {
+		// Each entry of the map is (roughly) a heap-allocated node with the key, the block and the next-node pointer
+		return _blocks.size() * (sizeof(std::size_t) + sizeof(BlockT) + sizeof(void*)) + _blocks.bucket_count() * sizeof(void*);
+	}
+
+protected:
+	std::unordered_map<std::size_t, BlockT> _blocks;
+};
+
+} // namespaces
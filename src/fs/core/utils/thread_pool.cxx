@@ -0,0 +1,84 @@
+
+#include <algorithm>
+
+#include <fs/core/utils/thread_pool.hxx>
+
+namespace fs0 {
+
+ThreadPool::ThreadPool(unsigned num_threads) :
+	_workers(), _mutex(), _wakeup(), _done(), _stop(false),
+	_batch(0), _task(nullptr), _num_tasks(0), _next(0), _busy(0), _error()
+{
+	if (num_threads == 0) num_threads = std::max(1u, std::thread::hardware_concurrency());
+	for (unsigned i = 1; i < num_threads; ++i) {
+		_workers.emplace_back([this]() { work(); });
+	}
+}
+
+ThreadPool::~ThreadPool() {
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_stop = true;
+	}
+	_wakeup.notify_all();
+	for (auto& worker:_workers) worker.join();
+}
+
+void ThreadPool::parallel_for(unsigned n, const std::function<void (unsigned)>& task) {
+	if (_workers.empty() || n <= 1) {
+		for (unsigned i = 0; i < n; ++i) task(i);
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_task = &task;
+		_num_tasks = n;
+		_next = 0;
+		_error = nullptr;
+		_busy = _workers.size();
+		++_batch;
+	}
+	_wakeup.notify_all();
+
+	run_tasks();
+
+	std::exception_ptr error;
+	{
+		std::unique_lock<std::mutex> lock(_mutex);
+		_done.wait(lock, [this]() { return _busy == 0; });
+		_task = nullptr;
+		error = _error;
+	}
+	if (error) std::rethrow_exception(error);
+}
+
+void ThreadPool::work() {
+	unsigned long seen = 0;
+	while (true) {
+		{
+			std::unique_lock<std::mutex> lock(_mutex);
+			_wakeup.wait(lock, [this, seen]() { return _stop || _batch != seen; });
+			if (_stop) return;
+			seen = _batch;
+		}
+
+		run_tasks();
+
+		std::lock_guard<std::mutex> lock(_mutex);
+		if (--_busy == 0) _done.notify_all();
+	}
+}
+
+void ThreadPool::run_tasks() {
+	for (unsigned i = _next++; i < _num_tasks; i = _next++) {
+		try {
+			(*_task)(i);
+		} catch (...) {
+			std::lock_guard<std::mutex> lock(_mutex);
+			if (!_error) _error = std::current_exception();
+		}
+	}
+}
+
+} // namespaces
@@ -0,0 +1,61 @@
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace fs0 {
+
+//! A fixed-size pool of worker threads to run batches of independent tasks, blocking until the whole batch is done.
+//! The calling thread takes part in the execution of the batch, hence a pool of size n spawns n-1 workers.
+class ThreadPool {
+public:
+	//! A pool of size 0 uses one thread per available core
+	explicit ThreadPool(unsigned num_threads);
+	~ThreadPool();
+
+	ThreadPool(const ThreadPool&) = delete;
+	ThreadPool(ThreadPool&&) = delete;
+	ThreadPool& operator=(const ThreadPool&) = delete;
+	ThreadPool& operator=(ThreadPool&&) = delete;
+
+	//! The total number of threads that run the tasks, including the calling one
+	unsigned size() const { return _workers.size() + 1; }
+
+	//! Run task(i) for every i in [0, n) and return once all of them are over. Tasks can run in any order.
+	//! The first exception thrown by any task, if any, is rethrown here once the batch is over.
+	//! Tasks must not mutate any object shared with other tasks. In particular, they can read the same state,
+	//! and interpret formulas over it, only because the lazily-computed parts of it and of the formulas
+	//! (derived atoms, quantifier plans) are computed under a lock; any other cache must be private to a task.
+	void parallel_for(unsigned n, const std::function<void (unsigned)>& task);
+
+protected:
+	std::vector<std::thread> _workers;
+
+	std::mutex _mutex;
+	std::condition_variable _wakeup;
+	std::condition_variable _done;
+	bool _stop;
+
+	//! The current batch, identified by a counter so that workers can tell a new batch from a spurious wakeup
+	unsigned long _batch;
+	const std::function<void (unsigned)>* _task;
+	unsigned _num_tasks;
+	std::atomic<unsigned> _next;
+
+	//! The number of workers that have not yet finished with the current batch
+	unsigned _busy;
+	std::exception_ptr _error;
+
+	void work();
+
+	//! Run tasks of the current batch until there are none left
+	void run_tasks();
+};
+
+} // namespaces
@@ -0,0 +1,77 @@
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <vector>
+
+#include <fs/core/constraints/gecode/handlers/monotonicity_csp.hxx>
+#include <fs/core/constraints/native/monotonicity_propagator.hxx>
+#include <fs/core/languages/fstrips/language.hxx>
+
+#include "fixtures/problem_fixture.hxx"
+
+using namespace fs0;
+using namespace fs0::gecode;
+using namespace fs0::test;
+
+
+//! Gives access to the native and Gecode propagation of a monotonicity CSP
+class MonotonicityCSPProbe : public MonotonicityCSP {
+public:
+	using MonotonicityCSP::MonotonicityCSP;
+	using MonotonicityCSP::check_transitions;
+	using MonotonicityCSP::compute_base_domains;
+	using MonotonicityCSP::post_monotonicity_csp_from_domains;
+
+	const MonotonicityPropagator* propagator() const { return _propagator.get(); }
+	const TransitionGraph& monotonicity() const { return _monotonicity; }
+};
+
+
+class MonotonicityPropagatorTest : public ProblemFixture {};
+
+TEST_F(MonotonicityPropagatorTest, NativePropagationMatchesGecode) {
+	const auto& transitions = problem()->get_transition_graphs();
+	if (transitions.empty()) GTEST_SKIP() << "The problem has no monotonic variable";
+
+	// Approximate CSP, i.e. Gecode only propagates the constraints, as the native propagator does
+	MonotonicityCSPProbe csp(problem()->getGoalConditions()->clone(), problem()->get_tuple_index(), transitions, false);
+	if (!csp.propagator()) GTEST_SKIP() << "The goal cannot be propagated natively";
+
+	// The domains of the parent of each sampled transition, as generated along the random walks
+	std::vector<DomainTracker> domains;
+	DomainTracker root = csp.create_root(problem()->getInitialState());
+	ASSERT_FALSE(root.is_null());
+
+	unsigned pruned = 0;
+	for (const auto& t:ProblemFixture::transitions()) {
+		const DomainTracker& parent = (t.parent_transition < 0) ? root : domains[t.parent_transition];
+		if (parent.is_null() || !csp.check_transitions(t.parent, t.changeset)) {
+			domains.emplace_back();
+			continue;
+		}
+
+		DomainTracker base = csp.compute_base_domains(parent, t.changeset);
+		DomainTracker native(base);
+		bool consistent = !base.is_null() && csp.propagator()->propagate(native);
+		DomainTracker gecode = csp.post_monotonicity_csp_from_domains(t.child, base, false);
+
+		// Native propagation achieves arc consistency, hence it detects the same inconsistencies as Gecode,
+		// and prunes at least as many values
+		ASSERT_EQ(consistent, !gecode.is_null()) << "In state " << t.child;
+		if (consistent) {
+			for (VariableIdx var:csp.monotonicity().monotonic_variables()) {
+				ASSERT_TRUE(native.domain(var).is_subset_of(gecode.domain(var))) << "Variable " << var << " in state " << t.child;
+				ASSERT_TRUE(native.domain(var).is_subset_of(base.domain(var))) << "Variable " << var << " in state " << t.child;
+			}
+		} else {
+			++pruned;
+		}
+
+		// The node generated by the CSP is the natively propagated one
+		DomainTracker generated = csp.generate_node(t.parent, parent, t.child, t.changeset);
+		ASSERT_EQ(generated.is_null(), !consistent);
+		domains.push_back(consistent ? native : DomainTracker());
+	}
+	RecordProperty("pruned", pruned);
+}
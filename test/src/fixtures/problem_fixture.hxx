@@ -0,0 +1,142 @@
+
+#pragma once
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <filesystem>
+#include <memory>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <lapkt/tools/logging.hxx>
+
+#include <fs/core/atom.hxx>
+#include <fs/core/problem.hxx>
+#include <fs/core/problem_info.hxx>
+#include <fs/core/state.hxx>
+#include <fs/core/actions/actions.hxx>
+#include <fs/core/actions/action_id.hxx>
+#include <fs/core/constraints/registry.hxx>
+#include <fs/core/fstrips/loader.hxx>
+#include <fs/core/search/drivers/setups.hxx>
+#include <fs/core/utils/component_factory.hxx>
+#include <fs/core/utils/config.hxx>
+#include <fs/core/utils/loader.hxx>
+
+namespace fs0 { namespace test {
+
+//! A fixture for the tests that need an actual planning problem. The problem is loaded once per run from the
+//! directory given by the environment variable FS_TEST_DATA, which must contain the 'problem.json' generated by
+//! the frontend for a problem without externally-defined symbols, or else from the small instance in 'data/corridor',
+//! which has monotonic variables, axioms and quantified formulae. The planner options are read from the file given
+//! by FS_TEST_DEFAULTS, or from the defaults of the generic planner. Tests are meant to be run from the 'test' directory.
+//! The tests compare the different ways of computing the same thing (e.g. lifted and ground successor generation,
+//! or incremental and from-scratch heuristic evaluation) over states sampled from random walks on the problem.
+class ProblemFixture : public testing::Test {
+public:
+	//! A transition sampled from the problem. 'parent_transition' is the index of the transition that generated
+	//! the parent state in the vector of sampled transitions, or -1 if the parent is the initial state.
+	struct Transition {
+		State parent;
+		State child;
+		std::vector<Atom> changeset;
+		int parent_transition;
+	};
+
+	//! An action identified by the ID of its schema and its full binding, which is the same for the lifted and
+	//! for the ground representation of the action
+	using ActionKey = std::pair<unsigned, std::vector<object_id>>;
+
+	//! The problem under test
+	static Problem* problem() {
+		static Problem* problem = load();
+		return problem;
+	}
+
+	//! A model with all ground actions of the problem, which are set as the ground actions of the problem
+	static GroundStateModel& ground_model() {
+		static GroundStateModel model = drivers::GroundingSetup::fully_ground_model(*problem());
+		return model;
+	}
+
+	//! The transitions of a number of random walks from the initial state, always the same ones
+	static const std::vector<Transition>& transitions() {
+		static std::vector<Transition> sampled = sample(20, 50);
+		return sampled;
+	}
+
+	//! The distinct states among those sampled, starting with the initial state
+	static std::vector<State> sampled_states(unsigned max_states) {
+		std::vector<State> states{problem()->getInitialState()};
+		for (const auto& t:transitions()) {
+			if (states.size() >= max_states) break;
+			if (std::find(states.begin(), states.end(), t.child) == states.end()) states.push_back(t.child);
+		}
+		return states;
+	}
+
+	static ActionKey key(const LiftedActionID& action) {
+		const auto& binding = action.get_binding();
+		return {action.getActionData().getId(), std::vector<object_id>(binding.begin(), binding.end())};
+	}
+
+	static ActionKey key(const GroundAction& action) {
+		return {action.getOriginId(), action.getBinding().get_full_binding()};
+	}
+
+	//! A new copy of the given state, which shares no cached data (e.g. derived atoms) with it
+	static State* fresh_copy(const State& state) {
+		std::vector<Atom> atoms;
+		for (VariableIdx var = 0; var < state.numAtoms(); ++var) atoms.emplace_back(var, state.getValue(var));
+		return State::create(problem()->getStateAtomIndexer(), state.numAtoms(), atoms);
+	}
+
+protected:
+	static Problem* load() {
+		const char* data = std::getenv("FS_TEST_DATA");
+		const std::string data_dir = data ? data : "data/corridor";
+
+		const char* defaults = std::getenv("FS_TEST_DEFAULTS");
+		std::string log_dir = (std::filesystem::temp_directory_path() / "fs-tests").string();
+		std::filesystem::create_directories(log_dir + "/logs");
+		lapkt::tools::Logger::init(log_dir + "/logs");
+		Config::init("test", {}, defaults ? defaults : "../planners/generic/defaults.json");
+
+		auto json = Loader::loadJSONObject(data_dir + "/problem.json");
+		LogicalComponentRegistry::set_instance(std::make_unique<LogicalComponentRegistry>());
+		BaseComponentFactory factory;
+		fstrips::LanguageJsonLoader::loadLanguageInfo(json);
+		Loader::loadProblemInfo(json, data_dir, factory);
+		return Loader::loadProblem(json);
+	}
+
+	//! Sample the given number of random walks of (at most) the given length, through the ground model
+	static std::vector<Transition> sample(unsigned num_walks, unsigned length) {
+		const GroundStateModel& model = ground_model();
+		std::vector<Transition> sampled;
+		std::mt19937 rng(1);
+
+		for (unsigned walk = 0; walk < num_walks; ++walk) {
+			auto state = std::make_unique<State>(model.init());
+			int parent_transition = -1;
+			for (unsigned step = 0; step < length; ++step) {
+				std::vector<unsigned> applicable;
+				for (auto action:model.applicable_actions(*state)) applicable.push_back(action);
+				if (applicable.empty()) break;
+
+				unsigned action = applicable[std::uniform_int_distribution<std::size_t>(0, applicable.size() - 1)(rng)];
+				auto child = std::make_unique<State>(model.next(*state, action));
+				sampled.push_back(Transition{*state, *child, model.get_last_changeset(), parent_transition});
+				parent_transition = sampled.size() - 1;
+				state = std::move(child);
+			}
+		}
+		return sampled;
+	}
+};
+
+} } // namespaces
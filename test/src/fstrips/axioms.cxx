@@ -0,0 +1,85 @@
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <vector>
+
+#include <fs/core/derived_atoms.hxx>
+#include <fs/core/languages/fstrips/language.hxx>
+#include <fs/core/languages/fstrips/axioms.hxx>
+#include <fs/core/utils/binding.hxx>
+#include <fs/core/utils/cartesian_iterator.hxx>
+
+#include "fixtures/problem_fixture.hxx"
+
+using namespace fs0;
+using namespace fs0::test;
+
+
+class AxiomEvaluatorTest : public ProblemFixture {
+protected:
+	//! The axioms of the problem, together with (at most) the given number of their ground atoms
+	static std::vector<std::pair<const fs::Axiom*, std::vector<std::vector<object_id>>>> ground_axioms(unsigned max_atoms) {
+		const ProblemInfo& info = ProblemInfo::getInstance();
+		std::vector<std::pair<const fs::Axiom*, std::vector<std::vector<object_id>>>> result;
+		for (const auto& symbol:info.getSymbolNames()) {
+			const fs::Axiom* axiom = problem()->getAxiom(symbol);
+			if (!axiom) continue;
+
+			std::vector<const std::vector<object_id>*> domains;
+			for (TypeIdx type:axiom->getSignature()) domains.push_back(&info.getTypeObjects(type));
+
+			// Nullary axioms have a single ground atom, whereas the cartesian product of no domains is empty
+			std::vector<std::vector<object_id>> atoms;
+			if (domains.empty()) atoms.emplace_back();
+			for (utils::cartesian_iterator it(std::move(domains)); !it.ended() && atoms.size() < max_atoms; ++it) atoms.push_back(*it);
+			result.emplace_back(axiom, std::move(atoms));
+		}
+		return result;
+	}
+
+	//! Check that the derived atoms in the given state are a fixpoint of the axiom definitions. The definitions
+	//! refer to the axioms only through the evaluator, hence this holds for both recursive and non-recursive axioms.
+	static void check_definitions(const State& state, const fs::Axiom& axiom, const std::vector<std::vector<object_id>>& atoms) {
+		const AxiomEvaluator& evaluator = problem()->get_axiom_evaluator();
+		Binding binding;
+		for (const auto& arguments:atoms) {
+			axiom.getBindingUnit().update_binding(binding, arguments);
+			ASSERT_EQ(evaluator.value(state, axiom, arguments), axiom.getDefinition()->interpret(state, binding))
+				<< "Atom of axiom " << axiom.getName() << " in state " << state;
+		}
+	}
+};
+
+TEST_F(AxiomEvaluatorTest, StratifiedValuesMatchDefinitions) {
+	auto axioms = ground_axioms(500);
+	if (axioms.empty()) GTEST_SKIP() << "The problem has no axiom";
+
+	for (const State& state:sampled_states(100)) {
+		for (const auto& axiom:axioms) check_definitions(state, *axiom.first, axiom.second);
+	}
+}
+
+TEST_F(AxiomEvaluatorTest, SuccessorTablesMatchFromScratch) {
+	auto axioms = ground_axioms(500);
+	if (axioms.empty()) GTEST_SKIP() << "The problem has no axiom";
+	const AxiomEvaluator& evaluator = problem()->get_axiom_evaluator();
+
+	// The derived atoms of a state generated from its parent reuse the strata not affected by the changes, and
+	// have to match those of a copy of the state that is evaluated from scratch
+	for (const auto& t:transitions()) {
+		State parent(t.parent);
+		for (const auto& axiom:axioms) {
+			for (const auto& arguments:axiom.second) evaluator.value(parent, *axiom.first, arguments);
+		}
+
+		State child(parent, t.changeset);
+		std::unique_ptr<State> fresh(fresh_copy(child));
+		for (const auto& axiom:axioms) {
+			for (const auto& arguments:axiom.second) {
+				ASSERT_EQ(evaluator.value(child, *axiom.first, arguments), evaluator.value(*fresh, *axiom.first, arguments))
+					<< "Atom of axiom " << axiom.first->getName() << " in state " << child;
+			}
+		}
+	}
+}
@@ -2,8 +2,8 @@
 
 #include <gtest/gtest.h>
 
-#include <languages/fstrips/language.hxx>
-#include <languages/fstrips/operations.hxx>
+#include <fs/core/languages/fstrips/language.hxx>
+#include <fs/core/languages/fstrips/operations.hxx>
 
 using namespace fs0;
 namespace fs = fs0::language::fstrips;
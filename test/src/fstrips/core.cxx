@@ -2,7 +2,7 @@
 
 #include <gtest/gtest.h>
 
-#include <fstrips/language_info.hxx>
+#include <fs/core/fstrips/language_info.hxx>
 
 using namespace fs0;
 
@@ -13,7 +13,7 @@ class FStripsCore : public testing::Test {
 //!
 TEST_F(FStripsCore, ObjectId) {
 	
-	ASSERT_THROW(value<int>(object_id::TRUE), type_mismatch_error);
+	ASSERT_THROW(value<bool>(make_object<int32_t>(1)), type_mismatch_error);
 	ASSERT_NO_THROW(value<bool>(object_id::TRUE));
 
 	
@@ -21,8 +21,8 @@ TEST_F(FStripsCore, ObjectId) {
 	ASSERT_TRUE(value<bool>(object_id::TRUE));
 	
 	
-	object_id int17a = make_obj<int32_t>(17);
-	object_id int17b = make_obj<int32_t>(17);
+	object_id int17a = make_object<int32_t>(17);
+	object_id int17b = make_object<int32_t>(17);
 	
 	// Test equality, hashing, packing, unpacking.
 	auto hasher = std::hash<object_id>();
@@ -45,7 +45,7 @@ TEST_F(FStripsCore, LanguageInfo) {
 	
 	
 	fstrips::LanguageInfo lang;
-	TypeIdx block_t = lang.add_fstype("block");
+	TypeIdx block_t = lang.add_fstype("block", type_id::object_t);
 	ASSERT_EQ(block_t, 1); // First type added
 	ASSERT_EQ(lang.get_typename(block_t), "block");
 	ASSERT_EQ(lang.get_type_id("block"), type_id::object_t);
@@ -0,0 +1,57 @@
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include <fs/core/languages/fstrips/language.hxx>
+#include <fs/core/languages/fstrips/operations/basic.hxx>
+
+#include "fixtures/problem_fixture.hxx"
+
+using namespace fs0;
+using namespace fs0::test;
+
+
+class QueryPlanTest : public ProblemFixture {
+protected:
+	//! The closed formulae of the problem that involve some quantification, and which can also be interpreted over
+	//! a partial assignment, i.e. that involve no axiom
+	static std::vector<const fs::Formula*> quantified_formulae(unsigned max_actions) {
+		std::vector<const fs::Formula*> candidates{problem()->getGoalConditions()};
+		for (const auto* constraint:problem()->getStateConstraints()) candidates.push_back(constraint);
+		const auto& actions = problem()->getGroundActions();
+		for (unsigned i = 0; i < actions.size() && i < max_actions; ++i) candidates.push_back(actions[i]->getPrecondition());
+
+		std::vector<const fs::Formula*> formulae;
+		for (const auto* formula:candidates) {
+			bool quantified = false, axiomatic = false;
+			for (const auto* node:fs::all_nodes(*formula)) {
+				if (dynamic_cast<const fs::QuantifiedFormula*>(node)) quantified = true;
+				if (dynamic_cast<const fs::AxiomaticFormula*>(node) || dynamic_cast<const fs::AxiomaticTermWrapper*>(node)) axiomatic = true;
+			}
+			if (quantified && !axiomatic) formulae.push_back(formula);
+		}
+		return formulae;
+	}
+
+	static PartialAssignment as_assignment(const State& state) {
+		PartialAssignment assignment;
+		for (VariableIdx var = 0; var < state.numAtoms(); ++var) assignment.emplace(var, state.getValue(var));
+		return assignment;
+	}
+};
+
+TEST_F(QueryPlanTest, QueryPlanMatchesRecursiveInterpretation) {
+	ground_model(); // The ground actions provide the preconditions to check
+	auto formulae = quantified_formulae(2000);
+	if (formulae.empty()) GTEST_SKIP() << "The problem has no quantified formula";
+
+	for (const State& state:sampled_states(100)) {
+		// States are interpreted through the query plans, whereas partial assignments are always interpreted
+		// by enumerating all bindings of the quantified variables
+		PartialAssignment assignment = as_assignment(state);
+		for (const auto* formula:formulae) {
+			ASSERT_EQ(formula->interpret(state), formula->interpret(assignment)) << "Formula " << *formula << " in state " << state;
+		}
+	}
+}
@@ -0,0 +1,76 @@
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include <fs/core/heuristics/relaxed_plan/unary_relaxed_heuristic.hxx>
+
+#include "fixtures/problem_fixture.hxx"
+
+using namespace fs0;
+using namespace fs0::test;
+
+
+class UnaryRelaxedHeuristicTest : public ProblemFixture {
+protected:
+	using HeuristicT = UnaryRelaxedHeuristic;
+
+	//! Evaluate the sampled states both through an incremental and a non-incremental heuristic of the given type,
+	//! first in the order in which they were generated, and then in random order
+	static void check_incremental_heuristic(HeuristicT::Type type) {
+		HeuristicT incremental(*problem(), type, true);
+		HeuristicT from_scratch(*problem(), type, false);
+
+		std::vector<const State*> states{&problem()->getInitialState()};
+		for (const auto& t:transitions()) states.push_back(&t.child);
+
+		for (unsigned i = 0; i < states.size(); ++i) {
+			ASSERT_EQ(incremental.evaluate(*states[i]), from_scratch.evaluate(*states[i])) << "State #" << i;
+		}
+
+		std::shuffle(states.begin(), states.end(), std::mt19937(2));
+		for (unsigned i = 0; i < states.size(); ++i) {
+			ASSERT_EQ(incremental.evaluate(*states[i]), from_scratch.evaluate(*states[i])) << "State #" << i;
+		}
+	}
+};
+
+TEST_F(UnaryRelaxedHeuristicTest, RepairedHMaxMatchesFromScratch) {
+	check_incremental_heuristic(HeuristicT::Type::hmax);
+}
+
+TEST_F(UnaryRelaxedHeuristicTest, RepairedHAddMatchesFromScratch) {
+	check_incremental_heuristic(HeuristicT::Type::hadd);
+}
+
+TEST_F(UnaryRelaxedHeuristicTest, RelaxedPlanBounds) {
+	HeuristicT hmax(*problem(), HeuristicT::Type::hmax, false);
+	HeuristicT hadd(*problem(), HeuristicT::Type::hadd, false);
+	HeuristicT hff(*problem(), HeuristicT::Type::hff, false);
+	HeuristicT incremental_hff(*problem(), HeuristicT::Type::hff, true);
+
+	for (const auto& t:transitions()) {
+		long vmax = hmax.evaluate(t.child), vadd = hadd.evaluate(t.child);
+		long vff = hff.evaluate(t.child), incremental_vff = incremental_hff.evaluate(t.child);
+
+		// The three heuristics agree on relaxed reachability
+		ASSERT_EQ(vmax == -1, vadd == -1);
+		ASSERT_EQ(vmax == -1, vff == -1);
+		ASSERT_EQ(vmax == -1, incremental_vff == -1);
+		if (vmax == -1) continue;
+
+		// With unit costs, h_max <= h_FF <= h_add. Ties among best supporters can yield different relaxed plans
+		// when the costs are repaired, hence the incremental h_FF is only checked against the same bounds.
+		ASSERT_LE(vmax, vff);
+		ASSERT_LE(vff, vadd);
+		ASSERT_LE(vmax, incremental_vff);
+		ASSERT_LE(incremental_vff, vadd);
+
+		if (ground_model().goal(t.child)) {
+			ASSERT_EQ(vmax, 0);
+			ASSERT_EQ(vff, 0);
+		}
+	}
+}
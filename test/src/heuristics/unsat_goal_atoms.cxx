@@ -0,0 +1,26 @@
+
+#include <gtest/gtest.h>
+
+#include <fs/core/utils/atom_index.hxx>
+#include <fs/core/heuristics/unsat_goal_atoms.hxx>
+
+#include "fixtures/problem_fixture.hxx"
+
+using namespace fs0;
+using namespace fs0::test;
+
+
+class UnsatisfiedGoalAtomsTest : public ProblemFixture {};
+
+TEST_F(UnsatisfiedGoalAtomsTest, IncrementalCountMatchesFullCount) {
+	UnsatisfiedGoalAtomsCounter counter(problem()->getGoalConditions(), problem()->get_tuple_index());
+
+	for (const auto& t:transitions()) {
+		unsigned parent_unsatisfied = counter.evaluate(t.parent);
+		unsigned unsatisfied = counter.evaluate(t.child);
+		ASSERT_EQ(counter.evaluate(t.child, t.parent, parent_unsatisfied, t.changeset), unsatisfied) << "In state " << t.child;
+
+		// Atomic goals are satisfied iff there is no unsatisfied atom
+		if (counter.is_atomic()) ASSERT_EQ(unsatisfied == 0, ground_model().goal(t.child));
+	}
+}
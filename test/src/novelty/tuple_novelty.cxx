@@ -0,0 +1,106 @@
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <limits>
+#include <random>
+#include <set>
+#include <vector>
+
+#include <fs/core/search/novelty/tuple_novelty.hxx>
+
+using namespace fs0::bfws;
+
+
+class TupleNoveltyTest : public testing::Test {
+protected:
+	using AtomT = TupleFingerprintSet::AtomT;
+
+	//! A naive computation of the novelty of the given valuation, which keeps all tuples of each width in a set
+	static unsigned naive_novelty(const std::vector<int>& valuation, std::vector<std::set<std::vector<AtomT>>>& seen) {
+		std::vector<AtomT> atoms;
+		for (unsigned i = 0; i < valuation.size(); ++i) atoms.push_back((AtomT(i) << 32) | uint32_t(valuation[i]));
+
+		unsigned novelty = std::numeric_limits<unsigned>::max();
+		for (unsigned k = seen.size(); k >= 1; --k) {
+			// Enumerate all subsets of k atoms through a selection mask
+			if (k > atoms.size()) continue;
+			std::vector<bool> mask(atoms.size(), false);
+			std::fill(mask.begin(), mask.begin() + k, true);
+			do {
+				std::vector<AtomT> tuple;
+				for (unsigned i = 0; i < atoms.size(); ++i) if (mask[i]) tuple.push_back(atoms[i]);
+				if (seen[k-1].insert(tuple).second) novelty = k;
+			} while (std::prev_permutation(mask.begin(), mask.end()));
+		}
+		return novelty;
+	}
+};
+
+TEST_F(TupleNoveltyTest, FingerprintSet) {
+	TupleFingerprintSet set(3);
+	ASSERT_EQ(set.width(), 3u);
+	ASSERT_EQ(set.size(), 0u);
+
+	std::set<std::vector<AtomT>> reference;
+	std::mt19937 rng(3);
+	std::uniform_int_distribution<AtomT> dist(0, 20);
+
+	// Enough tuples to force the table to grow several times
+	for (unsigned i = 0; i < 20000; ++i) {
+		std::vector<AtomT> tuple{dist(rng), dist(rng), dist(rng)};
+		std::sort(tuple.begin(), tuple.end());
+		ASSERT_EQ(set.insert(tuple.data()), reference.insert(tuple).second);
+	}
+	ASSERT_EQ(set.size(), reference.size());
+
+	// All tuples are still found after growing
+	for (const auto& tuple:reference) ASSERT_FALSE(set.insert(tuple.data()));
+
+	set.clear();
+	ASSERT_EQ(set.size(), 0u);
+	ASSERT_TRUE(set.insert(reference.begin()->data()));
+}
+
+TEST_F(TupleNoveltyTest, EvaluatorMatchesNaiveNovelty) {
+	const unsigned width = 3, num_features = 7, num_values = 3;
+	TupleNoveltyEvaluator evaluator(width, false);
+	std::vector<std::set<std::vector<AtomT>>> seen(width);
+
+	std::mt19937 rng(11);
+	std::uniform_int_distribution<unsigned> feature(0, num_features - 1), value(0, num_values - 1);
+
+	// Evaluate a random tree of valuations, each of which differs from its parent in a few features.
+	// The novelty computed from the parent has to match the naive novelty computed over all tuples.
+	std::vector<std::vector<int>> evaluated{std::vector<int>(num_features, 0)};
+	ASSERT_EQ(evaluator.evaluate(evaluated[0]), naive_novelty(evaluated[0], seen));
+
+	unsigned novel = 0;
+	for (unsigned i = 0; i < 2000; ++i) {
+		const std::vector<int> parent = evaluated[std::uniform_int_distribution<std::size_t>(0, evaluated.size() - 1)(rng)];
+		std::vector<int> child(parent);
+		for (unsigned changes = 1 + value(rng); changes > 0; --changes) child[feature(rng)] = value(rng);
+
+		unsigned expected = naive_novelty(child, seen);
+		ASSERT_EQ(evaluator.evaluate(child, &parent), expected) << "Valuation #" << i;
+		if (expected <= width) ++novel;
+		evaluated.push_back(child);
+	}
+	ASSERT_GT(novel, 0u);
+
+	for (unsigned k = 1; k <= width; ++k) ASSERT_EQ(evaluator.table(k).size(), seen[k-1].size());
+
+	evaluator.reset();
+	ASSERT_EQ(evaluator.evaluate(evaluated[0]), 1u);
+}
+
+TEST_F(TupleNoveltyTest, IgnoresNegativeLiterals) {
+	TupleNoveltyEvaluator evaluator(3, true);
+	ASSERT_EQ(evaluator.evaluate(std::vector<bool>{true, false, false, true}), 1u);
+
+	// Only the atoms that are true count, hence making a further atom false yields no new tuple
+	ASSERT_EQ(evaluator.evaluate(std::vector<bool>{true, false, false, false}), std::numeric_limits<unsigned>::max());
+	ASSERT_EQ(evaluator.evaluate(std::vector<bool>{false, false, true, true}), 1u);
+	ASSERT_EQ(evaluator.evaluate(std::vector<bool>{true, false, true, false}), 2u);
+	ASSERT_EQ(evaluator.evaluate(std::vector<bool>{true, false, true, true}), 3u);
+}
@@ -0,0 +1,84 @@
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <map>
+#include <vector>
+
+#include "fixtures/problem_fixture.hxx"
+
+using namespace fs0;
+using namespace fs0::test;
+
+
+class SuccessorGenerationTest : public ProblemFixture {
+protected:
+	using SuccessorMap = std::map<ActionKey, State>;
+
+	//! The successors of the given state through all the applicable ground actions
+	static SuccessorMap ground_successors(const State& state) {
+		const GroundStateModel& model = ground_model();
+		const auto& actions = problem()->getGroundActions();
+		SuccessorMap successors;
+		for (auto action:model.applicable_actions(state)) {
+			successors.emplace(key(*actions[action]), model.next(state, action));
+		}
+		return successors;
+	}
+
+	//! The successors of the given state through all the actions deemed applicable by the given lifted model
+	template <typename ModelT>
+	static SuccessorMap lifted_successors(const ModelT& model, const State& state) {
+		SuccessorMap successors;
+		for (const auto& action:model.applicable_actions(state)) {
+			bool inserted = successors.emplace(key(action), model.next(state, action)).second;
+			EXPECT_TRUE(inserted) << "Action generated twice: " << action;
+		}
+		return successors;
+	}
+
+	template <typename ModelT>
+	static void check_against_ground_model(const ModelT& model) {
+		for (const State& state:sampled_states(200)) {
+			auto expected = ground_successors(state);
+			auto successors = lifted_successors(model, state);
+			ASSERT_EQ(successors.size(), expected.size()) << "In state " << state;
+			for (const auto& successor:successors) {
+				auto it = expected.find(successor.first);
+				ASSERT_TRUE(it != expected.end()) << "In state " << state;
+				ASSERT_EQ(successor.second, it->second) << "In state " << state;
+			}
+		}
+	}
+};
+
+TEST_F(SuccessorGenerationTest, JoinModelMatchesGroundModel) {
+	check_against_ground_model(drivers::GroundingSetup::join_lifted_model(*problem()));
+}
+
+TEST_F(SuccessorGenerationTest, CSPModelMatchesGroundModel) {
+	check_against_ground_model(drivers::GroundingSetup::csp_lifted_model(*problem()));
+}
+
+TEST_F(SuccessorGenerationTest, JoinBindingsMatchCSPBindings) {
+	auto join_model = drivers::GroundingSetup::join_lifted_model(*problem());
+	auto csp_model = drivers::GroundingSetup::csp_lifted_model(*problem());
+
+	for (const State& state:sampled_states(200)) {
+		std::vector<ActionKey> join_actions, csp_actions;
+		for (const auto& action:join_model.applicable_actions(state)) join_actions.push_back(key(action));
+		for (const auto& action:csp_model.applicable_actions(state)) csp_actions.push_back(key(action));
+		std::sort(join_actions.begin(), join_actions.end());
+		std::sort(csp_actions.begin(), csp_actions.end());
+		ASSERT_EQ(join_actions, csp_actions) << "In state " << state;
+	}
+}
+
+TEST_F(SuccessorGenerationTest, JoinModelSubgoals) {
+	auto model = drivers::GroundingSetup::join_lifted_model(*problem());
+	for (const State& state:sampled_states(200)) {
+		// The subgoals are conjuncts of the goal
+		if (!model.goal(state)) continue;
+		for (unsigned i = 0; i < model.num_subgoals(); ++i) ASSERT_TRUE(model.goal(state, i)) << "In state " << state;
+	}
+}
@@ -0,0 +1,84 @@
+
+#include <gtest/gtest.h>
+
+#include <deque>
+#include <memory>
+#include <stdexcept>
+#include <unordered_set>
+#include <vector>
+
+#include <fs/core/search/algorithms/symbolic_breadth_first_search.hxx>
+
+#include "fixtures/problem_fixture.hxx"
+
+using namespace fs0;
+using namespace fs0::test;
+
+
+class SymbolicSearchTest : public ProblemFixture {
+protected:
+	struct StateHasher {
+		std::size_t operator()(const State& state) const { return state.hash(); }
+	};
+
+	//! The length of an optimal plan, computed through an explicit breadth-first search over the ground model,
+	//! or -1 if there is no plan, or -2 if the search expands more than the given number of states
+	static int optimal_plan_length(unsigned max_expansions) {
+		const GroundStateModel& model = ground_model();
+		std::unordered_set<State, StateHasher> closed;
+		std::deque<std::pair<State, int>> open;
+		open.emplace_back(model.init(), 0);
+		closed.insert(model.init());
+
+		for (unsigned expanded = 0; !open.empty(); ++expanded) {
+			if (expanded == max_expansions) return -2;
+			State state(open.front().first);
+			int depth = open.front().second;
+			open.pop_front();
+			if (model.goal(state)) return depth;
+
+			for (auto action:model.applicable_actions(state)) {
+				State child = model.next(state, action);
+				if (closed.insert(child).second) open.emplace_back(child, depth + 1);
+			}
+		}
+		return -1;
+	}
+};
+
+TEST_F(SymbolicSearchTest, FindsOptimalValidPlans) {
+	std::unique_ptr<SDDLiftedStateModel> model;
+	std::unique_ptr<SymbolicBreadthFirstSearch> search;
+	try {
+		model = std::make_unique<SDDLiftedStateModel>(drivers::GroundingSetup::sdd_lifted_model(*problem()));
+		search = std::make_unique<SymbolicBreadthFirstSearch>(*model, ProblemInfo::getInstance());
+	} catch (const std::runtime_error& error) {
+		// Either the SDDs of the problem were not compiled, or the problem is not STRIPS-like
+		GTEST_SKIP() << "Symbolic search is not applicable: " << error.what();
+	}
+
+	int optimal = optimal_plan_length(200000);
+	if (optimal == -2) GTEST_SKIP() << "The state space is too large to check the length of the plan";
+
+	SymbolicBreadthFirstSearch::PlanT plan;
+	bool solved = search->solve_model(plan);
+	ASSERT_EQ(solved, optimal >= 0);
+	if (!solved) return;
+
+	// Breadth-first search finds plans of optimal length
+	ASSERT_EQ((int) plan.size(), optimal);
+
+	// The plan is applicable in the ground model, and reaches the goal
+	const GroundStateModel& ground = ground_model();
+	const auto& actions = problem()->getGroundActions();
+	auto state = std::make_unique<State>(ground.init());
+	for (unsigned i = 0; i < plan.size(); ++i) {
+		int applied = -1;
+		for (auto action:ground.applicable_actions(*state)) {
+			if (key(*actions[action]) == key(plan[i])) applied = action;
+		}
+		ASSERT_NE(applied, -1) << "Action #" << i << " of the plan is not applicable: " << plan[i];
+		state = std::make_unique<State>(ground.next(*state, applied));
+	}
+	ASSERT_TRUE(ground.goal(*state));
+}
@@ -0,0 +1,54 @@
+
+#include <gtest/gtest.h>
+
+#include <fs/core/utils/cow_bitset.hxx>
+
+using namespace fs0;
+
+
+class CowBitsetTest : public testing::Test {};
+
+TEST_F(CowBitsetTest, TestAndSet) {
+	CowBitset<64> bitset(1000);
+	ASSERT_EQ(bitset.size(), 1000);
+	ASSERT_EQ(bitset.count(), 0);
+
+	ASSERT_TRUE(bitset.test_and_set(0));
+	ASSERT_TRUE(bitset.test_and_set(999));
+	ASSERT_FALSE(bitset.test_and_set(999));
+	ASSERT_TRUE(bitset.test(0));
+	ASSERT_TRUE(bitset.test(999));
+	ASSERT_FALSE(bitset.test(500));
+	ASSERT_EQ(bitset.count(), 2);
+
+	bitset.reset();
+	ASSERT_FALSE(bitset.test(0));
+	ASSERT_EQ(bitset.count(), 0);
+}
+
+TEST_F(CowBitsetTest, CopiesAreIndependent) {
+	CowBitset<64> original(1000);
+	original.test_and_set(10);
+	original.test_and_set(700);
+
+	CowBitset<64> copy(original);
+	ASSERT_TRUE(copy.test(10));
+	ASSERT_TRUE(copy.test(700));
+
+	// Writing to the copy, on a shared block and on a block that was never allocated, leaves the original untouched
+	ASSERT_TRUE(copy.test_and_set(11));
+	ASSERT_TRUE(copy.test_and_set(300));
+	ASSERT_FALSE(original.test(11));
+	ASSERT_FALSE(original.test(300));
+	ASSERT_EQ(original.count(), 2);
+	ASSERT_EQ(copy.count(), 4);
+
+	// And vice versa
+	ASSERT_TRUE(original.test_and_set(701));
+	ASSERT_FALSE(copy.test(701));
+
+	// Resetting one of them does not affect the other either
+	copy.reset();
+	ASSERT_EQ(copy.count(), 0);
+	ASSERT_EQ(original.count(), 3);
+}
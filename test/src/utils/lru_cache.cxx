@@ -0,0 +1,58 @@
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+#include <fs/core/utils/lru_cache.hxx>
+
+using namespace fs0;
+
+
+class LRUCacheTest : public testing::Test {};
+
+TEST_F(LRUCacheTest, FindAndInsert) {
+	LRUCache<int, std::string> cache(2);
+	ASSERT_TRUE(cache.enabled());
+	ASSERT_EQ(cache.find(1), nullptr);
+
+	cache.insert(1, "one");
+	ASSERT_NE(cache.find(1), nullptr);
+	ASSERT_EQ(*cache.find(1), "one");
+	ASSERT_EQ(cache.size(), 1);
+
+	// Inserting an existing key keeps the value already stored
+	cache.insert(1, "uno");
+	ASSERT_EQ(*cache.find(1), "one");
+	ASSERT_EQ(cache.size(), 1);
+
+	ASSERT_EQ(cache.hits(), 3);
+	ASSERT_EQ(cache.misses(), 1);
+}
+
+TEST_F(LRUCacheTest, EvictsLeastRecentlyUsed) {
+	LRUCache<int, std::string> cache(2);
+	cache.insert(1, "one");
+	cache.insert(2, "two");
+
+	// Accessing 1 makes 2 the least recently used entry
+	ASSERT_NE(cache.find(1), nullptr);
+	cache.insert(3, "three");
+	ASSERT_EQ(cache.size(), 2);
+	ASSERT_EQ(cache.find(2), nullptr);
+	ASSERT_NE(cache.find(1), nullptr);
+	ASSERT_NE(cache.find(3), nullptr);
+
+	// Now 1 is the least recently used one
+	cache.insert(4, "four");
+	ASSERT_EQ(cache.find(1), nullptr);
+	ASSERT_EQ(*cache.find(3), "three");
+	ASSERT_EQ(*cache.find(4), "four");
+}
+
+TEST_F(LRUCacheTest, ZeroCapacityDisablesTheCache) {
+	LRUCache<int, std::string> cache(0);
+	ASSERT_FALSE(cache.enabled());
+	cache.insert(1, "one");
+	ASSERT_EQ(cache.size(), 0);
+	ASSERT_EQ(cache.find(1), nullptr);
+}
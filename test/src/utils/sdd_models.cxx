@@ -0,0 +1,107 @@
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include <fs/core/utils/sdd.hxx>
+#include <sdd/sddapi.hxx>
+
+using namespace fs0;
+
+
+class SDDModelEnumerationTest : public testing::Test {
+protected:
+	using ValuesT = std::vector<SDDModel::value_t>;
+
+	const unsigned nvars = 8;
+	SddManager* manager = nullptr;
+
+	void SetUp() override { manager = sdd_manager_create(nvars, 0); }
+	void TearDown() override { sdd_manager_free(manager); }
+
+	//! A random formula in DNF over the variables of the manager
+	SddNode* random_formula(std::mt19937& rng, unsigned num_terms, unsigned term_size) {
+		std::uniform_int_distribution<long> var(1, nvars);
+		std::bernoulli_distribution negated(0.5);
+		SddNode* formula = sdd_manager_false(manager);
+		for (unsigned t = 0; t < num_terms; ++t) {
+			SddNode* term = sdd_manager_true(manager);
+			for (unsigned i = 0; i < term_size; ++i) {
+				long lit = var(rng);
+				term = sdd_conjoin(term, sdd_manager_literal(negated(rng) ? -lit : lit, manager), manager);
+			}
+			formula = sdd_disjoin(formula, term, manager);
+		}
+		return formula;
+	}
+
+	static ValuesT values(const SDDModel& model) {
+		ValuesT result;
+		for (std::size_t i = 0; i < model.size(); ++i) result.push_back(model[i]);
+		return result;
+	}
+
+	std::vector<ValuesT> recursive_models(SddNode* node, const SDDModel& fixed) {
+		std::vector<ValuesT> result;
+		if (sdd_node_is_false(node)) return result;
+		RecursiveModelEnumerator enumerator(manager, SDDModel(fixed));
+		for (const auto& model:enumerator.models(node)) result.push_back(values(model));
+		std::sort(result.begin(), result.end());
+		return result;
+	}
+
+	std::vector<ValuesT> dfs_models(DFSModelEnumerator& enumerator, SddNode* node, const SDDModel& fixed) {
+		std::vector<ValuesT> result;
+		enumerator.reset(manager, node, SDDModel(fixed));
+		while (enumerator.next()) result.push_back(values(enumerator.model()));
+		std::sort(result.begin(), result.end());
+		return result;
+	}
+};
+
+TEST_F(SDDModelEnumerationTest, DFSMatchesRecursiveEnumeration) {
+	std::mt19937 rng(5);
+	DFSModelEnumerator enumerator; // Reused for all enumerations
+
+	for (unsigned i = 0; i < 200; ++i) {
+		SddNode* formula = random_formula(rng, 1 + i % 5, 1 + i % 4);
+
+		// Enumerate the models with no fixed value, and with some random values fixed
+		SDDModel fixed(nvars + 1); // Variables are 1-indexed
+		for (unsigned round = 0; round < 3; ++round) {
+			auto expected = recursive_models(formula, fixed);
+			auto models = dfs_models(enumerator, formula, fixed);
+			ASSERT_EQ(models, expected) << "Formula #" << i << ", round " << round;
+
+			// No model is enumerated twice
+			ASSERT_TRUE(std::adjacent_find(models.begin(), models.end()) == models.end());
+
+			unsigned var = std::uniform_int_distribution<unsigned>(1, nvars)(rng);
+			fixed[var] = std::bernoulli_distribution(0.5)(rng) ? SDDModel::value_t::True : SDDModel::value_t::False;
+		}
+	}
+}
+
+TEST_F(SDDModelEnumerationTest, TrivialNodes) {
+	DFSModelEnumerator enumerator;
+	SDDModel fixed(nvars + 1);
+
+	enumerator.reset(manager, sdd_manager_false(manager), SDDModel(fixed));
+	ASSERT_FALSE(enumerator.next());
+
+	auto models = dfs_models(enumerator, sdd_manager_true(manager), fixed);
+	ASSERT_EQ(models, recursive_models(sdd_manager_true(manager), fixed));
+	ASSERT_FALSE(models.empty());
+
+	// A single literal has a single model where only that literal is defined
+	SddNode* literal = sdd_manager_literal(-3, manager);
+	models = dfs_models(enumerator, literal, fixed);
+	ASSERT_EQ(models.size(), 1u);
+	ASSERT_EQ(models[0][3], SDDModel::value_t::False);
+
+	// ... and none if it contradicts the fixed values
+	fixed[3] = SDDModel::value_t::True;
+	ASSERT_TRUE(dfs_models(enumerator, literal, fixed).empty());
+}
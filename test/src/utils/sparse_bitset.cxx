@@ -0,0 +1,55 @@
+
+#include <gtest/gtest.h>
+
+#include <random>
+#include <set>
+
+#include <fs/core/utils/sparse_bitset.hxx>
+
+using namespace fs0;
+
+
+class SparseBitsetTest : public testing::Test {};
+
+TEST_F(SparseBitsetTest, TestAndSet) {
+	SparseBitset<64> bitset;
+	ASSERT_FALSE(bitset.test(0));
+	ASSERT_EQ(bitset.num_blocks(), 0);
+
+	ASSERT_TRUE(bitset.test_and_set(5));
+	ASSERT_FALSE(bitset.test_and_set(5));
+	ASSERT_TRUE(bitset.test(5));
+	ASSERT_FALSE(bitset.test(4));
+	ASSERT_FALSE(bitset.test(6));
+	ASSERT_EQ(bitset.num_blocks(), 1);
+
+	// A bit far away in the index space takes a single new block
+	std::size_t far = std::size_t(1) << 40;
+	ASSERT_TRUE(bitset.test_and_set(far));
+	ASSERT_TRUE(bitset.test(far));
+	ASSERT_FALSE(bitset.test(far - 1));
+	ASSERT_EQ(bitset.num_blocks(), 2);
+
+	// Testing bits does not allocate blocks
+	ASSERT_FALSE(bitset.test(1000000));
+	ASSERT_EQ(bitset.num_blocks(), 2);
+
+	bitset.clear();
+	ASSERT_FALSE(bitset.test(5));
+	ASSERT_EQ(bitset.num_blocks(), 0);
+}
+
+TEST_F(SparseBitsetTest, MatchesSet) {
+	SparseBitset<> bitset;
+	std::set<std::size_t> reference;
+	std::mt19937 rng(17);
+	std::uniform_int_distribution<std::size_t> dist(0, 100000);
+
+	for (unsigned i = 0; i < 20000; ++i) {
+		std::size_t bit = dist(rng);
+		ASSERT_EQ(bitset.test_and_set(bit), reference.insert(bit).second);
+	}
+	for (std::size_t bit = 0; bit <= 100000; ++bit) {
+		ASSERT_EQ(bitset.test(bit), reference.count(bit) > 0);
+	}
+}
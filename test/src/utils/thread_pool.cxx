@@ -0,0 +1,49 @@
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+#include <fs/core/utils/thread_pool.hxx>
+
+using namespace fs0;
+
+
+class ThreadPoolTest : public testing::Test {};
+
+TEST_F(ThreadPoolTest, RunsEveryTaskOnce) {
+	for (unsigned num_threads:{1u, 2u, 4u}) {
+		ThreadPool pool(num_threads);
+		ASSERT_EQ(pool.size(), num_threads);
+
+		// Several batches on the same pool, of different sizes
+		for (unsigned n:{0u, 1u, 3u, 1000u}) {
+			std::vector<std::atomic<unsigned>> runs(n);
+			for (auto& r:runs) r = 0;
+			pool.parallel_for(n, [&runs](unsigned i) { ++runs[i]; });
+			for (unsigned i = 0; i < n; ++i) ASSERT_EQ(runs[i], 1u) << "Task " << i << " with " << num_threads << " threads";
+		}
+	}
+}
+
+TEST_F(ThreadPoolTest, DefaultSizeUsesAllCores) {
+	ThreadPool pool(0);
+	ASSERT_GE(pool.size(), 1u);
+}
+
+TEST_F(ThreadPoolTest, RethrowsTaskErrors) {
+	ThreadPool pool(4);
+	std::atomic<unsigned> completed(0);
+	auto task = [&completed](unsigned i) {
+		if (i == 17) throw std::runtime_error("task failed");
+		++completed;
+	};
+	ASSERT_THROW(pool.parallel_for(100, task), std::runtime_error);
+
+	// The rest of the batch still runs, and the pool remains usable
+	ASSERT_EQ(completed, 99u);
+	completed = 0;
+	pool.parallel_for(100, [&completed](unsigned) { ++completed; });
+	ASSERT_EQ(completed, 100u);
+}